@@ -1,7 +1,7 @@
 /* Copyright 2021 Philipp Schuster
  *
- * Permission is hereby granted, free of charge, to any person obtaining a copy of 
- * this software and associated documentation files (the "Software"), to deal in the 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
  * Software without restriction, including without limitation the rights to use, copy,
  * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
  * and to permit persons to whom the Software is furnished to do so, subject to the
@@ -11,7 +11,7 @@
  * or substantial portions of the Software.
  *
  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
- * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
  * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
  * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
  * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
@@ -23,6 +23,8 @@
 /*
  * This file describes the common properties of our custom Netlink family on top of Generic Netlink.
  * It is used by all C projects, i.e. the Kernel driver, and the userland components.
+ *
+ * This file is generated from "spec/gnl_foobar_xmpl.yaml" by "tools/gnl-gen.py". Do not edit it.
  */
 
 /**
@@ -48,11 +50,131 @@ enum GNL_FOOBAR_XMPL_ATTRIBUTE {
     GNL_FOOBAR_XMPL_A_UNSPEC,
     /** We expect a MSG to be a null-terminated C-string. */
     GNL_FOOBAR_XMPL_A_MSG,
+    /**
+     * Arbitrary binary payload (no null-termination required) that is echoed back by
+     * `GNL_FOOBAR_XMPL_C_ECHO_MSG`. Unlike `GNL_FOOBAR_XMPL_A_MSG` this is meant for large payloads:
+     * the kernel avoids copying it a second time into the reply if possible.
+     */
+    GNL_FOOBAR_XMPL_A_DATA,
+    /** Padding for 64 bit attributes (`nla_put_u64_64bit()`). Ignore it. */
+    GNL_FOOBAR_XMPL_A_PAD,
+    /**
+     * Send timestamp of a `GNL_FOOBAR_XMPL_C_PING` request in nanoseconds, taken by the client right
+     * before sending from `CLOCK_MONOTONIC`. Echoed back unchanged.
+     */
+    GNL_FOOBAR_XMPL_A_CLIENT_TS,
+    /**
+     * `ktime_get_ns()` at the entry of the `GNL_FOOBAR_XMPL_C_PING` handler. Same clock as
+     * `CLOCK_MONOTONIC` in the userland, hence it can be compared with `GNL_FOOBAR_XMPL_A_CLIENT_TS`.
+     */
+    GNL_FOOBAR_XMPL_A_KERNEL_RX_TS,
+    /** `ktime_get_ns()` in the `GNL_FOOBAR_XMPL_C_PING` handler right before the reply is sent. */
+    GNL_FOOBAR_XMPL_A_KERNEL_TX_TS,
+    /** Id of a chunked transfer (object), assigned by `GNL_FOOBAR_XMPL_C_XFER_BEGIN`. */
+    GNL_FOOBAR_XMPL_A_XFER_ID,
+    /** Total size of the object of a chunked transfer in bytes. */
+    GNL_FOOBAR_XMPL_A_XFER_SIZE,
+    /**
+     * Offset of the chunk (`GNL_FOOBAR_XMPL_A_DATA`) within the object of a chunked transfer. In a
+     * `GNL_FOOBAR_XMPL_C_XFER_GET` request: where the download starts.
+     */
+    GNL_FOOBAR_XMPL_A_XFER_OFFSET,
+    /**
+     * Number of unacknowledged chunks that a client should have in flight at most during an upload,
+     * i.e. chunks sent with `NLM_F_ACK` whose ACK hasn't been received yet.
+     */
+    GNL_FOOBAR_XMPL_A_XFER_WINDOW,
+    /**
+     * Id of a shared memory ring, assigned by `GNL_FOOBAR_XMPL_C_RING_CREATE`. The ring is mapped with mmap()
+     * on the misc device "/dev/gnl_foobar_xmpl_ring" at the offset `ring-id * page size`.
+     */
+    GNL_FOOBAR_XMPL_A_RING_ID,
+    /** Number of slots of the submission and of the completion queue of a ring (power of two). */
+    GNL_FOOBAR_XMPL_A_RING_ENTRIES,
+    /** Size of each slot of a ring in bytes, incl. `struct gnl_foobar_xmpl_ring_rec` (multiple of 64). */
+    GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE,
+    /** Length of the mapping of a ring in bytes. */
+    GNL_FOOBAR_XMPL_A_RING_MMAP_LEN,
+    /** Number of completions that the kernel posted while it handled a doorbell. */
+    GNL_FOOBAR_XMPL_A_RING_COMPLETED,
+    /** Number of records that the kernel processed on a ring since it was created. */
+    GNL_FOOBAR_XMPL_A_RING_RECORDS,
+    /** Number of payload bytes that the kernel processed on a ring since it was created. */
+    GNL_FOOBAR_XMPL_A_RING_BYTES,
+    /** Number of doorbells of a ring since it was created. */
+    GNL_FOOBAR_XMPL_A_RING_DOORBELLS,
+    /** Type of an event (0..63); subscribers select types with `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK`. */
+    GNL_FOOBAR_XMPL_A_EVENT_TYPE,
+    /** Key of an event, e.g. the name of the object it is about. */
+    GNL_FOOBAR_XMPL_A_EVENT_KEY,
+    /** Filter of a subscriber: bit `1 << type` selects events of that type. Missing or 0 selects all types. */
+    GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK,
+    /** Filter of a subscriber; selects events whose key starts with this prefix. Missing or empty selects all keys. */
+    GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX,
+    /** Number of subscribers (plus 1 for the multicast group if it has members) an event was sent to. */
+    GNL_FOOBAR_XMPL_A_EVENT_DELIVERED,
+    /** Number of subscribers whose filter didn't select an event, i.e. that were spared a copy and a wakeup. */
+    GNL_FOOBAR_XMPL_A_EVENT_FILTERED,
+    /**
+     * CRC32C (Castagnoli; as in iSCSI, ext4 and SCTP) of each `GNL_FOOBAR_XMPL_A_DATA` of a
+     * `GNL_FOOBAR_XMPL_C_CHECKSUM` request, in request order, as array of native endian `__u32`.
+     */
+    GNL_FOOBAR_XMPL_A_CHECKSUMS,
+    /**
+     * Tunable; number of records of an echo dump (`GNL_FOOBAR_XMPL_C_ECHO_MSG` with `NLM_F_DUMP`). Millions of
+     * records make dumps long enough for throughput measurements; "dump-max-records" keeps them from starving
+     * other clients.
+     */
+    GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS,
+    /** Tunable; if 1, the echo and dump handlers log every request to the kernel log. */
+    GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE,
+    /** Tunable; if 1, large `GNL_FOOBAR_XMPL_A_DATA` payloads are echoed without copying them into the reply. */
+    GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO,
+    /** Tunable; echo payloads smaller than this are always copied into the reply. */
+    GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN,
+    /** Tunable; the window that `GNL_FOOBAR_XMPL_C_XFER_BEGIN` advertises, see `GNL_FOOBAR_XMPL_A_XFER_WINDOW`. */
+    GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW,
+    /**
+     * Tunable; max. number of payloads of one `GNL_FOOBAR_XMPL_C_CHECKSUM` request (0: unlimited).
+     * Bounds the time a single request spends in the kernel.
+     */
+    GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH,
+    /**
+     * Generation of the state of the network namespace, part of every reply. It changes whenever the result
+     * of a read-only command (e.g. `GNL_FOOBAR_XMPL_C_GET_CONFIG`, `GNL_FOOBAR_XMPL_C_RING_STATS`,
+     * `GNL_FOOBAR_XMPL_C_XFER_GET` or the echo dump) may change, hence a client can reuse a reply for as
+     * long as the generation stays the same. Only equality is meaningful; it starts at a random value.
+     */
+    GNL_FOOBAR_XMPL_A_GENERATION,
+    /**
+     * Tunable; max. number of dumps of one user (the sender of the requests) that run at the same time in all
+     * network namespaces together (0: unlimited). Further dumps of the user fail with EBUSY right away, before they
+     * do any work; other users aren't affected.
+     */
+    GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT,
+    /**
+     * Tunable; max. number of records per run of a dump, i.e. per receive of the client (0: as many as fit
+     * into the dump buffer). The rest of the dump is deferred to the next run; in between the kernel serves
+     * the requests of other clients.
+     */
+    GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS,
+    /** Port id of a socket, see `GNL_FOOBAR_XMPL_C_PORT_STATS`. */
+    GNL_FOOBAR_XMPL_A_PORT_ID,
+    /** Number of dumps a socket started. */
+    GNL_FOOBAR_XMPL_A_PORT_DUMPS,
+    /** Number of dumps of a socket that were rejected because of `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT`. */
+    GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED,
+    /** Number of runs of the dumps of a socket, i.e. of dump buffers that the kernel filled for it. */
+    GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS,
+    /** Number of runs of the dumps of a socket that ended early because of `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS`. */
+    GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED,
+    /** Number of records of the dumps of a socket. */
+    GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS,
     /** Unused marker field to get the length/count of enum entries. No real attribute. */
     __GNL_FOOBAR_XMPL_A_MAX,
 };
 /**
- * Number of elements in `enum GNL_FOOBAR_XMPL_COMMAND`.
+ * Number of elements in `enum GNL_FOOBAR_XMPL_ATTRIBUTE`.
  */
 #define GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN (__GNL_FOOBAR_XMPL_A_MAX)
 /**
@@ -60,6 +182,11 @@ enum GNL_FOOBAR_XMPL_ATTRIBUTE {
  * This is `GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN` - 1 because "UNSPEC" is never used.
  */
 #define GNL_FOOBAR_XMPL_ATTRIBUTE_COUNT (GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN - 1)
+/**
+ * Highest attribute number in `enum GNL_FOOBAR_XMPL_ATTRIBUTE`. An attribute policy
+ * needs `GNL_FOOBAR_XMPL_A_MAX + 1` entries.
+ */
+#define GNL_FOOBAR_XMPL_A_MAX (__GNL_FOOBAR_XMPL_A_MAX - 1)
 
 /**
  * Enumeration of all commands (functions) that our custom protocol on top
@@ -82,6 +209,9 @@ enum GNL_FOOBAR_XMPL_COMMAND {
      * This command/signaling mechanism is independent of the Netlink flag `NLM_F_ECHO (0x08)`. We use it as
      * "echo specific data" instead of return a 1:1 copy of the package, which you could do with
      * `NLM_F_ECHO (0x08)` for example.
+     *
+     * Instead of `GNL_FOOBAR_XMPL_A_MSG` the request may carry `GNL_FOOBAR_XMPL_A_DATA`. In this case
+     * the reply contains the same binary payload as `GNL_FOOBAR_XMPL_A_DATA` attribute.
      */
     GNL_FOOBAR_XMPL_C_ECHO_MSG,
 
@@ -91,7 +221,139 @@ enum GNL_FOOBAR_XMPL_COMMAND {
      */
     GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR,
 
-    /** Unused marker field to get the length/count of enum entries. No real attribute. */
+    /**
+     * Latency probe. The request carries `GNL_FOOBAR_XMPL_A_CLIENT_TS`. The reply carries it unchanged plus the
+     * kernel timestamps `GNL_FOOBAR_XMPL_A_KERNEL_RX_TS` and `GNL_FOOBAR_XMPL_A_KERNEL_TX_TS`. Together with the
+     * receive timestamp of the client this splits the round trip into request leg (client -> handler), service
+     * time (inside the handler) and reply leg (handler -> client).
+     */
+    GNL_FOOBAR_XMPL_C_PING,
+
+    /**
+     * Starts the upload of an object of `GNL_FOOBAR_XMPL_A_XFER_SIZE` bytes, which can be much larger than a
+     * Netlink message. The kernel reserves a buffer for the whole object (bounded by the module parameter
+     * `xfer_max_bytes` for all network namespaces together) and replies with the id of the transfer and the
+     * window for the chunks. Afterwards the client sends the object with `GNL_FOOBAR_XMPL_C_XFER_CHUNK` and
+     * finishes it with `GNL_FOOBAR_XMPL_C_XFER_COMMIT`. Requires CAP_NET_ADMIN in the user namespace of the
+     * network namespace. The object belongs to the sending socket: only it can send chunks, commit or abort
+     * the object, and the object is deleted when the socket is closed.
+     */
+    GNL_FOOBAR_XMPL_C_XFER_BEGIN,
+
+    /**
+     * One chunk (`GNL_FOOBAR_XMPL_A_DATA`) of an upload at `GNL_FOOBAR_XMPL_A_XFER_OFFSET`. Chunks must be sent
+     * in order, i.e. the offset must be the number of bytes received so far; after an error the client can
+     * resume from there. No reply; send it with `NLM_F_ACK` to get an ACK per chunk.
+     */
+    GNL_FOOBAR_XMPL_C_XFER_CHUNK,
+
+    /**
+     * Finishes the upload `GNL_FOOBAR_XMPL_A_XFER_ID`. Fails if not all bytes were received. Afterwards the object
+     * is read-only and can be downloaded with `GNL_FOOBAR_XMPL_C_XFER_GET`.
+     */
+    GNL_FOOBAR_XMPL_C_XFER_COMMIT,
+
+    /**
+     * Downloads the committed object `GNL_FOOBAR_XMPL_A_XFER_ID` as a dump (`NLM_F_DUMP`), starting at the optional
+     * `GNL_FOOBAR_XMPL_A_XFER_OFFSET`. Each record carries a chunk as `GNL_FOOBAR_XMPL_A_DATA` with its offset;
+     * the kernel makes the chunks as large as the dump buffers allow.
+     */
+    GNL_FOOBAR_XMPL_C_XFER_GET,
+
+    /**
+     * Deletes the object `GNL_FOOBAR_XMPL_A_XFER_ID`, committed or not, and releases its buffer. Running downloads
+     * of it complete. Only the socket that started the upload can delete the object.
+     */
+    GNL_FOOBAR_XMPL_C_XFER_ABORT,
+
+    /**
+     * Creates a shared memory ring with a submission and a completion queue of `GNL_FOOBAR_XMPL_A_RING_ENTRIES`
+     * slots of `GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE` bytes each (see "gnl_foobar_xmpl_ring.h" for the layout). The
+     * reply carries the id and the length of the mapping. Each submitted record is echoed into the completion
+     * queue, i.e. the ring is a data plane for `GNL_FOOBAR_XMPL_C_ECHO_MSG` without a copy into and out of skbs.
+     * The ring belongs to the sending socket: only it may use the other ring commands on it, only its user may map
+     * it, and it is destroyed when the socket is closed.
+     */
+    GNL_FOOBAR_XMPL_C_RING_CREATE,
+
+    /**
+     * Tells the kernel that new records are in the submission queue of ring `GNL_FOOBAR_XMPL_A_RING_ID`. The kernel
+     * processes all of them (as long as the completion queue has room) before it replies with the number of
+     * posted completions.
+     */
+    GNL_FOOBAR_XMPL_C_RING_DOORBELL,
+
+    /** Statistics of ring `GNL_FOOBAR_XMPL_A_RING_ID`. */
+    GNL_FOOBAR_XMPL_C_RING_STATS,
+
+    /** Deletes ring `GNL_FOOBAR_XMPL_A_RING_ID`. Its memory is released when the last mapping of it is gone. */
+    GNL_FOOBAR_XMPL_C_RING_DESTROY,
+
+    /**
+     * Subscribes the sending socket to events that match the filter `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK` and
+     * `GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX` (both must match). The kernel sends matching events as unicast
+     * `GNL_FOOBAR_XMPL_C_EVENT` notifications to the socket; all others never reach it. Subscribing again
+     * replaces the filter. The subscription ends with `GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE` or when the socket
+     * is closed.
+     */
+    GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE,
+
+    /** Ends the subscription of the sending socket. */
+    GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE,
+
+    /**
+     * Publishes an event of `GNL_FOOBAR_XMPL_A_EVENT_TYPE` with `GNL_FOOBAR_XMPL_A_EVENT_KEY` and an optional payload
+     * `GNL_FOOBAR_XMPL_A_DATA`: to all members of the multicast group "events" and to all subscribers whose
+     * filter matches. The reply tells how many received it and how many were filtered out.
+     */
+    GNL_FOOBAR_XMPL_C_EVENT_EMIT,
+
+    /**
+     * Notification of an event published with `GNL_FOOBAR_XMPL_C_EVENT_EMIT`. Sent by the kernel only: to the
+     * multicast group "events" and to matching subscribers (see `GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE`).
+     */
+    GNL_FOOBAR_XMPL_C_EVENT,
+
+    /**
+     * Computes the CRC32C of each `GNL_FOOBAR_XMPL_A_DATA` attribute of the request (one or many, i.e. a batch)
+     * with the fastest implementation of the kernel (e.g. the CRC32 instruction of SSE 4.2) and replies with
+     * all of them in `GNL_FOOBAR_XMPL_A_CHECKSUMS`. Transfer and verification of data in one round trip. At most
+     * 16382 payloads per request, i.e. as many checksums as one attribute can hold.
+     */
+    GNL_FOOBAR_XMPL_C_CHECKSUM,
+
+    /** Replies with the current values of all runtime tunables (`GNL_FOOBAR_XMPL_A_CONFIG_*`). */
+    GNL_FOOBAR_XMPL_C_GET_CONFIG,
+
+    /**
+     * Changes the runtime tunables that are present in the request; the others keep their values. All changes
+     * take effect at once for the next request of every client (already running dumps and transfers keep
+     * the values they started with). Replies with the new values of all tunables. Requires CAP_NET_ADMIN.
+     */
+    GNL_FOOBAR_XMPL_C_SET_CONFIG,
+
+    /**
+     * Replies with nothing but `GNL_FOOBAR_XMPL_A_GENERATION`. The cheapest round trip to validate cached
+     * replies of read-only commands.
+     */
+    GNL_FOOBAR_XMPL_C_GET_GENERATION,
+
+    /**
+     * Notification to the group "invalidate" whenever `GNL_FOOBAR_XMPL_A_GENERATION` changes; carries the new
+     * generation. Clients that listen don't need to query the generation before they use a cached reply.
+     */
+    GNL_FOOBAR_XMPL_C_INVALIDATE,
+
+    /**
+     * Dumps the accounting of every socket (port id) of the network namespace that started a dump: started and
+     * rejected dumps, their runs and records and how many runs were cut short by the records quota. The numbers
+     * show which client takes how much kernel time and whether the quotas (`GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_*`)
+     * throttle it. The accounting of a socket ends when it is closed. This dump itself is not accounted and
+     * never rejected. Counters aren't state, hence `GNL_FOOBAR_XMPL_A_GENERATION` doesn't change with them.
+     */
+    GNL_FOOBAR_XMPL_C_PORT_STATS,
+
+    /** Unused marker field to get the length/count of enum entries. No real command. */
     __GNL_FOOBAR_XMPL_C_MAX,
 };
 /**
@@ -99,7 +361,26 @@ enum GNL_FOOBAR_XMPL_COMMAND {
  */
 #define GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN (__GNL_FOOBAR_XMPL_C_MAX)
 /**
- * The number of actual usable commands  in `enum GNL_FOOBAR_XMPL_COMMAND`.
+ * The number of actual usable commands in `enum GNL_FOOBAR_XMPL_COMMAND`.
  * This is `GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN` - 1 because "UNSPEC" is never used.
  */
-#define GNL_FOOBAR_XMPL_COMMAND_COUNT (GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN - 1)
\ No newline at end of file
+#define GNL_FOOBAR_XMPL_COMMAND_COUNT (GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN - 1)
+
+/**
+ * Multicast groups of the family. The values are the indices into the groups of the family in the
+ * kernel, not the group ids; the userland resolves the ids by name via the Generic Netlink control
+ * interface (`CTRL_ATTR_MCAST_GROUPS`).
+ */
+enum GNL_FOOBAR_XMPL_MCGRP {
+    /**
+     * Every `GNL_FOOBAR_XMPL_C_EVENT` notification, unfiltered. Listeners that only want some events should
+     * subscribe with a filter instead (`GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE`).
+     */
+    GNL_FOOBAR_XMPL_MCGRP_EVENTS,
+    /** `GNL_FOOBAR_XMPL_C_INVALIDATE` notifications, i.e. every change of the generation of the network namespace. */
+    GNL_FOOBAR_XMPL_MCGRP_INVALIDATE,
+};
+/** Name of the multicast group `GNL_FOOBAR_XMPL_MCGRP_EVENTS`. */
+#define GNL_FOOBAR_XMPL_MCGRP_EVENTS_NAME "events"
+/** Name of the multicast group `GNL_FOOBAR_XMPL_MCGRP_INVALIDATE`. */
+#define GNL_FOOBAR_XMPL_MCGRP_INVALIDATE_NAME "invalidate"
@@ -0,0 +1,80 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Memory layout of the shared memory rings (`GNL_FOOBAR_XMPL_C_RING_CREATE`). Used by the kernel
+ * module and the userland.
+ *
+ * A ring is mapped with mmap() on the misc device `GNL_FOOBAR_XMPL_RING_DEV` at the offset
+ * `ring id * page size`. The mapping starts with `struct gnl_foobar_xmpl_ring_hdr`, followed by the
+ * submission queue (SQ) and the completion queue (CQ) at `sq_off` and `cq_off`. Each queue has
+ * `entries` slots of `slot_size` bytes; each slot holds one `struct gnl_foobar_xmpl_ring_rec`.
+ *
+ * The indices run freely (they wrap at 2^32); slot = index & (entries - 1). Each index has exactly one
+ * writer:
+ *   - userland: fills SQ slots, then publishes them with `sq_tail` (store-release); consumes CQ slots,
+ *     then frees them with `cq_head` (store-release)
+ *   - kernel: on a doorbell (`GNL_FOOBAR_XMPL_C_RING_DOORBELL`) consumes SQ slots up to `sq_tail` as
+ *     long as the CQ has room, publishes the completions with `cq_tail` and frees the SQ slots with
+ *     `sq_head`
+ * The kernel never trusts the values of the userland beyond bounds: it keeps its own copy of the
+ * indices it writes and clamps the record lengths.
+ */
+
+#include <linux/types.h>
+
+/** Name of the misc device (in /dev) that maps the rings. */
+#define GNL_FOOBAR_XMPL_RING_DEV "gnl_foobar_xmpl_ring"
+
+/** Max. number of slots per queue. */
+#define GNL_FOOBAR_XMPL_RING_MAX_ENTRIES 4096
+/** Min. and max. size of a slot. Slots are multiples of a cache line. */
+#define GNL_FOOBAR_XMPL_RING_MIN_SLOT_SIZE 64
+#define GNL_FOOBAR_XMPL_RING_MAX_SLOT_SIZE (64 * 1024)
+
+struct gnl_foobar_xmpl_ring_hdr {
+    // written by the userland
+    __u32 sq_tail;
+    __u32 cq_head;
+    // the indices of both sides on separate cache lines
+    __u8 pad0[56];
+    // written by the kernel
+    __u32 sq_head;
+    __u32 cq_tail;
+    __u8 pad1[56];
+    // constant after creation
+    __u32 entries;
+    __u32 slot_size;
+    __u32 sq_off;
+    __u32 cq_off;
+};
+
+/** A record in a slot. */
+struct gnl_foobar_xmpl_ring_rec {
+    /** Opaque for the kernel; copied into the completion. */
+    __u64 user_data;
+    /** Length of `data`; at most `slot_size - sizeof(struct gnl_foobar_xmpl_ring_rec)`. */
+    __u32 len;
+    /** In completions: 0 or a negative errno. Ignored in submissions. */
+    __s32 result;
+    __u8 data[];
+};
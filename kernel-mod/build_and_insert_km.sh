@@ -6,5 +6,7 @@ sudo dmesg -c > /dev/null
 
 make clean
 make
+# insmod doesn't load dependencies; crc32c() is in libcrc32c
+sudo modprobe libcrc32c
 sudo insmod gnl_foobar_xmpl.ko
 echo "inserted gnl_foobar_xmpl.ko"
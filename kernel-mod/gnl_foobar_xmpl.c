@@ -36,12 +36,49 @@
 // definitions for generic netlink families, policies etc;
 // transitive dependencies for basic netlink, sockets etc
 #include <net/genetlink.h>
-// required for locking inside the .dumpit callback demonstration
+// mutexes that protect the per network namespace state
 #include <linux/mutex.h>
+// required for the zero-copy echo: vmalloc_to_page(), get_page(), is_vmalloc_addr()
+#include <linux/mm.h>
+// module_param() for runtime switches in /sys/module/gnl_foobar_xmpl/parameters/
+#include <linux/moduleparam.h>
+// per network namespace state: struct pernet_operations, net_generic()
+#include <net/net_namespace.h>
+#include <net/netns/generic.h>
+// ktime_get_ns() for the latency probe (GNL_FOOBAR_XMPL_C_PING)
+#include <linux/timekeeping.h>
+// per CPU cache of preallocated reply skbs: DEFINE_PER_CPU(), the refill work and its statistics
+#include <linux/percpu.h>
+#include <linux/workqueue.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+// chunked transfers: id allocation, reference counted objects, buffers that may be larger than kmalloc() allows
+#include <linux/idr.h>
+#include <linux/kref.h>
+#include <linux/slab.h>
+// shared memory rings: the misc device that maps them, vmalloc_user() and remap_vmalloc_range()
+#include <linux/miscdevice.h>
+#include <linux/fs.h>
+#include <linux/nsproxy.h>
+#include <linux/cred.h>
+#include <linux/vmalloc.h>
+#include <linux/log2.h>
+// event subscriptions: end them when their socket is closed (NETLINK_URELEASE)
+#include <linux/notifier.h>
+#include <linux/netlink.h>
+#include <linux/list.h>
+// GNL_FOOBAR_XMPL_C_CHECKSUM; "libcrc32c" must be loaded before this module (see "build_and_insert_km.sh")
+#include <linux/crc32c.h>
+// runtime tunables (GNL_FOOBAR_XMPL_C_SET_CONFIG)
+#include <linux/rcupdate.h>
+// initial value of the generation (GNL_FOOBAR_XMPL_A_GENERATION)
+#include <linux/random.h>
 
 // data/vars/enums/properties that describes our protocol that we implement
 // on top of generic netlink (like functions we want to trigger on the receiving side)
 #include "gnl_foobar_xmpl_prop.h"
+// memory layout of the shared memory rings
+#include "gnl_foobar_xmpl_ring.h"
 
 // Module/Driver description.
 // You can see this for example when executing `$ modinfo ./gnl_foobar_xmpl.ko` (after build).
@@ -67,164 +104,479 @@ MODULE_DESCRIPTION(
 /* ########################################################################### */
 
 /**
- * Data structure required for our .dumpit callback handler to
- * know about the progress of an ongoing dump.
- * See the dumpit callback handler how it is used.
+ * If true, large `GNL_FOOBAR_XMPL_A_DATA` payloads are echoed back without copying them into the
+ * reply. Only the initial value; toggled at runtime with `GNL_FOOBAR_XMPL_C_SET_CONFIG`, e.g. to
+ * compare both code paths with the same module build: `$ ./user-c/gnl-tune zerocopy-echo=0`
  */
-struct {
-    // from <linux/mutex.h>
+static bool zerocopy_echo = true;
+module_param(zerocopy_echo, bool, 0444);
+MODULE_PARM_DESC(zerocopy_echo, "Initially echo large binary payloads without copying them into the reply (default: true)");
+
+/**
+ * Upper bound for the buffers of all chunked transfers (`GNL_FOOBAR_XMPL_C_XFER_BEGIN`), committed or not.
+ * Protects the kernel from clients that never finish or delete their uploads. It is global: with user
+ * namespaces, anybody can create network namespaces (and is admin in them), hence a limit per network
+ * namespace wouldn't bound anything.
+ */
+static unsigned long xfer_max_bytes = 256UL << 20;
+module_param(xfer_max_bytes, ulong, 0644);
+MODULE_PARM_DESC(xfer_max_bytes, "Max. bytes of all chunked transfers of all network namespaces (default: 256 MiB)");
+
+/** Sum of the sizes of all transfers of all network namespaces; bounded by `xfer_max_bytes`. */
+static atomic64_t gnl_foobar_xmpl_xfer_bytes = ATOMIC64_INIT(0);
+
+/**
+ * Initial window for uploads that is advertised to clients, see `GNL_FOOBAR_XMPL_A_XFER_WINDOW`.
+ * Changed at runtime with `GNL_FOOBAR_XMPL_C_SET_CONFIG`.
+ */
+static unsigned int xfer_window = 8;
+module_param(xfer_window, uint, 0444);
+MODULE_PARM_DESC(xfer_window, "Initial max. unacknowledged chunks in flight per upload (default: 8)");
+
+/**
+ * Upper bound for the memory of all shared memory rings (`GNL_FOOBAR_XMPL_C_RING_CREATE`). Ring memory
+ * can't be swapped and stays allocated as long as it is mapped. Global like `xfer_max_bytes`: anybody
+ * can create rings, and with user namespaces also any number of network namespaces.
+ */
+static unsigned long ring_max_bytes = 64UL << 20;
+module_param(ring_max_bytes, ulong, 0644);
+MODULE_PARM_DESC(ring_max_bytes, "Max. bytes of all shared memory rings of all network namespaces (default: 64 MiB)");
+
+/**
+ * Sum of the lengths of all rings of all network namespaces (incl. destroyed but still mapped ones);
+ * bounded by `ring_max_bytes`.
+ */
+static atomic64_t gnl_foobar_xmpl_ring_bytes = ATOMIC64_INIT(0);
+
+/**
+ * Upper bound for the event subscriptions (`GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE`) of one network namespace.
+ * Each emitted event is matched against all of them.
+ */
+static unsigned int event_max_subscribers = 4096;
+module_param(event_max_subscribers, uint, 0644);
+MODULE_PARM_DESC(event_max_subscribers, "Max. event subscriptions per network namespace (default: 4096)");
+
+/**
+ * Runtime tunables of the module, changed with `GNL_FOOBAR_XMPL_C_SET_CONFIG` while traffic is running.
+ *
+ * Readers never block: they dereference `gnl_foobar_xmpl_config` under rcu_read_lock() and see
+ * either the old or the new instance, never a mix of both. A writer changes a copy of the current
+ * instance, publishes it with rcu_assign_pointer() and frees the old one after a grace period.
+ * The config is global, like the module parameters, and not per network namespace.
+ */
+struct gnl_foobar_xmpl_config {
+    /** Number of records of an echo dump; see `gnl_cb_echo_dumpit_before()`. */
+    u32 dump_runs;
+    /** If true, the echo and dump handlers log every request. */
+    bool verbose;
+    /** See the module parameter of the same name. */
+    bool zerocopy_echo;
     /**
-     * Only one process is allowed per dump process. We need a lock for that.
+     * Payloads smaller than this are always copied. For small payloads the copy is cheaper than
+     * pinning pages and it also keeps the reply in a single linear buffer.
      */
-    struct mutex mtx;
+    u32 zerocopy_min_len;
+    /** Window for uploads that is advertised to clients. */
+    u32 xfer_window;
+    /** Max. number of payloads of one `GNL_FOOBAR_XMPL_C_CHECKSUM` request; 0: unlimited. */
+    u32 checksum_max_batch;
+    /** Max. number of dumps running at the same time per user; 0: unlimited. */
+    u32 dump_max_in_flight;
+    /** Max. number of records per run of a dump; 0: as many as fit into the skb. */
+    u32 dump_max_records;
+    struct rcu_head rcu;
+};
+
+static struct gnl_foobar_xmpl_config __rcu *gnl_foobar_xmpl_config;
+/** Serializes the writers of `gnl_foobar_xmpl_config`. */
+static DEFINE_MUTEX(gnl_foobar_xmpl_config_mtx);
+
+/** Reads a single field of the current config. Use rcu_read_lock() directly to read multiple fields. */
+#define gnl_foobar_xmpl_config_get(field) ({                                    \
+        typeof(((struct gnl_foobar_xmpl_config *) NULL)->field) __val;          \
+        rcu_read_lock();                                                        \
+        __val = rcu_dereference(gnl_foobar_xmpl_config)->field;                 \
+        rcu_read_unlock();                                                      \
+        __val;                                                                  \
+})
+
+/** pr_info() for messages in the request path; only logged if the tunable "verbose" is set. */
+#define pr_info_verbose(fmt, ...) do {                                          \
+        if (gnl_foobar_xmpl_config_get(verbose))                                \
+            pr_info(fmt, ##__VA_ARGS__);                                        \
+} while (0)
+
+/**
+ * State of the family inside one network namespace. Each network namespace (e.g. each container)
+ * gets its own instance, hence clients in different namespaces never share locks or data.
+ * Allocated and zeroed by the kernel when a namespace is created, see `gnl_foobar_xmpl_net_ops`.
+ */
+struct gnl_foobar_xmpl_net {
+    /** Protects `ports`. */
+    struct mutex port_mtx;
+    /** Accounting of the sockets that started dumps (`struct gnl_foobar_xmpl_port`). */
+    struct list_head ports;
+    /** Number of handled echo requests (.doit) in this namespace. */
+    atomic_long_t echo_requests;
+    /** Number of started dumps in this namespace. */
+    atomic_long_t dump_requests;
+    /** Protects `xfers`. */
+    struct mutex xfer_mtx;
+    /** Chunked transfers (`struct gnl_foobar_xmpl_xfer`) by id. */
+    struct idr xfers;
+    /** Protects `rings`. */
+    struct mutex ring_mtx;
+    /** Shared memory rings (`struct gnl_foobar_xmpl_ring`) by id. */
+    struct idr rings;
+    /** Protects `event_subs` and `event_sub_count`. */
+    struct mutex event_mtx;
+    /** Event subscriptions (`struct gnl_foobar_xmpl_event_sub`), at most one per socket. */
+    struct list_head event_subs;
+    unsigned int event_sub_count;
+    /** See `GNL_FOOBAR_XMPL_A_GENERATION` and `gnl_foobar_xmpl_generation_bump()`. */
+    atomic64_t generation;
+};
+
+/**
+ * Object of a chunked transfer. Owned by `gnl_foobar_xmpl_net.xfers`; running downloads hold an
+ * additional reference, hence an object can be deleted while it is being downloaded.
+ */
+struct gnl_foobar_xmpl_xfer {
+    struct kref ref;
+    u32 id;
     /**
-     * Number that describes how many packets we need to send until we are done
-     * during an ongoing dumpit process. 0 = done.
+     * Port id of the socket that started the upload. Only it may send chunks, commit or abort the
+     * transfer, and the transfer is deleted when the socket is closed.
      */
-    int unsigned runs_to_go;
+    u32 portid;
+    u64 size;
+    /** Bytes received so far, i.e. the offset of the next chunk. Protected by `xn->xfer_mtx`. */
+    u64 received;
+    /** Set by `GNL_FOOBAR_XMPL_C_XFER_COMMIT`; afterwards `buf` doesn't change anymore. */
+    bool committed;
+    /** `size` bytes; vmalloc()'ed for large objects. */
+    u8 *buf;
+};
+
+/**
+ * A shared memory ring; see "gnl_foobar_xmpl_ring.h" for the layout of `mem`. Owned by
+ * `gnl_foobar_xmpl_net.rings`; each mapping holds an additional reference, hence the memory stays
+ * valid for the userland until it unmaps it, even if the ring was destroyed in the meantime.
+ */
+struct gnl_foobar_xmpl_ring {
+    struct kref ref;
+    u32 id;
     /**
-     * Number that describes how many packets per dump are sent in total.
-     * Constant per dump.
+     * Port id of the socket that created the ring. Only it may ring the doorbell, read the stats or
+     * destroy the ring, and the ring is destroyed when the socket is closed.
      */
-    int unsigned total_runs;
-} dumpit_cb_progress_data;
+    u32 portid;
+    /** Effective user of the creator; the device is world-writable, hence only this user may map the ring. */
+    kuid_t uid;
+    /** Serializes doorbells of this ring; protects everything below. */
+    struct mutex mtx;
+    /** `mmap_len` bytes from vmalloc_user(), i.e. zeroed and mappable. */
+    void *mem;
+    size_t mmap_len;
+    u32 entries;
+    u32 slot_size;
+    /**
+     * The kernel's own copies of the indices it writes. The copies in the shared header are only
+     * published; reading them back would let the userland move them.
+     */
+    u32 sq_head;
+    u32 cq_tail;
+    u64 records;
+    u64 bytes;
+    u64 doorbells;
+};
 
-// Documentation is on the implementation of this function.
-int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info);
+/**
+ * Event subscription of a socket, see `GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE`. An event must match both
+ * parts of the filter.
+ */
+struct gnl_foobar_xmpl_event_sub {
+    struct list_head node;
+    /** Port id of the subscribed socket; receives the matching events as unicast. */
+    u32 portid;
+    /** Bit `1 << type` selects events of that type; 0 selects all. */
+    u64 type_mask;
+    /** Selects events whose key starts with it; empty selects all. */
+    char prefix[64];
+    size_t prefix_len;
+};
 
-// Documentation is on the implementation of this function.
-int gnl_cb_echo_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb);
+/**
+ * Accounting of the dumps of one socket (port id), see `GNL_FOOBAR_XMPL_C_PORT_STATS`. Created with the
+ * first dump of a socket and removed from `ports` when the socket is closed; each running dump holds a
+ * reference, because the socket can be closed before the dump is done.
+ */
+struct gnl_foobar_xmpl_port {
+    struct list_head node;
+    struct kref ref;
+    u32 portid;
+    atomic64_t dumps;
+    atomic64_t dumps_rejected;
+    atomic64_t dump_runs;
+    atomic64_t dump_runs_deferred;
+    atomic64_t dump_records;
+};
 
-// Documentation is on the implementation of this function.
-int gnl_cb_echo_dumpit_before(struct netlink_callback *cb);
+/**
+ * Running dumps of one user, i.e. of the sender of the dump requests; bounded by the tunable
+ * "dump_max_in_flight". Per user rather than per socket, because anybody can open more sockets, and
+ * rather than per namespace, because then one user could lock out everybody else. Exists while the
+ * user has running dumps.
+ */
+struct gnl_foobar_xmpl_owner {
+    struct list_head node;
+    kuid_t uid;
+    /** Protected by `gnl_foobar_xmpl_owners_mtx`. */
+    u32 dumps_in_flight;
+};
 
-// Documentation is on the implementation of this function.
-int gnl_cb_echo_dumpit_before_after(struct netlink_callback *cb);
+/**
+ * Users with running dumps (`struct gnl_foobar_xmpl_owner`) of all network namespaces. Global like
+ * `gnl_foobar_xmpl_xfer_bytes`: with user namespaces, anybody can create network namespaces, hence a
+ * list per network namespace would give a user a fresh quota in each of them. `kuid_t` is the same in
+ * all namespaces. The progress of each dump is stored in its `struct netlink_callback`, hence dumps
+ * don't share any other state and run in parallel.
+ */
+static LIST_HEAD(gnl_foobar_xmpl_owners);
+/** Protects `gnl_foobar_xmpl_owners`. */
+static DEFINE_MUTEX(gnl_foobar_xmpl_owners_mtx);
 
-// Documentation is on the implementation of this function.
-int gnl_cb_doit_reply_with_nlmsg_err(struct sk_buff *sender_skb, struct genl_info *info);
+/** Slots of `cb->args[]` that all dumps use for the accounting; the dumps themselves use the lower ones. */
+#define GNL_FOOBAR_XMPL_DUMP_ARG_OWNER 3
+#define GNL_FOOBAR_XMPL_DUMP_ARG_MAX_RECORDS 4
+#define GNL_FOOBAR_XMPL_DUMP_ARG_PORT 5
+
+/** Offset of the submission queue in a ring; the completion queue follows it directly. */
+#define GNL_FOOBAR_XMPL_RING_SQ_OFF ALIGN(sizeof(struct gnl_foobar_xmpl_ring_hdr), GNL_FOOBAR_XMPL_RING_MIN_SLOT_SIZE)
+
+/** Id of our per network namespace data; assigned by `register_pernet_subsys()`. */
+static unsigned int gnl_foobar_xmpl_net_id;
 
 /**
- * The length of `struct genl_ops gnl_foobar_xmpl_ops[]`. Not necessarily
- * the number of commands in `enum GNlFoobarXmplCommand`. It depends on your application logic.
- * For example, you can use the same command multiple times and - dependent by flag -
- * invoke a different callback handler. In our simple example we just use one .doit callback
- * per operation/command.
+ * Returns the state of the family in the given network namespace.
+ * Use `genl_info_net(info)` in .doit and `sock_net(cb->skb->sk)` in .dumpit callbacks to get `net`.
  */
-#define GNL_FOOBAR_OPS_LEN (GNL_FOOBAR_XMPL_COMMAND_COUNT)
+static struct gnl_foobar_xmpl_net *gnl_foobar_xmpl_pernet(const struct net *net) {
+    return net_generic(net, gnl_foobar_xmpl_net_id);
+}
 
 /**
- * Array with all operations that our protocol on top of Generic Netlink
- * supports. An operation is the glue between a command ("cmd" field in `struct genlmsghdr` of
- * received Generic Netlink message) and the corresponding ".doit" callback function.
- * See: https://elixir.bootlin.com/linux/v5.11/source/include/net/genetlink.h#L148
+ * Number of preallocated reply skbs per CPU (0 disables the cache). See `gnl_foobar_xmpl_reply_alloc()`.
  */
-struct genl_ops gnl_foobar_xmpl_ops[GNL_FOOBAR_OPS_LEN] = {
-        {
-                /* The "cmd" field in `struct genlmsghdr` of received Generic Netlink message */
-                .cmd = GNL_FOOBAR_XMPL_C_ECHO_MSG,
-                /* TODO Use case ? */
-                .flags = 0,
-                /* TODO Use case ? */
-                .internal_flags = 0,
-                /* Callback handler when a request with the specified ".cmd" above is received.
-                 * Always validates the payload except one set NO_STRICT_VALIDATION flag in ".validate"
-                 * See: https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L717
-                 *
-                 * Quote from: https://lwn.net/Articles/208755
-                 *  "The 'doit' handler should do whatever processing is necessary and return
-                 *   zero on success, or a negative value on failure.  Negative return values
-                 *   will cause a NLMSG_ERROR message to be sent while a zero return value will
-                 *   only cause a NLMSG_ERROR message to be sent if the request is received with
-                 *   the NLM_F_ACK flag set."
-                 *
-                 * You can find this in Linux code here:
-                 * https://elixir.bootlin.com/linux/v5.11/source/net/netlink/af_netlink.c#L2499
-                 *
-                 * One can find more information about NLMSG_ERROR responses and how to handle them
-                 * in userland in the manpage: https://man7.org/linux/man-pages/man7/netlink.7.html
-                 *
-                 */
-                .doit = gnl_cb_echo_doit,
-                /* This callback is similar in use to the standard Netlink 'dumpit' callback.
-                 * The 'dumpit' callback is invoked when a Generic Netlink message is received
-                 * with the NLM_F_DUMP flag set.
-                 *
-                 * A dump can be understand as a "GET ALL DATA OF THE GIVEN ENTITY", i.e.
-                 * the userland can receive as long as the .dumpit callback returns data.
-                 *
-                 * .dumpit is not mandatory, but either it or .doit must be provided, see
-                 * https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L367
-                 *
-                 * To be honest I don't know in what use case one should use .dumpit and why
-                 * it is useful, because you can achieve the same also with .doit handlers.
-                 * Anyway, this is just an example/tutorial.
-                 *
-                 * Quote from: https://lwn.net/Articles/208755
-                 *  "The main difference between a 'dumpit' handler and a 'doit' handler is
-                 *   that a 'dumpit' handler does not allocate a message buffer for a response;
-                 *   a pre-allocated sk_buff is passed to the 'dumpit' handler as the first
-                 *   parameter.  The 'dumpit' handler should fill the message buffer with the
-                 *   appropriate response message and return the size of the sk_buff,
-                 *   i.e. sk_buff->len, and the message buffer will automatically be sent to the
-                 *   Generic Netlink client that initiated the request.  As long as the 'dumpit'
-                 *   handler returns a value greater than zero it will be called again with a
-                 *   newly allocated message buffer to fill, when the handler has no more data
-                 *   to send it should return zero; error conditions are indicated by returning
-                 *   a negative value.  If necessary, state can be preserved in the
-                 *   netlink_callback parameter which is passed to the 'dumpit' handler; the
-                 *   netlink_callback parameter values will be preserved across handler calls
-                 *   for a single request."
-                 *
-                 * You can see the check for the NLM_F_DUMP-flag here:
-                 * https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L780
-                 */
-                .dumpit = gnl_cb_echo_dumpit,
-                /* Start callback for dumps. Can be used to lock data structures. */
-                .start = gnl_cb_echo_dumpit_before,
-                /* Completion callback for dumps. Can be used for cleanup after a dump and releasing locks. */
-                .done = gnl_cb_echo_dumpit_before_after,
-                /*
-                 0 (= "validate strictly") or value `enum genl_validate_flags`
-                 * see: https://elixir.bootlin.com/linux/v5.11/source/include/net/genetlink.h#L108
-                 */
-                .validate = 0,
-        },
-        {
-                .cmd = GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR,
-                .flags = 0,
-                .internal_flags = 0,
-                .doit = gnl_cb_doit_reply_with_nlmsg_err,
-                // .dumpit is not required, only optional; application specific/dependent on your use case
-                // in a real application you probably have different .dumpit handlers per operation/command
-                .dumpit = NULL,
-                // in a real application you probably have different .start handlers per operation/command
-                .start = NULL,
-                // in a real application you probably have different .done handlers per operation/command
-                .done = NULL,
-                .validate = 0,
-        }
+static unsigned int skb_cache_depth = 16;
+module_param(skb_cache_depth, uint, 0444);
+MODULE_PARM_DESC(skb_cache_depth, "Preallocated reply skbs per CPU (default: 16, 0 disables the cache)");
+
+/**
+ * Per CPU cache of preallocated reply skbs. Each skb has room for `NLMSG_DEFAULT_SIZE` bytes of
+ * Netlink payload. Replies consume the skbs, hence they are never returned to the cache; instead
+ * `gnl_foobar_xmpl_skb_cache_work` allocates new ones outside of the request path.
+ *
+ * The per CPU queues only avoid contention; `struct sk_buff_head` has its own lock, so it is fine
+ * if a task migrates to another CPU while it uses the queue of its old CPU.
+ */
+static DEFINE_PER_CPU(struct sk_buff_head, gnl_foobar_xmpl_skb_cache);
+
+/** Statistics of the reply skb cache; readable in debugfs ("gnl_foobar_xmpl/skb_cache"). */
+struct gnl_foobar_xmpl_skb_cache_stats {
+    /** Reply skb was taken from the cache. */
+    u64 hits;
+    /** Reply would have fit, but the cache of the CPU was empty; allocated in the request path. */
+    u64 misses;
+    /** skbs allocated by the refill work. */
+    u64 refills;
 };
+static DEFINE_PER_CPU(struct gnl_foobar_xmpl_skb_cache_stats, gnl_foobar_xmpl_skb_cache_stats);
+
+/**
+ * Fills the caches of all CPUs up to `skb_cache_depth` skbs. Runs in a workqueue, i.e. it may
+ * sleep and reclaim memory without delaying a request.
+ */
+static void gnl_foobar_xmpl_skb_cache_refill(struct work_struct *work) {
+    int cpu;
+
+    for_each_possible_cpu(cpu) {
+        struct sk_buff_head *cache = per_cpu_ptr(&gnl_foobar_xmpl_skb_cache, cpu);
+
+        while (skb_queue_len(cache) < skb_cache_depth) {
+            struct sk_buff *skb = nlmsg_new(NLMSG_DEFAULT_SIZE, GFP_KERNEL);
+
+            if (skb == NULL) {
+                // try again with the next miss
+                return;
+            }
+            skb_queue_tail(cache, skb);
+            per_cpu_ptr(&gnl_foobar_xmpl_skb_cache_stats, cpu)->refills++;
+        }
+    }
+}
+static DECLARE_WORK(gnl_foobar_xmpl_skb_cache_work, gnl_foobar_xmpl_skb_cache_refill);
+
+/**
+ * Allocates a skb for a Generic Netlink reply with `payload` bytes; a drop-in replacement for
+ * `genlmsg_new(payload, GFP_KERNEL)`. Small replies take a preallocated skb from the cache of the
+ * current CPU, hence their allocation is cheap and doesn't enter memory reclaim. The refill work
+ * is kicked once the cache is half empty. Larger replies are allocated as usual.
+ *
+ * Like with `genlmsg_new()`, the caller owns the skb: either it is consumed by `genlmsg_reply()`
+ * or it must be freed with `nlmsg_free()`. The skb has room for `GNL_FOOBAR_XMPL_A_GENERATION`
+ * in addition to `payload`, see `gnl_foobar_xmpl_reply_put()`.
+ *
+ * @return the skb or NULL
+ */
+static struct sk_buff *gnl_foobar_xmpl_reply_alloc(size_t payload) {
+    struct sk_buff_head *cache;
+    struct sk_buff *skb;
+
+    payload += nla_total_size_64bit(sizeof(u64));
+    if (genlmsg_total_size(payload) > NLMSG_DEFAULT_SIZE) {
+        return genlmsg_new(payload, GFP_KERNEL);
+    }
+
+    cache = raw_cpu_ptr(&gnl_foobar_xmpl_skb_cache);
+    skb = skb_dequeue(cache);
+    if (skb_queue_len(cache) < (skb_cache_depth + 1) / 2) {
+        schedule_work(&gnl_foobar_xmpl_skb_cache_work);
+    }
+    if (skb != NULL) {
+        this_cpu_inc(gnl_foobar_xmpl_skb_cache_stats.hits);
+        return skb;
+    }
+    this_cpu_inc(gnl_foobar_xmpl_skb_cache_stats.misses);
+    return genlmsg_new(payload, GFP_KERNEL);
+}
+
+static int gnl_foobar_xmpl_skb_cache_show(struct seq_file *m, void *v) {
+    struct gnl_foobar_xmpl_skb_cache_stats sum = {0};
+    unsigned int cached = 0;
+    int cpu;
+
+    for_each_possible_cpu(cpu) {
+        const struct gnl_foobar_xmpl_skb_cache_stats *stats = per_cpu_ptr(&gnl_foobar_xmpl_skb_cache_stats, cpu);
+
+        sum.hits += stats->hits;
+        sum.misses += stats->misses;
+        sum.refills += stats->refills;
+        cached += skb_queue_len(per_cpu_ptr(&gnl_foobar_xmpl_skb_cache, cpu));
+    }
+    seq_printf(m, "depth per cpu: %u\ncached: %u\nhits: %llu\nmisses: %llu\nrefills: %llu\n",
+               skb_cache_depth, cached, sum.hits, sum.misses, sum.refills);
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(gnl_foobar_xmpl_skb_cache);
+
+/** Directory "gnl_foobar_xmpl" in debugfs. */
+static struct dentry *gnl_foobar_xmpl_debugfs;
+
+/**
+ * Initializes the reply skb cache and fills it (synchronously, so that the first requests hit).
+ */
+static void gnl_foobar_xmpl_skb_cache_init(void) {
+    int cpu;
+
+    for_each_possible_cpu(cpu) {
+        skb_queue_head_init(per_cpu_ptr(&gnl_foobar_xmpl_skb_cache, cpu));
+    }
+    gnl_foobar_xmpl_skb_cache_refill(NULL);
+
+    // debugfs is optional; errors are deliberately ignored (like everywhere in the kernel)
+    gnl_foobar_xmpl_debugfs = debugfs_create_dir(KBUILD_MODNAME, NULL);
+    debugfs_create_file("skb_cache", 0444, gnl_foobar_xmpl_debugfs, NULL, &gnl_foobar_xmpl_skb_cache_fops);
+}
 
 /**
+ * Frees all cached skbs. No request may be in flight anymore.
+ */
+static void gnl_foobar_xmpl_skb_cache_exit(void) {
+    int cpu;
+
+    debugfs_remove_recursive(gnl_foobar_xmpl_debugfs);
+    cancel_work_sync(&gnl_foobar_xmpl_skb_cache_work);
+    for_each_possible_cpu(cpu) {
+        skb_queue_purge(per_cpu_ptr(&gnl_foobar_xmpl_skb_cache, cpu));
+    }
+}
+
+// Documentation is on the implementation of this function.
+static int gnl_echo_data_reply(struct genl_info *info, const struct nlattr *na);
+
+/*
+ * The attribute policy `gnl_foobar_xmpl_policy[]` and the operations `gnl_foobar_xmpl_ops[]` are
+ * generated from "spec/gnl_foobar_xmpl.yaml" (together with "gnl_foobar_xmpl_prop.h" and the
+ * userland codecs), so that all languages stay in sync. The generated header also declares the
+ * handler functions that are implemented below.
+ *
  * Attribute policy: defines which attribute has which type (e.g int, char * etc).
  * This get validated for each received Generic Netlink message, if not deactivated
  * in `gnl_foobar_xmpl_ops[].validate`.
  * See https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L717
+ *
+ * Operations: an operation is the glue between a command ("cmd" field in `struct genlmsghdr` of
+ * received Generic Netlink message) and the corresponding ".doit" callback function.
+ * See: https://elixir.bootlin.com/linux/v5.11/source/include/net/genetlink.h#L148
+ * The fields of `struct genl_ops` are:
+ *
+ * - ".cmd": The "cmd" field in `struct genlmsghdr` of received Generic Netlink message
+ *
+ * - ".doit": Callback handler when a request with the specified ".cmd" above is received.
+ *   Always validates the payload except one set NO_STRICT_VALIDATION flag in ".validate"
+ *   See: https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L717
+ *
+ *   Quote from: https://lwn.net/Articles/208755
+ *    "The 'doit' handler should do whatever processing is necessary and return
+ *     zero on success, or a negative value on failure.  Negative return values
+ *     will cause a NLMSG_ERROR message to be sent while a zero return value will
+ *     only cause a NLMSG_ERROR message to be sent if the request is received with
+ *     the NLM_F_ACK flag set."
+ *
+ *   You can find this in Linux code here:
+ *   https://elixir.bootlin.com/linux/v5.11/source/net/netlink/af_netlink.c#L2499
+ *
+ *   One can find more information about NLMSG_ERROR responses and how to handle them
+ *   in userland in the manpage: https://man7.org/linux/man-pages/man7/netlink.7.html
+ *
+ * - ".dumpit": This callback is similar in use to the standard Netlink 'dumpit' callback.
+ *   The 'dumpit' callback is invoked when a Generic Netlink message is received
+ *   with the NLM_F_DUMP flag set.
+ *
+ *   A dump can be understand as a "GET ALL DATA OF THE GIVEN ENTITY", i.e.
+ *   the userland can receive as long as the .dumpit callback returns data.
+ *
+ *   .dumpit is not mandatory, but either it or .doit must be provided, see
+ *   https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L367
+ *
+ *   Quote from: https://lwn.net/Articles/208755
+ *    "The main difference between a 'dumpit' handler and a 'doit' handler is
+ *     that a 'dumpit' handler does not allocate a message buffer for a response;
+ *     a pre-allocated sk_buff is passed to the 'dumpit' handler as the first
+ *     parameter.  The 'dumpit' handler should fill the message buffer with the
+ *     appropriate response message and return the size of the sk_buff,
+ *     i.e. sk_buff->len, and the message buffer will automatically be sent to the
+ *     Generic Netlink client that initiated the request.  As long as the 'dumpit'
+ *     handler returns a value greater than zero it will be called again with a
+ *     newly allocated message buffer to fill, when the handler has no more data
+ *     to send it should return zero; error conditions are indicated by returning
+ *     a negative value.  If necessary, state can be preserved in the
+ *     netlink_callback parameter which is passed to the 'dumpit' handler; the
+ *     netlink_callback parameter values will be preserved across handler calls
+ *     for a single request."
+ *
+ *   You can see the check for the NLM_F_DUMP-flag here:
+ *   https://elixir.bootlin.com/linux/v5.11/source/net/netlink/genetlink.c#L780
+ *
+ * - ".start": Start callback for dumps. Can be used to lock data structures.
+ *
+ * - ".done": Completion callback for dumps. Can be used for cleanup after a dump and releasing locks.
+ *
+ * - ".validate": 0 (= "validate strictly") or value `enum genl_validate_flags`
+ *   see: https://elixir.bootlin.com/linux/v5.11/source/include/net/genetlink.h#L108
  */
-static struct nla_policy gnl_foobar_xmpl_policy[GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN] = {
-        // In case you are seeing this syntax for the first time (I also learned this just after a few years of
-        // coding with C myself): The following static array initiations are equivalent:
-        // `int a[2] = {1, 2}` <==> `int a[2] = {[0] => 1, [1] => 2}`.
-
-        [GNL_FOOBAR_XMPL_A_UNSPEC] = {.type = NLA_UNSPEC},
-
-        // You can set this to NLA_U32 for testing and send an ECHO message from the userland
-        // It will fail in this case and you see a entry in the kernel log.
-
-        // `enum GNL_FOOBAR_XMPL_ATTRIBUTE::GNL_FOOBAR_XMPL_A_MSG` is a null-terminated C-String
-        [GNL_FOOBAR_XMPL_A_MSG] = {.type = NLA_NUL_STRING},
-};
+#include "gnl_foobar_xmpl_nl.h"
 
 /**
  * Definition of the Netlink family we want to register using Generic Netlink functionality
@@ -242,11 +594,14 @@ static struct genl_family gnl_foobar_xmpl_family = {
         .ops = gnl_foobar_xmpl_ops,
         // length of array `gnl_foobar_xmpl_ops`
         .n_ops = GNL_FOOBAR_OPS_LEN,
+        // multicast groups; the kernel assigns their ids, userland resolves them by name
+        .mcgrps = gnl_foobar_xmpl_mcgrps,
+        .n_mcgrps = ARRAY_SIZE(gnl_foobar_xmpl_mcgrps),
         // attribute policy (for validation of messages). Enforced automatically, except ".validate" in
         // corresponding ".ops"-field is set accordingly.
         .policy = gnl_foobar_xmpl_policy,
-        // Number of attributes / bounds check for policy (array length)
-        .maxattr = GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN,
+        // Highest attribute number / bounds check for policy (array length - 1)
+        .maxattr = GNL_FOOBAR_XMPL_A_MAX,
         // Owning Kernel module of the Netlink family we register.
         .module = THIS_MODULE,
 
@@ -254,16 +609,99 @@ static struct genl_family gnl_foobar_xmpl_family = {
         // but this way one sees all possible options.
 
         // if your application must handle multiple netlink calls in parallel (where one should not block the next
-        // from starting), set this to true! otherwise all netlink calls are mutually exclusive
-        .parallel_ops = 0,
-        // set to true if the family can handle network namespaces and should be presented in all of them
-        .netnsok = 0,
+        // from starting), set this to true! otherwise all netlink calls are mutually exclusive.
+        // Every piece of shared state has its own lock (the mutexes in `struct gnl_foobar_xmpl_net`, the
+        // RCU protected config, atomics), hence we don't need the global lock of Generic Netlink.
+        .parallel_ops = 1,
+        // set to true if the family can handle network namespaces and should be presented in all of them.
+        // We keep all state per namespace (see `struct gnl_foobar_xmpl_net`), hence we can do that.
+        .netnsok = 1,
         // called before an operation's doit callback, it may do additional, common, filtering and return an error
         .pre_doit = NULL,
         // called after an operation's doit callback, it may undo operations done by pre_doit, for example release locks
         .post_doit = NULL,
 };
 
+/**
+ * Handlers read the generation before they take the snapshot of the state that they reply with:
+ * a change bumps it after the state changed, hence a reply is never labeled with a generation
+ * that is newer than its data. The acquire keeps the reads of the state behind this one.
+ *
+ * @return the current generation of the namespace, see `GNL_FOOBAR_XMPL_A_GENERATION`
+ */
+static u64 gnl_foobar_xmpl_generation(struct net *net) {
+    return atomic64_read_acquire(&gnl_foobar_xmpl_pernet(net)->generation);
+}
+
+/**
+ * Appends `GNL_FOOBAR_XMPL_A_GENERATION` to a message of the family.
+ *
+ * @return success (0) or -EMSGSIZE.
+ */
+static int gnl_foobar_xmpl_put_generation(struct sk_buff *skb, u64 generation) {
+    return nla_put_u64_64bit(skb, GNL_FOOBAR_XMPL_A_GENERATION, generation, GNL_FOOBAR_XMPL_A_PAD);
+}
+
+/**
+ * `genlmsg_put()` for replies: adds the headers and `GNL_FOOBAR_XMPL_A_GENERATION`, which is part of
+ * every reply. `gnl_foobar_xmpl_reply_alloc()` reserves the room for it. `generation` must be read
+ * with `gnl_foobar_xmpl_generation()` before the state that the reply carries.
+ *
+ * @return the user header (like `genlmsg_put()`) or NULL if the skb is too small.
+ */
+static void *gnl_foobar_xmpl_reply_put(struct sk_buff *skb, u64 generation, u32 portid, u32 seq, u8 cmd) {
+    void *msg_head = genlmsg_put(skb, portid, seq, &gnl_foobar_xmpl_family, 0, cmd);
+
+    if (msg_head != NULL && gnl_foobar_xmpl_put_generation(skb, generation) != 0) {
+        genlmsg_cancel(skb, msg_head);
+        return NULL;
+    }
+    return msg_head;
+}
+
+/**
+ * Advances the generation of a namespace after a change of the state that read-only commands
+ * return. Sends `GNL_FOOBAR_XMPL_C_INVALIDATE` to the group "invalidate" if it has members.
+ * The notification is queued before the request that caused the change is answered, hence a
+ * listener that has seen the reply of a change also has its notification in the receive queue.
+ */
+static void gnl_foobar_xmpl_generation_bump(struct net *net, gfp_t flags) {
+    const u64 generation = atomic64_inc_return(&gnl_foobar_xmpl_pernet(net)->generation);
+    struct sk_buff *skb;
+    void *msg_head;
+
+    if (!genl_has_listeners(&gnl_foobar_xmpl_family, net, GNL_FOOBAR_XMPL_MCGRP_INVALIDATE)) {
+        return;
+    }
+    skb = genlmsg_new(nla_total_size_64bit(sizeof(u64)), flags);
+    if (skb == NULL) {
+        return;
+    }
+    msg_head = genlmsg_put(skb, 0, 0, &gnl_foobar_xmpl_family, 0, GNL_FOOBAR_XMPL_C_INVALIDATE);
+    if (msg_head == NULL ||
+        nla_put_u64_64bit(skb, GNL_FOOBAR_XMPL_A_GENERATION, generation, GNL_FOOBAR_XMPL_A_PAD)) {
+        nlmsg_free(skb);
+        return;
+    }
+    genlmsg_end(skb, msg_head);
+    // consumes the skb; -ESRCH if the last listener left in the meantime
+    genlmsg_multicast_netns(&gnl_foobar_xmpl_family, net, skb, 0, GNL_FOOBAR_XMPL_MCGRP_INVALIDATE, flags);
+}
+
+/**
+ * `gnl_foobar_xmpl_generation_bump()` for all namespaces, e.g. after a change of the (global) config.
+ */
+static void gnl_foobar_xmpl_generation_bump_all(void) {
+    struct net *net;
+
+    // namespaces leave the list (and an RCU grace period passes) before their state is released
+    rcu_read_lock();
+    for_each_net_rcu(net) {
+        gnl_foobar_xmpl_generation_bump(net, GFP_ATOMIC);
+    }
+    rcu_read_unlock();
+}
+
 /**
  * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_ECHO` is received.
  * Please look into the comments where this is used as ".doit" callback above in
@@ -276,22 +714,32 @@ int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info) {
     void *msg_head;
     char *recv_msg;
 
-    pr_info("%s() invoked\n", __func__);
+    pr_info_verbose("%s() invoked\n", __func__);
 
     if (info == NULL) {
         // should never happen
         pr_err("An error occurred in %s():\n", __func__);
         return -EINVAL;
     }
+    atomic_long_inc(&gnl_foobar_xmpl_pernet(genl_info_net(info))->echo_requests);
 
     /*
      * For each attribute there is an index in info->attrs which points to a nlattr structure
      * in this structure the data is stored.
      */
+    na = info->attrs[GNL_FOOBAR_XMPL_A_DATA];
+    if (na) {
+        // binary payloads have their own reply path; see `gnl_echo_data_reply()`
+        return gnl_echo_data_reply(info, na);
+    }
+
     na = info->attrs[GNL_FOOBAR_XMPL_A_MSG];
 
     if (!na) {
         pr_err("no info->attrs[%i]\n", GNL_FOOBAR_XMPL_A_MSG);
+        // Reported to the userland in the NLMSG_ERROR reply if the socket has NETLINK_EXT_ACK set.
+        // The message must be a string literal: extack only stores the pointer.
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_MSG or GNL_FOOBAR_XMPL_A_DATA");
         return -EINVAL; // we return here because we expect to recv a msg
     }
 
@@ -299,15 +747,16 @@ int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info) {
     if (recv_msg == NULL) {
         pr_err("error while receiving data\n");
     } else {
-        pr_info("received: '%s'\n", recv_msg);
+        pr_info_verbose("received: '%s'\n", recv_msg);
     }
 
 
     // Send a message back
     // ---------------------
 
-    // Allocate some memory, since the size is not yet known use NLMSG_GOODSIZE
-    reply_skb = genlmsg_new(NLMSG_GOODSIZE, GFP_KERNEL);
+    // Allocate some memory for the reply: one attribute with the same size as the received one.
+    // Small replies come from our per CPU cache of preallocated skbs.
+    reply_skb = gnl_foobar_xmpl_reply_alloc(nla_total_size(nla_len(na)));
     if (reply_skb == NULL) {
         pr_err("An error occurred in %s():\n", __func__);
         return -ENOMEM;
@@ -335,9 +784,16 @@ int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info) {
                            GNL_FOOBAR_XMPL_C_ECHO_MSG
     );
     if (msg_head == NULL) {
-        rc = ENOMEM;
+        rc = -EMSGSIZE;
+        pr_err("An error occurred in %s():\n", __func__);
+        goto err_free_skb;
+    }
+
+    // Every reply of the family carries the generation (see `gnl_foobar_xmpl_reply_put()`)
+    rc = gnl_foobar_xmpl_put_generation(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)));
+    if (rc != 0) {
         pr_err("An error occurred in %s():\n", __func__);
-        return -rc;
+        goto err_free_skb;
     }
 
     // Add a GNL_FOOBAR_XMPL_A_MSG attribute (actual value/payload to be sent)
@@ -345,7 +801,7 @@ int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info) {
     rc = nla_put_string(reply_skb, GNL_FOOBAR_XMPL_A_MSG, recv_msg);
     if (rc != 0) {
         pr_err("An error occurred in %s():\n", __func__);
-        return -rc;
+        goto err_free_skb;
     }
 
     // Finalize the message:
@@ -353,145 +809,1883 @@ int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info) {
     // attributes. Only necessary if attributes have been added to the message.
     genlmsg_end(reply_skb, msg_head);
 
-    // Send the message back
+    // Send the message back. This consumes the skb, also on failure.
     rc = genlmsg_reply(reply_skb, info);
     // same as genlmsg_unicast(genl_info_net(info), reply_skb, info->snd_portid)
     // see https://elixir.bootlin.com/linux/v5.8.9/source/include/net/genetlink.h#L326
 
     if (rc != 0) {
         pr_err("An error occurred in %s():\n", __func__);
-        return -rc;
     }
-    return 0;
+    return rc;
+
+err_free_skb:
+    // until it is handed to genlmsg_reply(), the skb is ours; don't leak it
+    nlmsg_free(reply_skb);
+    return rc;
 }
 
 /**
- * ".dumpit"-callback function if a Generic Netlink with command ECHO_MSG and flag `NLM_F_DUMP` is received.
- * Please look into the comments where this is used as ".dumpit" callback above in
- * `struct genl_ops gnl_foobar_xmpl_ops[]` for more information about ".dumpit" callbacks.
+ * Builds the echo reply for a `GNL_FOOBAR_XMPL_A_DATA` payload without copying the payload.
  *
- * A dump must be understand of "give me all data of a given entity"
- * rather than a "dump of the netlink message itself" for debugging etc!
+ * Netlink copies requests larger than NLMSG_GOODSIZE from userland into a vmalloc'ed buffer
+ * (see `netlink_alloc_large_skb()` in net/netlink/af_netlink.c). Instead of copying the payload a
+ * second time into the reply, only the headers are written into the (tiny) linear part of the reply
+ * skb. The payload is attached as page fragments that reference the pages of the request. Each
+ * fragment holds a page reference, hence the pages outlive the request skb until the reply
+ * was copied to the receiving socket.
  *
- * This handler requires `gnl_cb_echo_dumpit_before` to run before a dump and `gnl_cb_echo_dumpit_after` after a dump.
+ * Like all reply builders, this doesn't depend on `struct genl_info` or a socket, hence it can be
+ * called with a synthetic attribute, e.g. to measure the handler path without the socket layer.
  *
- * For the sake of simplicity, we use the ECHO_MSG command for the dump. In fact, we don't expect a
- * MSG-Attribute here, unlike the regular ECHO_MSG handler. We reply with a dump of
- * "all messages that we got" (application specific, hard coded in this example).
-*/
-int gnl_cb_echo_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb) {
+ * @return the reply skb, NULL if the payload doesn't qualify for the zero-copy path or an ERR_PTR
+ */
+static struct sk_buff *gnl_echo_data_build_zerocopy_reply(struct net *net, u32 portid, u32 seq,
+                                                          const struct nlattr *na) {
+    const char *payload = nla_data(na);
+    const int payload_len = nla_len(na);
+    const int pad_len = nla_padlen(payload_len);
+    struct sk_buff *reply_skb;
+    struct nlattr *reply_na;
     void *msg_head;
-    int ret;
-    static const char HELLO_FROM_DUMPIT_MSG[] = "You set the flag NLM_F_DUMP; this message is "
-                                                "brought to you by .dumpit callback :)";
-    pr_info("Called %s()\n", __func__);
+    int nr_frags;
+    const struct gnl_foobar_xmpl_config *cfg;
+    bool zerocopy;
+    int done;
+    int i;
 
-    if (dumpit_cb_progress_data.runs_to_go == 0) {
-        pr_info("no more data to send in dumpit cb\n");
-        // mark that dump is done;
-        return 0;
-    } else {
-        dumpit_cb_progress_data.runs_to_go--;
-        pr_info("%s: %d more runs to do\n", __func__, dumpit_cb_progress_data.runs_to_go);
-    }
-
-    msg_head = genlmsg_put(pre_allocated_skb, // buffer for netlink message: struct sk_buff *
-            // According to my findings: this is not used for routing
-            // This can be used in an application specific way to target
-            // different endpoints within the same user application
-            // but general rule: just put sender port id here
-                           cb->nlh->nlmsg_pid, // sending port (not process) id: int
-            // sequence number: int (might be used by receiver, but not mandatory)
-            // sequence 0, 1, 2...
-                           dumpit_cb_progress_data.total_runs - dumpit_cb_progress_data.runs_to_go - 1,
-                           &gnl_foobar_xmpl_family, // struct genl_family *
-                           0, // flags: int (for netlink header); we don't check them in the userland; application specific
-            // this way we can trigger a specific command/callback on the receiving side or imply
-            // on which type of command we are currently answering; this is application specific
-                           GNL_FOOBAR_XMPL_C_ECHO_MSG // cmd: u8 (for generic netlink header);
-    );
+    rcu_read_lock();
+    cfg = rcu_dereference(gnl_foobar_xmpl_config);
+    zerocopy = cfg->zerocopy_echo && (u32) payload_len >= cfg->zerocopy_min_len;
+    rcu_read_unlock();
+    if (!zerocopy || !is_vmalloc_addr(payload)) {
+        return NULL;
+    }
+    // one fragment per (partially) covered page; and one for the attribute padding
+    nr_frags = DIV_ROUND_UP(offset_in_page(payload) + payload_len, PAGE_SIZE) + (pad_len ? 1 : 0);
+    if (nr_frags > MAX_SKB_FRAGS) {
+        return NULL;
+    }
+
+    // linear part: only space for the attribute header; the payload doesn't live in it
+    reply_skb = gnl_foobar_xmpl_reply_alloc(NLA_HDRLEN);
+    if (reply_skb == NULL) {
+        return ERR_PTR(-ENOMEM);
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(net), portid, seq,
+                                         GNL_FOOBAR_XMPL_C_ECHO_MSG);
     if (msg_head == NULL) {
-        pr_info("An error occurred in %s(): genlmsg_put() failed\n", __func__);
-        return -ENOMEM;
+        nlmsg_free(reply_skb);
+        return ERR_PTR(-EMSGSIZE);
     }
-    ret = nla_put_string(
-            pre_allocated_skb,
-            GNL_FOOBAR_XMPL_A_MSG,
-            HELLO_FROM_DUMPIT_MSG
-    );
-    if (ret < 0) {
-        pr_info("An error occurred in %s():\n", __func__);
-        return ret;
+    // nla_reserve() would reserve the payload in the linear part; we only need the header there
+    reply_na = skb_put(reply_skb, NLA_HDRLEN);
+    reply_na->nla_type = GNL_FOOBAR_XMPL_A_DATA;
+    reply_na->nla_len = nla_attr_size(payload_len);
+
+    for (i = 0, done = 0; done < payload_len; i++) {
+        const int page_offset = offset_in_page(payload + done);
+        const int chunk = min_t(int, PAGE_SIZE - page_offset, payload_len - done);
+        struct page *page = vmalloc_to_page(payload + done);
+
+        // dropped again by kfree_skb()/consume_skb() of the reply
+        get_page(page);
+        // updates len, data_len and truesize of the skb
+        skb_add_rx_frag(reply_skb, i, page, page_offset, chunk, chunk);
+        done += chunk;
+    }
+    if (pad_len) {
+        get_page(ZERO_PAGE(0));
+        skb_add_rx_frag(reply_skb, i, ZERO_PAGE(0), 0, pad_len, pad_len);
     }
-    genlmsg_end(pre_allocated_skb, msg_head);
 
-    // return the length of data we wrote into the pre-allocated buffer
-    return pre_allocated_skb->len;
+    // genlmsg_end() only accounts the linear part of the skb; the message spans the whole skb
+    genlmsg_end(reply_skb, msg_head);
+    nlmsg_hdr(reply_skb)->nlmsg_len = reply_skb->len;
+    return reply_skb;
 }
 
 /**
- * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR` is received.
- * Please look into the comments where this is used as ".doit" callback above in
- * `struct genl_ops gnl_foobar_xmpl_ops[]` for more information about ".doit" callbacks.
-*/
-int gnl_cb_doit_reply_with_nlmsg_err(struct sk_buff *sender_skb, struct genl_info *info) {
-    pr_info("%s() invoked, a NLMSG_ERR response will be sent back\n", __func__);
+ * Builds the echo reply for a `GNL_FOOBAR_XMPL_A_DATA` payload by copying the payload into a new
+ * linear skb. Used for small payloads or if the zero-copy path is disabled.
+ *
+ * @return the reply skb or an ERR_PTR
+ */
+static struct sk_buff *gnl_echo_data_build_copy_reply(struct net *net, u32 portid, u32 seq, const struct nlattr *na) {
+    struct sk_buff *reply_skb;
+    void *msg_head;
 
-    /*
-     * Generic Netlink is smart enough and sends a NLMSG_ERR reply automatically as reply
-     * Quote from https://lwn.net/Articles/208755/:
-     *  "The 'doit' handler should do whatever processing is necessary and return
-     *   zero on success, or a negative value on failure.  Negative return values
-     *   will cause a NLMSG_ERROR message to be sent while a zero return value will
-     *   only cause a NLMSG_ERROR message to be sent if the request is received with
-     *   the NLM_F_ACK flag set."
-     *
-     * You can find this in Linux code here:
-     * https://elixir.bootlin.com/linux/v5.11/source/net/netlink/af_netlink.c#L2499
-     *
-     * One can find more information about NLMSG_ERROR responses and how to handle them
-     * in userland in the manpage: https://man7.org/linux/man-pages/man7/netlink.7.html
-     */
-    return -EINVAL;
+    reply_skb = gnl_foobar_xmpl_reply_alloc(nla_total_size(nla_len(na)));
+    if (reply_skb == NULL) {
+        return ERR_PTR(-ENOMEM);
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(net), portid, seq,
+                                         GNL_FOOBAR_XMPL_C_ECHO_MSG);
+    if (msg_head == NULL || nla_put(reply_skb, GNL_FOOBAR_XMPL_A_DATA, nla_len(na), nla_data(na)) != 0) {
+        nlmsg_free(reply_skb);
+        return ERR_PTR(-EMSGSIZE);
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return reply_skb;
 }
 
 /**
- * Called before a dump with `gnl_cb_echo_dumpit()` starts.
- * See where this is assigned in `struct genl_ops gnl_foobar_xmpl_ops[]` as
- * `.start` callback for more comments.
+ * Echoes the `GNL_FOOBAR_XMPL_A_DATA` attribute `na` back to the sender of the request. Uses the
+ * zero-copy path for large payloads and falls back to a regular copy otherwise.
  *
  * @return success (0) or error.
  */
-int	gnl_cb_echo_dumpit_before(struct netlink_callback *cb) {
-    int ret;
-    static int unsigned const dump_runs = 3;
-    pr_info("%s: dump started. acquire lock. initialize dump runs_to_go (number of receives userland can make) to %d runs\n", __func__, dump_runs);
-    // Lock the mutex like mutex_lock(), and return 0 if the mutex has been acquired or sleep until the mutex becomes available
-    // If a signal arrives while waiting for the lock then this function returns -EINTR.
-    ret = mutex_lock_interruptible(&dumpit_cb_progress_data.mtx);
-    if (ret != 0) {
-        pr_err("Failed to get lock!\n");
-        return ret;
+static int gnl_echo_data_reply(struct genl_info *info, const struct nlattr *na) {
+    struct sk_buff *reply_skb;
+
+    reply_skb = gnl_echo_data_build_zerocopy_reply(genl_info_net(info), info->snd_portid, info->snd_seq + 1, na);
+    if (reply_skb == NULL) {
+        reply_skb = gnl_echo_data_build_copy_reply(genl_info_net(info), info->snd_portid, info->snd_seq + 1, na);
     }
-    dumpit_cb_progress_data.total_runs = dump_runs;
-    dumpit_cb_progress_data.runs_to_go = dump_runs;
-    return 0;
+    if (IS_ERR(reply_skb)) {
+        pr_err("An error occurred in %s(): %li\n", __func__, PTR_ERR(reply_skb));
+        NL_SET_ERR_MSG_ATTR(info->extack, na, "failed to build the echo reply for this payload");
+        return PTR_ERR(reply_skb);
+    }
+
+    // consumes the skb, also on failure
+    return genlmsg_reply(reply_skb, info);
+}
 
+static void gnl_foobar_xmpl_port_release(struct kref *ref) {
+    kfree(container_of(ref, struct gnl_foobar_xmpl_port, ref));
 }
 
 /**
- * Called before a dump with `gnl_cb_echo_dumpit()` starts.
+ * Returns the accounting of `portid` with an additional reference. Creates it with the first dump of
+ * the socket.
+ *
+ * @return NULL on failure or the accounting of `portid`.
+ */
+static struct gnl_foobar_xmpl_port *gnl_foobar_xmpl_port_get(struct gnl_foobar_xmpl_net *xn, u32 portid) {
+    struct gnl_foobar_xmpl_port *p;
+
+    mutex_lock(&xn->port_mtx);
+    list_for_each_entry(p, &xn->ports, node) {
+        if (p->portid == portid) {
+            goto out;
+        }
+    }
+    p = kzalloc(sizeof(*p), GFP_KERNEL);
+    if (p == NULL) {
+        mutex_unlock(&xn->port_mtx);
+        return NULL;
+    }
+    p->portid = portid;
+    // the reference of the list
+    kref_init(&p->ref);
+    list_add_tail(&p->node, &xn->ports);
+out:
+    kref_get(&p->ref);
+    mutex_unlock(&xn->port_mtx);
+    return p;
+}
+
+/**
+ * Ends the accounting of `portid` if there is one. Running dumps of the socket keep theirs until they are done.
+ */
+static void gnl_foobar_xmpl_port_remove(struct gnl_foobar_xmpl_net *xn, u32 portid) {
+    struct gnl_foobar_xmpl_port *p, *found = NULL;
+
+    mutex_lock(&xn->port_mtx);
+    list_for_each_entry(p, &xn->ports, node) {
+        if (p->portid == portid) {
+            list_del(&p->node);
+            found = p;
+            break;
+        }
+    }
+    mutex_unlock(&xn->port_mtx);
+    if (found != NULL) {
+        kref_put(&found->ref, gnl_foobar_xmpl_port_release);
+    }
+}
+
+/**
+ * Counts a dump of user `uid` if the user has less than `max_in_flight` (0: unlimited) dumps running.
+ *
+ * @return the owner or NULL if the user is at the limit or on failure (`*rc`).
+ */
+static struct gnl_foobar_xmpl_owner *gnl_foobar_xmpl_owner_get(kuid_t uid, u32 max_in_flight, int *rc) {
+    struct gnl_foobar_xmpl_owner *o;
+
+    mutex_lock(&gnl_foobar_xmpl_owners_mtx);
+    list_for_each_entry(o, &gnl_foobar_xmpl_owners, node) {
+        if (uid_eq(o->uid, uid)) {
+            goto out;
+        }
+    }
+    o = kzalloc(sizeof(*o), GFP_KERNEL);
+    if (o == NULL) {
+        *rc = -ENOMEM;
+        goto unlock;
+    }
+    o->uid = uid;
+    list_add_tail(&o->node, &gnl_foobar_xmpl_owners);
+out:
+    if (max_in_flight != 0 && o->dumps_in_flight >= max_in_flight) {
+        *rc = -EBUSY;
+        o = NULL;
+    } else {
+        o->dumps_in_flight++;
+    }
+unlock:
+    mutex_unlock(&gnl_foobar_xmpl_owners_mtx);
+    return o;
+}
+
+/**
+ * Counterpart of `gnl_foobar_xmpl_owner_get()`; frees the owner with its last dump.
+ */
+static void gnl_foobar_xmpl_owner_put(struct gnl_foobar_xmpl_owner *o) {
+    mutex_lock(&gnl_foobar_xmpl_owners_mtx);
+    if (--o->dumps_in_flight == 0) {
+        list_del(&o->node);
+        kfree(o);
+    }
+    mutex_unlock(&gnl_foobar_xmpl_owners_mtx);
+}
+
+/**
+ * Admits a dump; the `.start` callbacks of all dumps call this first. A dump beyond the tunable
+ * "dump_max_in_flight" for its user is rejected before it does any work. Otherwise the dump runs
+ * (and holds a reference on the accounting of its socket) until `gnl_foobar_xmpl_dump_release()`.
+ * The quotas are read once; a running dump keeps them even if the tunables change.
+ *
+ * @return success (0) or error.
+ */
+static int gnl_foobar_xmpl_dump_admit(struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(sock_net(cb->skb->sk));
+    const struct gnl_foobar_xmpl_config *cfg;
+    struct gnl_foobar_xmpl_owner *o;
+    struct gnl_foobar_xmpl_port *p;
+    u32 max_in_flight, max_records;
+    int rc = 0;
+
+    rcu_read_lock();
+    cfg = rcu_dereference(gnl_foobar_xmpl_config);
+    max_in_flight = cfg->dump_max_in_flight;
+    max_records = cfg->dump_max_records;
+    rcu_read_unlock();
+
+    p = gnl_foobar_xmpl_port_get(xn, NETLINK_CB(cb->skb).portid);
+    if (p == NULL) {
+        return -ENOMEM;
+    }
+    // the credentials of the process that sent the request, see netlink_sendmsg()
+    o = gnl_foobar_xmpl_owner_get(NETLINK_CB(cb->skb).creds.uid, max_in_flight, &rc);
+    if (o == NULL) {
+        if (rc == -EBUSY) {
+            atomic64_inc(&p->dumps_rejected);
+            NL_SET_ERR_MSG(cb->extack, "too many dumps of this user in flight; try again later");
+        }
+        kref_put(&p->ref, gnl_foobar_xmpl_port_release);
+        return rc;
+    }
+    atomic64_inc(&p->dumps);
+    cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_OWNER] = (long) o;
+    cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_MAX_RECORDS] = max_records != 0 ? max_records : LONG_MAX;
+    cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_PORT] = (long) p;
+    return 0;
+}
+
+/**
+ * Counterpart of `gnl_foobar_xmpl_dump_admit()`; the `.done` callbacks of all dumps call this last.
+ */
+static void gnl_foobar_xmpl_dump_release(struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_owner *o = (struct gnl_foobar_xmpl_owner *) cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_OWNER];
+    struct gnl_foobar_xmpl_port *p = (struct gnl_foobar_xmpl_port *) cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_PORT];
+
+    gnl_foobar_xmpl_owner_put(o);
+    kref_put(&p->ref, gnl_foobar_xmpl_port_release);
+}
+
+/**
+ * Max. number of records that a run of the dump may write into its skb. The rest is deferred to the
+ * next run, i.e. the next receive of the client. In between, the CPU is free for other requests.
+ */
+static long gnl_foobar_xmpl_dump_max_records(const struct netlink_callback *cb) {
+    return cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_MAX_RECORDS];
+}
+
+/**
+ * Accounts one run of a dump that wrote `records` records. `deferred` tells that the run stopped at
+ * the records quota although more records were due.
+ */
+static void gnl_foobar_xmpl_dump_account(struct netlink_callback *cb, long records, bool deferred) {
+    struct gnl_foobar_xmpl_port *p = (struct gnl_foobar_xmpl_port *) cb->args[GNL_FOOBAR_XMPL_DUMP_ARG_PORT];
+
+    atomic64_inc(&p->dump_runs);
+    atomic64_add(records, &p->dump_records);
+    if (deferred) {
+        atomic64_inc(&p->dump_runs_deferred);
+    }
+}
+
+/**
+ * Writes one record of the echo dump into `skb`. Separated from `gnl_cb_echo_dumpit()` so that
+ * filling a record doesn't depend on a `struct netlink_callback` or the dump progress.
+ *
+ * @return success (0) or error (e.g. -EMSGSIZE if `skb` is full).
+ */
+static int gnl_echo_dumpit_fill(struct sk_buff *skb, struct net *net, u32 portid, u32 seq) {
+    static const char HELLO_FROM_DUMPIT_MSG[] = "You set the flag NLM_F_DUMP; this message is "
+                                                "brought to you by .dumpit callback :)";
+    void *msg_head;
+
+    msg_head = genlmsg_put(skb, // buffer for netlink message: struct sk_buff *
+                           portid, // sending port (not process) id: int
+                           seq, // sequence number: int
+                           &gnl_foobar_xmpl_family, // struct genl_family *
+                           0, // flags: int (for netlink header); we don't check them in the userland; application specific
+            // this way we can trigger a specific command/callback on the receiving side or imply
+            // on which type of command we are currently answering; this is application specific
+                           GNL_FOOBAR_XMPL_C_ECHO_MSG // cmd: u8 (for generic netlink header);
+    );
+    if (msg_head == NULL) {
+        return -EMSGSIZE;
+    }
+    if (gnl_foobar_xmpl_put_generation(skb, gnl_foobar_xmpl_generation(net)) != 0 ||
+        nla_put_string(skb, GNL_FOOBAR_XMPL_A_MSG, HELLO_FROM_DUMPIT_MSG) != 0) {
+        genlmsg_cancel(skb, msg_head);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(skb, msg_head);
+    return 0;
+}
+
+/**
+ * ".dumpit"-callback function if a Generic Netlink with command ECHO_MSG and flag `NLM_F_DUMP` is received.
+ * Please look into the comments where this is used as ".dumpit" callback above in
+ * `struct genl_ops gnl_foobar_xmpl_ops[]` for more information about ".dumpit" callbacks.
+ *
+ * A dump must be understand of "give me all data of a given entity"
+ * rather than a "dump of the netlink message itself" for debugging etc!
+ *
+ * This handler requires `gnl_cb_echo_dumpit_before` to run before a dump and `gnl_cb_echo_dumpit_after` after a dump.
+ *
+ * For the sake of simplicity, we use the ECHO_MSG command for the dump. In fact, we don't expect a
+ * MSG-Attribute here, unlike the regular ECHO_MSG handler. We reply with a dump of
+ * "all messages that we got" (application specific, hard coded in this example).
+*/
+int gnl_cb_echo_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb) {
+    // progress of this dump, see `gnl_cb_echo_dumpit_before()`
+    const long total_records = cb->args[0];
+    const long max_records = gnl_foobar_xmpl_dump_max_records(cb);
+    long records = 0;
+    int ret;
+    pr_info_verbose("Called %s()\n", __func__);
+
+    if (cb->args[1] == 0) {
+        pr_info_verbose("no more data to send in dumpit cb\n");
+        // mark that dump is done;
+        return 0;
+    }
+
+    // as many records as fit into the skb, but not more than the quota allows
+    while (cb->args[1] > 0 && records < max_records) {
+        ret = gnl_echo_dumpit_fill(pre_allocated_skb, sock_net(cb->skb->sk),
+                // According to my findings: this is not used for routing
+                // This can be used in an application specific way to target
+                // different endpoints within the same user application
+                // but general rule: just put sender port id here
+                                   cb->nlh->nlmsg_pid,
+                // sequence number: int (might be used by receiver, but not mandatory)
+                // sequence 0, 1, 2...
+                                   total_records - cb->args[1]);
+        if (ret < 0) {
+            if (records > 0) {
+                // the skb is full; the next run continues
+                break;
+            }
+            pr_info("An error occurred in %s(): %i\n", __func__, ret);
+            return ret;
+        }
+        cb->args[1]--;
+        records++;
+    }
+    pr_info_verbose("%s: %ld records in this run, %ld more to do\n", __func__, records, cb->args[1]);
+    gnl_foobar_xmpl_dump_account(cb, records, records == max_records && cb->args[1] > 0);
+
+    // return the length of data we wrote into the pre-allocated buffer
+    return pre_allocated_skb->len;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR` is received.
+ * Please look into the comments where this is used as ".doit" callback above in
+ * `struct genl_ops gnl_foobar_xmpl_ops[]` for more information about ".doit" callbacks.
+*/
+int gnl_cb_doit_reply_with_nlmsg_err(struct sk_buff *sender_skb, struct genl_info *info) {
+    pr_info_verbose("%s() invoked, a NLMSG_ERR response will be sent back\n", __func__);
+
+    /*
+     * Generic Netlink is smart enough and sends a NLMSG_ERR reply automatically as reply
+     * Quote from https://lwn.net/Articles/208755/:
+     *  "The 'doit' handler should do whatever processing is necessary and return
+     *   zero on success, or a negative value on failure.  Negative return values
+     *   will cause a NLMSG_ERROR message to be sent while a zero return value will
+     *   only cause a NLMSG_ERROR message to be sent if the request is received with
+     *   the NLM_F_ACK flag set."
+     *
+     * You can find this in Linux code here:
+     * https://elixir.bootlin.com/linux/v5.11/source/net/netlink/af_netlink.c#L2499
+     *
+     * One can find more information about NLMSG_ERROR responses and how to handle them
+     * in userland in the manpage: https://man7.org/linux/man-pages/man7/netlink.7.html
+     *
+     * With "extended ACKs" we can tell the userland what went wrong: a message and the attribute
+     * that caused the error. The kernel appends them as NLMSGERR_ATTR_MSG and NLMSGERR_ATTR_OFFS
+     * (offset of the attribute inside the request) to the NLMSG_ERROR reply, if the userland
+     * socket has NETLINK_EXT_ACK set. Without the attribute in the request only the message is reported.
+     */
+    NL_SET_ERR_MSG_ATTR(info->extack, info->attrs[GNL_FOOBAR_XMPL_A_MSG],
+                        "GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR always fails (on purpose)");
+    return -EINVAL;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_PING` is received.
+ * Replies with the timestamp of the client and two kernel timestamps: one taken at the entry of this
+ * handler and one taken right before the reply is handed to the socket layer. `ktime_get_ns()` is
+ * CLOCK_MONOTONIC, hence the userland can compute the one-way delays of both legs.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_ping_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    // as early as possible; everything below counts as service time
+    const u64 rx_ts = ktime_get_ns();
+    struct nlattr *na = info->attrs[GNL_FOOBAR_XMPL_A_CLIENT_TS];
+    struct sk_buff *reply_skb;
+    struct nlattr *tx_na;
+    void *msg_head;
+
+    if (na == NULL) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_CLIENT_TS");
+        return -EINVAL;
+    }
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(3 * nla_total_size_64bit(sizeof(u64)));
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_PING);
+    if (msg_head == NULL ||
+        nla_put_u64_64bit(reply_skb, GNL_FOOBAR_XMPL_A_CLIENT_TS, nla_get_u64(na), GNL_FOOBAR_XMPL_A_PAD) ||
+        nla_put_u64_64bit(reply_skb, GNL_FOOBAR_XMPL_A_KERNEL_RX_TS, rx_ts, GNL_FOOBAR_XMPL_A_PAD)) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    // only reserved here; the value is written right before sending
+    tx_na = nla_reserve_64bit(reply_skb, GNL_FOOBAR_XMPL_A_KERNEL_TX_TS, sizeof(u64), GNL_FOOBAR_XMPL_A_PAD);
+    if (tx_na == NULL) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(reply_skb, msg_head);
+
+    *(u64 *) nla_data(tx_na) = ktime_get_ns();
+    return genlmsg_reply(reply_skb, info);
+}
+
+static void gnl_foobar_xmpl_xfer_release(struct kref *ref) {
+    struct gnl_foobar_xmpl_xfer *x = container_of(ref, struct gnl_foobar_xmpl_xfer, ref);
+
+    atomic64_sub(x->size, &gnl_foobar_xmpl_xfer_bytes);
+    kvfree(x->buf);
+    kfree(x);
+}
+
+/**
+ * Looks up the transfer with the id in `info->attrs[GNL_FOOBAR_XMPL_A_XFER_ID]`. The caller must hold
+ * `xn->xfer_mtx`. Reports missing attributes and unknown ids via the extended ACK.
+ *
+ * @return the transfer or NULL
+ */
+static struct gnl_foobar_xmpl_xfer *gnl_foobar_xmpl_xfer_find(struct gnl_foobar_xmpl_net *xn,
+                                                              struct nlattr **attrs,
+                                                              struct netlink_ext_ack *extack) {
+    struct nlattr *na = attrs[GNL_FOOBAR_XMPL_A_XFER_ID];
+    struct gnl_foobar_xmpl_xfer *x;
+
+    if (na == NULL) {
+        NL_SET_ERR_MSG(extack, "missing attribute GNL_FOOBAR_XMPL_A_XFER_ID");
+        return NULL;
+    }
+    x = idr_find(&xn->xfers, nla_get_u32(na));
+    if (x == NULL) {
+        NL_SET_ERR_MSG_ATTR(extack, na, "unknown transfer");
+    }
+    return x;
+}
+
+/**
+ * `gnl_foobar_xmpl_xfer_find()` for requests that change or delete a transfer: only the socket that
+ * started it may send them. The caller must hold `xn->xfer_mtx`.
+ *
+ * @return the transfer or an ERR_PTR
+ */
+static struct gnl_foobar_xmpl_xfer *gnl_foobar_xmpl_xfer_find_own(struct gnl_foobar_xmpl_net *xn,
+                                                                  struct genl_info *info) {
+    struct gnl_foobar_xmpl_xfer *x = gnl_foobar_xmpl_xfer_find(xn, info->attrs, info->extack);
+
+    if (x == NULL) {
+        return ERR_PTR(-ENOENT);
+    }
+    if (x->portid != info->snd_portid) {
+        NL_SET_ERR_MSG_ATTR(info->extack, info->attrs[GNL_FOOBAR_XMPL_A_XFER_ID],
+                            "transfer belongs to another socket");
+        return ERR_PTR(-EPERM);
+    }
+    return x;
+}
+
+/**
+ * Deletes all transfers that the socket `portid` started, committed or not, e.g. when it is closed.
+ * Running downloads keep their objects until they are done.
+ */
+static void gnl_foobar_xmpl_xfer_remove_port(struct net *net, u32 portid) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(net);
+    struct gnl_foobar_xmpl_xfer *x;
+    bool removed_committed = false;
+    int id;
+
+    mutex_lock(&xn->xfer_mtx);
+    idr_for_each_entry(&xn->xfers, x, id) {
+        if (x->portid != portid) {
+            continue;
+        }
+        idr_remove(&xn->xfers, id);
+        removed_committed |= x->committed;
+        kref_put(&x->ref, gnl_foobar_xmpl_xfer_release);
+    }
+    mutex_unlock(&xn->xfer_mtx);
+    if (removed_committed) {
+        // `GNL_FOOBAR_XMPL_C_XFER_GET` doesn't find them anymore
+        gnl_foobar_xmpl_generation_bump(net, GFP_KERNEL);
+    }
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_XFER_BEGIN` is received.
+ * Reserves and allocates the buffer for the whole object and replies with its id. `GENL_UNS_ADMIN_PERM`
+ * restricts uploads to CAP_NET_ADMIN in the namespace; the object belongs to the sending socket.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_xfer_begin_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct nlattr *na = info->attrs[GNL_FOOBAR_XMPL_A_XFER_SIZE];
+    struct gnl_foobar_xmpl_xfer *x;
+    struct sk_buff *reply_skb;
+    void *msg_head;
+    u64 size;
+    int rc;
+
+    if (na == NULL) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_XFER_SIZE");
+        return -EINVAL;
+    }
+    size = nla_get_u64(na);
+    if (size == 0 || size > xfer_max_bytes) {
+        NL_SET_ERR_MSG_ATTR(info->extack, na, "size must be between 1 and the module parameter xfer_max_bytes");
+        return -EINVAL;
+    }
+    // reserve first; concurrent requests must not exceed the limit together
+    if (atomic64_add_return(size, &gnl_foobar_xmpl_xfer_bytes) > xfer_max_bytes) {
+        atomic64_sub(size, &gnl_foobar_xmpl_xfer_bytes);
+        NL_SET_ERR_MSG_ATTR(info->extack, na, "not enough space left for transfers (xfer_max_bytes)");
+        return -ENOSPC;
+    }
+
+    x = kzalloc(sizeof(*x), GFP_KERNEL);
+    if (x != NULL) {
+        x->buf = kvmalloc(size, GFP_KERNEL);
+    }
+    if (x == NULL || x->buf == NULL) {
+        kfree(x);
+        atomic64_sub(size, &gnl_foobar_xmpl_xfer_bytes);
+        return -ENOMEM;
+    }
+    kref_init(&x->ref);
+    x->portid = info->snd_portid;
+    x->size = size;
+
+    mutex_lock(&xn->xfer_mtx);
+    rc = idr_alloc_cyclic(&xn->xfers, x, 1, 0, GFP_KERNEL);
+    mutex_unlock(&xn->xfer_mtx);
+    if (rc < 0) {
+        kref_put(&x->ref, gnl_foobar_xmpl_xfer_release);
+        return rc;
+    }
+    x->id = rc;
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(2 * nla_total_size(sizeof(u32)));
+    if (reply_skb == NULL) {
+        rc = -ENOMEM;
+        goto err_remove;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_XFER_BEGIN);
+    if (msg_head == NULL ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_XFER_ID, x->id) ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_XFER_WINDOW, gnl_foobar_xmpl_config_get(xfer_window))) {
+        nlmsg_free(reply_skb);
+        rc = -EMSGSIZE;
+        goto err_remove;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+
+err_remove:
+    // nobody knows the id yet
+    mutex_lock(&xn->xfer_mtx);
+    idr_remove(&xn->xfers, x->id);
+    mutex_unlock(&xn->xfer_mtx);
+    kref_put(&x->ref, gnl_foobar_xmpl_xfer_release);
+    return rc;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_XFER_CHUNK` is received.
+ * Copies the chunk into the buffer of the transfer. Netlink delivers the messages of a socket in
+ * order, hence requiring the chunks in order costs pipelined clients nothing and makes the
+ * reassembly trivial: no bookkeeping of holes or overlaps.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_xfer_chunk_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct nlattr *offset_na = info->attrs[GNL_FOOBAR_XMPL_A_XFER_OFFSET];
+    struct nlattr *data_na = info->attrs[GNL_FOOBAR_XMPL_A_DATA];
+    struct gnl_foobar_xmpl_xfer *x;
+    int rc = 0;
+
+    if (offset_na == NULL || data_na == NULL) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_XFER_OFFSET or GNL_FOOBAR_XMPL_A_DATA");
+        return -EINVAL;
+    }
+
+    mutex_lock(&xn->xfer_mtx);
+    x = gnl_foobar_xmpl_xfer_find_own(xn, info);
+    if (IS_ERR(x)) {
+        rc = PTR_ERR(x);
+    } else if (x->committed) {
+        GENL_SET_ERR_MSG(info, "transfer is already committed");
+        rc = -EBUSY;
+    } else if (nla_get_u64(offset_na) != x->received) {
+        NL_SET_ERR_MSG_ATTR(info->extack, offset_na, "chunks must be sent in order; offset is not the received size");
+        rc = -EINVAL;
+    } else if (nla_len(data_na) > x->size - x->received) {
+        NL_SET_ERR_MSG_ATTR(info->extack, data_na, "chunk exceeds the size of the transfer");
+        rc = -EINVAL;
+    } else {
+        memcpy(x->buf + x->received, nla_data(data_na), nla_len(data_na));
+        x->received += nla_len(data_na);
+    }
+    mutex_unlock(&xn->xfer_mtx);
+    return rc;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_XFER_COMMIT` is received.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_xfer_commit_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct gnl_foobar_xmpl_xfer *x;
+    int rc = 0;
+
+    mutex_lock(&xn->xfer_mtx);
+    x = gnl_foobar_xmpl_xfer_find_own(xn, info);
+    if (IS_ERR(x)) {
+        rc = PTR_ERR(x);
+    } else if (x->received != x->size) {
+        GENL_SET_ERR_MSG(info, "transfer is incomplete");
+        rc = -EINVAL;
+    } else {
+        x->committed = true;
+    }
+    mutex_unlock(&xn->xfer_mtx);
+    if (rc == 0) {
+        // the object is visible to `GNL_FOOBAR_XMPL_C_XFER_GET` from now on
+        gnl_foobar_xmpl_generation_bump(genl_info_net(info), GFP_KERNEL);
+    }
+    return rc;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_XFER_ABORT` is received.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_xfer_abort_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct gnl_foobar_xmpl_xfer *x;
+
+    mutex_lock(&xn->xfer_mtx);
+    x = gnl_foobar_xmpl_xfer_find_own(xn, info);
+    if (!IS_ERR(x)) {
+        idr_remove(&xn->xfers, x->id);
+    }
+    mutex_unlock(&xn->xfer_mtx);
+    if (IS_ERR(x)) {
+        return PTR_ERR(x);
+    }
+    // the buffer is freed now or when the last download completes
+    kref_put(&x->ref, gnl_foobar_xmpl_xfer_release);
+    gnl_foobar_xmpl_generation_bump(genl_info_net(info), GFP_KERNEL);
+    return 0;
+}
+
+/**
+ * Called before a download with `gnl_cb_xfer_get_dumpit()` starts. Takes a reference on the
+ * transfer, which is stored with the current offset and the generation of all records in
+ * `cb->args[]` for all runs of the dump.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_xfer_get_dumpit_start(struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(sock_net(cb->skb->sk));
+    struct nlattr *attrs[GNL_FOOBAR_XMPL_A_MAX + 1];
+    struct gnl_foobar_xmpl_xfer *x;
+    u64 generation, offset = 0;
+    int rc;
+
+    rc = gnl_foobar_xmpl_dump_admit(cb);
+    if (rc < 0) {
+        return rc;
+    }
+    // dumps don't get parsed attributes (`struct genl_info`) on all kernels we support
+    rc = nlmsg_parse_deprecated(cb->nlh, GENL_HDRLEN, attrs, GNL_FOOBAR_XMPL_A_MAX, gnl_foobar_xmpl_policy,
+                                cb->extack);
+    if (rc < 0) {
+        gnl_foobar_xmpl_dump_release(cb);
+        return rc;
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_XFER_OFFSET] != NULL) {
+        offset = nla_get_u64(attrs[GNL_FOOBAR_XMPL_A_XFER_OFFSET]);
+    }
+
+    // before the lookup: an abort in between must not make the records of the deleted object look current
+    generation = gnl_foobar_xmpl_generation(sock_net(cb->skb->sk));
+    mutex_lock(&xn->xfer_mtx);
+    x = gnl_foobar_xmpl_xfer_find(xn, attrs, cb->extack);
+    if (x == NULL) {
+        rc = -ENOENT;
+    } else if (!x->committed) {
+        NL_SET_ERR_MSG(cb->extack, "transfer is not committed yet");
+        rc = -EBUSY;
+    } else if (offset > x->size) {
+        NL_SET_ERR_MSG_ATTR(cb->extack, attrs[GNL_FOOBAR_XMPL_A_XFER_OFFSET], "offset exceeds the size of the transfer");
+        rc = -EINVAL;
+    } else {
+        kref_get(&x->ref);
+        cb->args[0] = (long) x;
+        cb->args[1] = offset;
+        cb->args[2] = generation;
+    }
+    mutex_unlock(&xn->xfer_mtx);
+    if (rc < 0) {
+        // `.done` is only called for dumps that started
+        gnl_foobar_xmpl_dump_release(cb);
+    }
+    return rc;
+}
+
+/**
+ * ".dumpit"-callback of `GNL_FOOBAR_XMPL_C_XFER_GET`. Fills the skb with as many and as large chunks
+ * as fit and the records quota allows. The object is committed, hence its buffer is read without the lock.
+ *
+ * @return length of the filled skb or 0 when the download is complete.
+ */
+int gnl_cb_xfer_get_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_xfer *x = (struct gnl_foobar_xmpl_xfer *) cb->args[0];
+    // everything in a record except the payload of the chunk
+    const int overhead = nlmsg_total_size(GENL_HDRLEN + nla_total_size(sizeof(u32)) +
+                                          2 * nla_total_size_64bit(sizeof(u64)) + nla_total_size(0));
+    const long max_records = gnl_foobar_xmpl_dump_max_records(cb);
+    u64 offset = cb->args[1];
+    long records = 0;
+
+    while (offset < x->size && records < max_records) {
+        int room = skb_tailroom(pre_allocated_skb) - overhead;
+        u32 len;
+        struct nlattr *na;
+        void *msg_head;
+
+        if (room < NLA_ALIGNTO) {
+            break;
+        }
+        len = min_t(u64, x->size - offset, room & ~(NLA_ALIGNTO - 1));
+        msg_head = genlmsg_put(pre_allocated_skb, NETLINK_CB(cb->skb).portid, cb->nlh->nlmsg_seq,
+                               &gnl_foobar_xmpl_family, NLM_F_MULTI, GNL_FOOBAR_XMPL_C_XFER_GET);
+        if (msg_head == NULL) {
+            break;
+        }
+        if (gnl_foobar_xmpl_put_generation(pre_allocated_skb, cb->args[2]) ||
+            nla_put_u32(pre_allocated_skb, GNL_FOOBAR_XMPL_A_XFER_ID, x->id) ||
+            nla_put_u64_64bit(pre_allocated_skb, GNL_FOOBAR_XMPL_A_XFER_OFFSET, offset, GNL_FOOBAR_XMPL_A_PAD) ||
+            (na = nla_reserve(pre_allocated_skb, GNL_FOOBAR_XMPL_A_DATA, len)) == NULL) {
+            genlmsg_cancel(pre_allocated_skb, msg_head);
+            break;
+        }
+        memcpy(nla_data(na), x->buf + offset, len);
+        genlmsg_end(pre_allocated_skb, msg_head);
+        offset += len;
+        records++;
+    }
+    cb->args[1] = offset;
+    gnl_foobar_xmpl_dump_account(cb, records, records == max_records && offset < x->size);
+    return pre_allocated_skb->len;
+}
+
+/**
+ * Called after the download has completed or was interrupted; drops the references of the dump.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_xfer_get_dumpit_done(struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_xfer *x = (struct gnl_foobar_xmpl_xfer *) cb->args[0];
+
+    if (x != NULL) {
+        kref_put(&x->ref, gnl_foobar_xmpl_xfer_release);
+    }
+    gnl_foobar_xmpl_dump_release(cb);
+    return 0;
+}
+
+static void gnl_foobar_xmpl_ring_release(struct kref *ref) {
+    struct gnl_foobar_xmpl_ring *r = container_of(ref, struct gnl_foobar_xmpl_ring, ref);
+
+    atomic64_sub(r->mmap_len, &gnl_foobar_xmpl_ring_bytes);
+    vfree(r->mem);
+    mutex_destroy(&r->mtx);
+    kfree(r);
+}
+
+/**
+ * Looks up the ring with the id in `info->attrs[GNL_FOOBAR_XMPL_A_RING_ID]` that the sending socket
+ * created. Reports missing attributes, unknown ids and foreign rings via the extended ACK. Takes a
+ * reference on it; with `remove`, it takes over the reference of `xn->rings` instead.
+ *
+ * @return the ring or an ERR_PTR
+ */
+static struct gnl_foobar_xmpl_ring *gnl_foobar_xmpl_ring_get(struct gnl_foobar_xmpl_net *xn,
+                                                             struct genl_info *info,
+                                                             bool remove) {
+    struct nlattr *na = info->attrs[GNL_FOOBAR_XMPL_A_RING_ID];
+    struct gnl_foobar_xmpl_ring *r;
+    int rc = 0;
+
+    if (na == NULL) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_RING_ID");
+        return ERR_PTR(-EINVAL);
+    }
+    mutex_lock(&xn->ring_mtx);
+    r = idr_find(&xn->rings, nla_get_u32(na));
+    if (r == NULL) {
+        NL_SET_ERR_MSG_ATTR(info->extack, na, "unknown ring");
+        rc = -ENOENT;
+    } else if (r->portid != info->snd_portid) {
+        NL_SET_ERR_MSG_ATTR(info->extack, na, "ring belongs to another socket");
+        rc = -EPERM;
+    } else if (remove) {
+        idr_remove(&xn->rings, r->id);
+    } else {
+        kref_get(&r->ref);
+    }
+    mutex_unlock(&xn->ring_mtx);
+    return rc != 0 ? ERR_PTR(rc) : r;
+}
+
+/**
+ * Destroys all rings that the socket `portid` created, e.g. when it is closed. Mapped memory stays
+ * valid until it is unmapped.
+ */
+static void gnl_foobar_xmpl_ring_remove_port(struct net *net, u32 portid) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(net);
+    struct gnl_foobar_xmpl_ring *r;
+    bool removed = false;
+    int id;
+
+    mutex_lock(&xn->ring_mtx);
+    idr_for_each_entry(&xn->rings, r, id) {
+        if (r->portid != portid) {
+            continue;
+        }
+        idr_remove(&xn->rings, id);
+        kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+        removed = true;
+    }
+    mutex_unlock(&xn->ring_mtx);
+    if (removed) {
+        gnl_foobar_xmpl_generation_bump(net, GFP_KERNEL);
+    }
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_RING_CREATE` is received.
+ * Allocates the ring and replies with its id and geometry; the userland maps it afterwards.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_ring_create_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct nlattr *entries_na = info->attrs[GNL_FOOBAR_XMPL_A_RING_ENTRIES];
+    struct nlattr *slot_size_na = info->attrs[GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE];
+    struct gnl_foobar_xmpl_ring_hdr *hdr;
+    struct gnl_foobar_xmpl_ring *r;
+    struct sk_buff *reply_skb;
+    void *msg_head;
+    u32 entries, slot_size, sq_off, cq_off;
+    size_t mmap_len;
+    int rc;
+
+    if (entries_na == NULL || slot_size_na == NULL) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_RING_ENTRIES or GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE");
+        return -EINVAL;
+    }
+    entries = nla_get_u32(entries_na);
+    slot_size = nla_get_u32(slot_size_na);
+    if (!is_power_of_2(entries) || entries > GNL_FOOBAR_XMPL_RING_MAX_ENTRIES) {
+        NL_SET_ERR_MSG_ATTR(info->extack, entries_na, "entries must be a power of two <= GNL_FOOBAR_XMPL_RING_MAX_ENTRIES");
+        return -EINVAL;
+    }
+    if (slot_size < GNL_FOOBAR_XMPL_RING_MIN_SLOT_SIZE || slot_size > GNL_FOOBAR_XMPL_RING_MAX_SLOT_SIZE ||
+        slot_size % GNL_FOOBAR_XMPL_RING_MIN_SLOT_SIZE != 0) {
+        NL_SET_ERR_MSG_ATTR(info->extack, slot_size_na, "slot size must be a multiple of 64 between 64 and 64 KiB");
+        return -EINVAL;
+    }
+    // both queues after the header; the limits above keep this far below 4 GiB
+    sq_off = GNL_FOOBAR_XMPL_RING_SQ_OFF;
+    cq_off = sq_off + entries * slot_size;
+    mmap_len = PAGE_ALIGN((size_t) cq_off + entries * slot_size);
+
+    // reserve first; concurrent requests must not exceed the limit together
+    if (atomic64_add_return(mmap_len, &gnl_foobar_xmpl_ring_bytes) > ring_max_bytes) {
+        atomic64_sub(mmap_len, &gnl_foobar_xmpl_ring_bytes);
+        GENL_SET_ERR_MSG(info, "not enough space left for rings (ring_max_bytes)");
+        return -ENOSPC;
+    }
+    r = kzalloc(sizeof(*r), GFP_KERNEL);
+    if (r != NULL) {
+        r->mem = vmalloc_user(mmap_len);
+    }
+    if (r == NULL || r->mem == NULL) {
+        kfree(r);
+        atomic64_sub(mmap_len, &gnl_foobar_xmpl_ring_bytes);
+        return -ENOMEM;
+    }
+    kref_init(&r->ref);
+    mutex_init(&r->mtx);
+    r->portid = info->snd_portid;
+    r->uid = current_euid();
+    r->mmap_len = mmap_len;
+    r->entries = entries;
+    r->slot_size = slot_size;
+    hdr = r->mem;
+    hdr->entries = entries;
+    hdr->slot_size = slot_size;
+    hdr->sq_off = sq_off;
+    hdr->cq_off = cq_off;
+
+    mutex_lock(&xn->ring_mtx);
+    rc = idr_alloc_cyclic(&xn->rings, r, 1, 0, GFP_KERNEL);
+    mutex_unlock(&xn->ring_mtx);
+    if (rc < 0) {
+        kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+        return rc;
+    }
+    r->id = rc;
+    gnl_foobar_xmpl_generation_bump(genl_info_net(info), GFP_KERNEL);
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(3 * nla_total_size(sizeof(u32)) + nla_total_size_64bit(sizeof(u64)));
+    if (reply_skb == NULL) {
+        rc = -ENOMEM;
+        goto err_remove;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_RING_CREATE);
+    if (msg_head == NULL ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_RING_ID, r->id) ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_RING_ENTRIES, entries) ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE, slot_size) ||
+        nla_put_u64_64bit(reply_skb, GNL_FOOBAR_XMPL_A_RING_MMAP_LEN, mmap_len, GNL_FOOBAR_XMPL_A_PAD)) {
+        nlmsg_free(reply_skb);
+        rc = -EMSGSIZE;
+        goto err_remove;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+
+err_remove:
+    // the id is known, but nobody has it yet
+    mutex_lock(&xn->ring_mtx);
+    idr_remove(&xn->rings, r->id);
+    mutex_unlock(&xn->ring_mtx);
+    kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+    return rc;
+}
+
+/**
+ * Moves all records from the submission queue of the ring into its completion queue, as far as the
+ * completion queue has room. The caller must hold `r->mtx`.
+ *
+ * The userland writes the shared memory concurrently, hence every value from it is read once and
+ * checked before it is used: the indices against the size of the queues, the length of a record
+ * against the size of a slot.
+ *
+ * @return the number of posted completions or -EINVAL if the userland corrupted the indices.
+ */
+static int gnl_foobar_xmpl_ring_process(struct gnl_foobar_xmpl_ring *r) {
+    struct gnl_foobar_xmpl_ring_hdr *hdr = r->mem;
+    const u32 mask = r->entries - 1;
+    const u32 max_len = r->slot_size - sizeof(struct gnl_foobar_xmpl_ring_rec);
+    u8 *sq = (u8 *) r->mem + GNL_FOOBAR_XMPL_RING_SQ_OFF;
+    u8 *cq = sq + r->entries * r->slot_size;
+    // pairs with the store-release of the userland: the records up to the tail are complete
+    u32 sq_tail = smp_load_acquire(&hdr->sq_tail);
+    u32 cq_head = smp_load_acquire(&hdr->cq_head);
+    int completed = 0;
+
+    // the userland can't submit more than the queue holds or free more than was completed
+    if (sq_tail - r->sq_head > r->entries || r->cq_tail - cq_head > r->entries) {
+        return -EINVAL;
+    }
+    while (r->sq_head != sq_tail && r->cq_tail - cq_head < r->entries) {
+        const struct gnl_foobar_xmpl_ring_rec *sqe = (void *) (sq + (r->sq_head & mask) * r->slot_size);
+        struct gnl_foobar_xmpl_ring_rec *cqe = (void *) (cq + (r->cq_tail & mask) * r->slot_size);
+        u32 len = READ_ONCE(sqe->len);
+
+        cqe->user_data = READ_ONCE(sqe->user_data);
+        if (len > max_len) {
+            cqe->len = 0;
+            cqe->result = -EMSGSIZE;
+        } else {
+            memcpy(cqe->data, sqe->data, len);
+            cqe->len = len;
+            cqe->result = 0;
+            r->bytes += len;
+        }
+        r->sq_head++;
+        r->cq_tail++;
+        completed++;
+        // a full ring of large slots is a lot of copying
+        cond_resched();
+    }
+    r->records += completed;
+    // the completions must be visible before the new tail; the submissions are read before their slots are freed
+    smp_store_release(&hdr->cq_tail, r->cq_tail);
+    smp_store_release(&hdr->sq_head, r->sq_head);
+    return completed;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_RING_DOORBELL` is received.
+ * One doorbell processes a whole batch of records; the reply only carries their number, the
+ * payloads never pass through an skb.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_ring_doorbell_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct gnl_foobar_xmpl_ring *r;
+    struct sk_buff *reply_skb;
+    void *msg_head;
+    int completed;
+    u32 id;
+
+    r = gnl_foobar_xmpl_ring_get(xn, info, false);
+    if (IS_ERR(r)) {
+        return PTR_ERR(r);
+    }
+    mutex_lock(&r->mtx);
+    r->doorbells++;
+    completed = gnl_foobar_xmpl_ring_process(r);
+    mutex_unlock(&r->mtx);
+    id = r->id;
+    kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+    if (completed < 0) {
+        GENL_SET_ERR_MSG(info, "ring indices are corrupted");
+        return completed;
+    }
+    // the counters of `GNL_FOOBAR_XMPL_C_RING_STATS` changed
+    gnl_foobar_xmpl_generation_bump(genl_info_net(info), GFP_KERNEL);
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(2 * nla_total_size(sizeof(u32)));
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_RING_DOORBELL);
+    if (msg_head == NULL ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_RING_ID, id) ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_RING_COMPLETED, completed)) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_RING_STATS` is received.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_ring_stats_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct gnl_foobar_xmpl_ring *r;
+    struct sk_buff *reply_skb;
+    void *msg_head;
+    u64 generation, records, bytes, doorbells;
+    u32 id;
+
+    // before the snapshot: a doorbell in between must not make these counters look current
+    generation = gnl_foobar_xmpl_generation(genl_info_net(info));
+    r = gnl_foobar_xmpl_ring_get(xn, info, false);
+    if (IS_ERR(r)) {
+        return PTR_ERR(r);
+    }
+    mutex_lock(&r->mtx);
+    records = r->records;
+    bytes = r->bytes;
+    doorbells = r->doorbells;
+    mutex_unlock(&r->mtx);
+    id = r->id;
+    kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(nla_total_size(sizeof(u32)) + 3 * nla_total_size_64bit(sizeof(u64)));
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, generation, info->snd_portid, info->snd_seq + 1,
+                                         GNL_FOOBAR_XMPL_C_RING_STATS);
+    if (msg_head == NULL ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_RING_ID, id) ||
+        nla_put_u64_64bit(reply_skb, GNL_FOOBAR_XMPL_A_RING_RECORDS, records, GNL_FOOBAR_XMPL_A_PAD) ||
+        nla_put_u64_64bit(reply_skb, GNL_FOOBAR_XMPL_A_RING_BYTES, bytes, GNL_FOOBAR_XMPL_A_PAD) ||
+        nla_put_u64_64bit(reply_skb, GNL_FOOBAR_XMPL_A_RING_DOORBELLS, doorbells, GNL_FOOBAR_XMPL_A_PAD)) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_RING_DESTROY` is received.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_ring_destroy_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct gnl_foobar_xmpl_ring *r;
+
+    r = gnl_foobar_xmpl_ring_get(xn, info, true);
+    if (IS_ERR(r)) {
+        return PTR_ERR(r);
+    }
+    // the memory is freed now or when the last mapping is gone
+    kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+    gnl_foobar_xmpl_generation_bump(genl_info_net(info), GFP_KERNEL);
+    return 0;
+}
+
+static void gnl_foobar_xmpl_ring_vm_open(struct vm_area_struct *vma) {
+    struct gnl_foobar_xmpl_ring *r = vma->vm_private_data;
+
+    kref_get(&r->ref);
+}
+
+static void gnl_foobar_xmpl_ring_vm_close(struct vm_area_struct *vma) {
+    struct gnl_foobar_xmpl_ring *r = vma->vm_private_data;
+
+    kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+}
+
+/** Each mapping (also the copies after fork() or a split) holds a reference on its ring. */
+static const struct vm_operations_struct gnl_foobar_xmpl_ring_vm_ops = {
+        .open = gnl_foobar_xmpl_ring_vm_open,
+        .close = gnl_foobar_xmpl_ring_vm_close,
+};
+
+/**
+ * open() of the misc device. Rings belong to a network namespace like the Netlink sockets that
+ * create them; the file remembers (and pins) the namespace of the process that opened it.
+ */
+static int gnl_foobar_xmpl_ring_dev_open(struct inode *inode, struct file *file) {
+    // misc_open() stored the `struct miscdevice` here; we don't need it
+    file->private_data = get_net(current->nsproxy->net_ns);
+    return 0;
+}
+
+static int gnl_foobar_xmpl_ring_dev_release(struct inode *inode, struct file *file) {
+    put_net(file->private_data);
+    return 0;
+}
+
+/**
+ * mmap() of the misc device. The page offset is the id of the ring and the length must be exactly
+ * the `GNL_FOOBAR_XMPL_A_RING_MMAP_LEN` of it. Only the user that created the ring may map it.
+ *
+ * @return success (0) or error.
+ */
+static int gnl_foobar_xmpl_ring_dev_mmap(struct file *file, struct vm_area_struct *vma) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(file->private_data);
+    struct gnl_foobar_xmpl_ring *r;
+    int rc;
+
+    mutex_lock(&xn->ring_mtx);
+    r = idr_find(&xn->rings, vma->vm_pgoff);
+    if (r != NULL) {
+        kref_get(&r->ref);
+    }
+    mutex_unlock(&xn->ring_mtx);
+    if (r == NULL) {
+        return -ENXIO;
+    }
+    if (!uid_eq(current_euid(), r->uid)) {
+        rc = -EPERM;
+        goto err_put;
+    }
+    if (vma->vm_end - vma->vm_start != r->mmap_len) {
+        rc = -EINVAL;
+        goto err_put;
+    }
+    // the page offset is our id, not an offset into the ring
+    rc = remap_vmalloc_range(vma, r->mem, 0);
+    if (rc != 0) {
+        goto err_put;
+    }
+    vma->vm_private_data = r;
+    vma->vm_ops = &gnl_foobar_xmpl_ring_vm_ops;
+    return 0;
+
+err_put:
+    kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+    return rc;
+}
+
+static const struct file_operations gnl_foobar_xmpl_ring_fops = {
+        .owner = THIS_MODULE,
+        .open = gnl_foobar_xmpl_ring_dev_open,
+        .release = gnl_foobar_xmpl_ring_dev_release,
+        .mmap = gnl_foobar_xmpl_ring_dev_mmap,
+};
+
+/** "/dev/gnl_foobar_xmpl_ring"; readable and writable by everybody, like the Netlink family itself. */
+static struct miscdevice gnl_foobar_xmpl_ring_dev = {
+        .minor = MISC_DYNAMIC_MINOR,
+        .name = GNL_FOOBAR_XMPL_RING_DEV,
+        .fops = &gnl_foobar_xmpl_ring_fops,
+        .mode = 0666,
+};
+
+/**
+ * Returns the subscription of `portid` or NULL. The caller must hold `xn->event_mtx`.
+ */
+static struct gnl_foobar_xmpl_event_sub *gnl_foobar_xmpl_event_sub_find(struct gnl_foobar_xmpl_net *xn, u32 portid) {
+    struct gnl_foobar_xmpl_event_sub *sub;
+
+    list_for_each_entry(sub, &xn->event_subs, node) {
+        if (sub->portid == portid) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Removes the subscription of `portid` if there is one.
+ *
+ * @return true if a subscription was removed.
+ */
+static bool gnl_foobar_xmpl_event_sub_remove(struct gnl_foobar_xmpl_net *xn, u32 portid) {
+    struct gnl_foobar_xmpl_event_sub *sub;
+
+    mutex_lock(&xn->event_mtx);
+    sub = gnl_foobar_xmpl_event_sub_find(xn, portid);
+    if (sub != NULL) {
+        list_del(&sub->node);
+        xn->event_sub_count--;
+    }
+    mutex_unlock(&xn->event_mtx);
+    kfree(sub);
+    return sub != NULL;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE` is received.
+ * Creates or replaces the filter of the sending socket.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_event_subscribe_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+    struct nlattr *mask_na = info->attrs[GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK];
+    struct nlattr *prefix_na = info->attrs[GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX];
+    struct gnl_foobar_xmpl_event_sub *sub, *new_sub;
+    int rc = 0;
+
+    // allocated up front; the lock is also taken when sockets are closed
+    new_sub = kzalloc(sizeof(*new_sub), GFP_KERNEL);
+    if (new_sub == NULL) {
+        return -ENOMEM;
+    }
+    new_sub->portid = info->snd_portid;
+    new_sub->type_mask = mask_na != NULL ? nla_get_u64(mask_na) : 0;
+    if (prefix_na != NULL) {
+        // the policy guarantees the terminating zero and limits the length, hence it always fits
+        strscpy(new_sub->prefix, nla_data(prefix_na), sizeof(new_sub->prefix));
+        new_sub->prefix_len = strlen(new_sub->prefix);
+    }
+
+    mutex_lock(&xn->event_mtx);
+    sub = gnl_foobar_xmpl_event_sub_find(xn, new_sub->portid);
+    if (sub != NULL) {
+        list_replace(&sub->node, &new_sub->node);
+    } else if (xn->event_sub_count >= event_max_subscribers) {
+        GENL_SET_ERR_MSG(info, "too many subscribers (event_max_subscribers)");
+        rc = -ENOSPC;
+    } else {
+        list_add_tail(&new_sub->node, &xn->event_subs);
+        xn->event_sub_count++;
+    }
+    mutex_unlock(&xn->event_mtx);
+    // the replaced subscription, or the new one if it wasn't added
+    kfree(rc == 0 ? sub : new_sub);
+    return rc;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE` is received.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_event_unsubscribe_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(genl_info_net(info));
+
+    if (!gnl_foobar_xmpl_event_sub_remove(xn, info->snd_portid)) {
+        GENL_SET_ERR_MSG(info, "socket is not subscribed");
+        return -ENOENT;
+    }
+    return 0;
+}
+
+static bool gnl_foobar_xmpl_event_sub_match(const struct gnl_foobar_xmpl_event_sub *sub, u32 type, const char *key) {
+    if (sub->type_mask != 0 && !(sub->type_mask & BIT_ULL(type))) {
+        return false;
+    }
+    return strncmp(key, sub->prefix, sub->prefix_len) == 0;
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_EVENT_EMIT` is received.
+ * Builds the notification once and sends clones of it: one unicast per matching subscriber plus
+ * one multicast to the group "events" if it has members. Subscribers that don't match cost a
+ * comparison here instead of a copy, a wakeup and a recv() in their process.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_event_emit_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct net *net = genl_info_net(info);
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(net);
+    struct nlattr *type_na = info->attrs[GNL_FOOBAR_XMPL_A_EVENT_TYPE];
+    struct nlattr *key_na = info->attrs[GNL_FOOBAR_XMPL_A_EVENT_KEY];
+    struct nlattr *data_na = info->attrs[GNL_FOOBAR_XMPL_A_DATA];
+    // zero terminated and at most 63 characters (policy)
+    const char *key = key_na != NULL ? nla_data(key_na) : "";
+    struct gnl_foobar_xmpl_event_sub *sub;
+    struct sk_buff *event_skb, *reply_skb;
+    void *msg_head;
+    u32 type, delivered = 0, filtered = 0;
+
+    if (type_na == NULL) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_EVENT_TYPE");
+        return -EINVAL;
+    }
+    type = nla_get_u32(type_na);
+
+    // exactly sized: netlink_unicast() would otherwise trim the tailroom of every clone with a copy
+    event_skb = genlmsg_new(nla_total_size(sizeof(u32)) + nla_total_size(strlen(key) + 1) +
+                            (data_na != NULL ? nla_total_size(nla_len(data_na)) : 0), GFP_KERNEL);
+    if (event_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = genlmsg_put(event_skb, 0, 0, &gnl_foobar_xmpl_family, 0, GNL_FOOBAR_XMPL_C_EVENT);
+    if (msg_head == NULL ||
+        nla_put_u32(event_skb, GNL_FOOBAR_XMPL_A_EVENT_TYPE, type) ||
+        nla_put_string(event_skb, GNL_FOOBAR_XMPL_A_EVENT_KEY, key) ||
+        (data_na != NULL && nla_put(event_skb, GNL_FOOBAR_XMPL_A_DATA, nla_len(data_na), nla_data(data_na)))) {
+        nlmsg_free(event_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(event_skb, msg_head);
+
+    mutex_lock(&xn->event_mtx);
+    list_for_each_entry(sub, &xn->event_subs, node) {
+        struct sk_buff *clone;
+
+        if (!gnl_foobar_xmpl_event_sub_match(sub, type, key)) {
+            filtered++;
+            continue;
+        }
+        clone = skb_clone(event_skb, GFP_KERNEL);
+        // a full receive buffer only drops the event for this subscriber
+        if (clone != NULL && genlmsg_unicast(net, clone, sub->portid) == 0) {
+            delivered++;
+        }
+    }
+    mutex_unlock(&xn->event_mtx);
+    if (genl_has_listeners(&gnl_foobar_xmpl_family, net, GNL_FOOBAR_XMPL_MCGRP_EVENTS)) {
+        if (genlmsg_multicast_netns(&gnl_foobar_xmpl_family, net, event_skb, 0, GNL_FOOBAR_XMPL_MCGRP_EVENTS,
+                                    GFP_KERNEL) == 0) {
+            delivered++;
+        }
+    } else {
+        nlmsg_free(event_skb);
+    }
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(2 * nla_total_size(sizeof(u32)));
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_EVENT_EMIT);
+    if (msg_head == NULL ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_EVENT_DELIVERED, delivered) ||
+        nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_EVENT_FILTERED, filtered)) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+}
+
+/**
+ * Ends the subscription, the accounting, the transfers and the rings of a Generic Netlink socket
+ * when it is closed. Otherwise a new socket that gets the same port id would inherit them, and the
+ * transfers and rings of a crashed client would pin their memory forever.
+ */
+static int gnl_foobar_xmpl_netlink_notify(struct notifier_block *nb, unsigned long event, void *ptr) {
+    struct netlink_notify *n = ptr;
+
+    if (event != NETLINK_URELEASE || n->protocol != NETLINK_GENERIC) {
+        return NOTIFY_DONE;
+    }
+    gnl_foobar_xmpl_event_sub_remove(gnl_foobar_xmpl_pernet(n->net), n->portid);
+    gnl_foobar_xmpl_port_remove(gnl_foobar_xmpl_pernet(n->net), n->portid);
+    gnl_foobar_xmpl_xfer_remove_port(n->net, n->portid);
+    gnl_foobar_xmpl_ring_remove_port(n->net, n->portid);
+    return NOTIFY_DONE;
+}
+
+static struct notifier_block gnl_foobar_xmpl_netlink_notifier = {
+        .notifier_call = gnl_foobar_xmpl_netlink_notify,
+};
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_CHECKSUM` is received.
+ * Hashes the payloads in place, i.e. straight from the request skb. `crc32c()` goes through the
+ * crypto API, which picks the fastest registered "crc32c" driver (e.g. "crc32c-intel").
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_checksum_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct sk_buff *reply_skb;
+    struct nlattr *na, *checksums_na;
+    void *msg_head;
+    u32 *checksums;
+    u32 max_batch;
+    int rem, count = 0;
+
+    // nla_parse() validated every payload, but `info->attrs` only keeps the last one of a type
+    nlmsg_for_each_attr(na, info->nlhdr, GENL_HDRLEN, rem) {
+        if (nla_type(na) == GNL_FOOBAR_XMPL_A_DATA) {
+            count++;
+        }
+    }
+    if (count == 0) {
+        GENL_SET_ERR_MSG(info, "missing attribute GNL_FOOBAR_XMPL_A_DATA");
+        return -EINVAL;
+    }
+    max_batch = gnl_foobar_xmpl_config_get(checksum_max_batch);
+    if (max_batch != 0 && count > max_batch) {
+        GENL_SET_ERR_MSG(info, "more payloads than the tunable checksum-max-batch allows");
+        return -E2BIG;
+    }
+    // all checksums go into one attribute, whose length is a u16
+    if (count > (U16_MAX - NLA_HDRLEN) / sizeof(u32)) {
+        GENL_SET_ERR_MSG(info, "more payloads than one GNL_FOOBAR_XMPL_A_CHECKSUMS can hold");
+        return -E2BIG;
+    }
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(nla_total_size(count * sizeof(u32)));
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_CHECKSUM);
+    if (msg_head == NULL ||
+        (checksums_na = nla_reserve(reply_skb, GNL_FOOBAR_XMPL_A_CHECKSUMS, count * sizeof(u32))) == NULL) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    checksums = nla_data(checksums_na);
+    nlmsg_for_each_attr(na, info->nlhdr, GENL_HDRLEN, rem) {
+        if (nla_type(na) == GNL_FOOBAR_XMPL_A_DATA) {
+            // the standard CRC32C: initial value and final XOR with all ones
+            *checksums++ = ~crc32c(~0U, nla_data(na), nla_len(na));
+        }
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+}
+
+/**
+ * Builds the reply of `GNL_FOOBAR_XMPL_C_GET_CONFIG` and `GNL_FOOBAR_XMPL_C_SET_CONFIG`: all tunables
+ * of the current config.
+ *
+ * @return success (0) or error.
+ */
+static int gnl_foobar_xmpl_config_reply(struct genl_info *info, u8 cmd) {
+    // before the config is read below
+    const u64 generation = gnl_foobar_xmpl_generation(genl_info_net(info));
+    const struct gnl_foobar_xmpl_config *cfg;
+    struct sk_buff *reply_skb;
+    void *msg_head;
+    int rc;
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(8 * nla_total_size(sizeof(u32)));
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, generation, info->snd_portid, info->snd_seq + 1, cmd);
+    if (msg_head == NULL) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    // the skb is allocated already, hence nothing in here sleeps
+    rcu_read_lock();
+    cfg = rcu_dereference(gnl_foobar_xmpl_config);
+    rc = nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS, cfg->dump_runs) ||
+         nla_put_u8(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE, cfg->verbose) ||
+         nla_put_u8(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO, cfg->zerocopy_echo) ||
+         nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN, cfg->zerocopy_min_len) ||
+         nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW, cfg->xfer_window) ||
+         nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH, cfg->checksum_max_batch) ||
+         nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT, cfg->dump_max_in_flight) ||
+         nla_put_u32(reply_skb, GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS, cfg->dump_max_records);
+    rcu_read_unlock();
+    if (rc) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_GET_CONFIG` is received.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_get_config_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    return gnl_foobar_xmpl_config_reply(info, GNL_FOOBAR_XMPL_C_GET_CONFIG);
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_SET_CONFIG` is received.
+ * Replaces the config with a copy that has the tunables of the request applied. The policy has
+ * validated their ranges already, hence either all of them are applied or (on -ENOMEM) none.
+ * `GENL_ADMIN_PERM` restricts the command to CAP_NET_ADMIN.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_set_config_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct gnl_foobar_xmpl_config *cfg, *old;
+    struct nlattr **attrs = info->attrs;
+
+    cfg = kmalloc(sizeof(*cfg), GFP_KERNEL);
+    if (cfg == NULL) {
+        return -ENOMEM;
+    }
+
+    mutex_lock(&gnl_foobar_xmpl_config_mtx);
+    old = rcu_dereference_protected(gnl_foobar_xmpl_config, lockdep_is_held(&gnl_foobar_xmpl_config_mtx));
+    *cfg = *old;
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS]) {
+        cfg->dump_runs = nla_get_u32(attrs[GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE]) {
+        cfg->verbose = nla_get_u8(attrs[GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO]) {
+        cfg->zerocopy_echo = nla_get_u8(attrs[GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN]) {
+        cfg->zerocopy_min_len = nla_get_u32(attrs[GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW]) {
+        cfg->xfer_window = nla_get_u32(attrs[GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH]) {
+        cfg->checksum_max_batch = nla_get_u32(attrs[GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT]) {
+        cfg->dump_max_in_flight = nla_get_u32(attrs[GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT]);
+    }
+    if (attrs[GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS]) {
+        cfg->dump_max_records = nla_get_u32(attrs[GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS]);
+    }
+    rcu_assign_pointer(gnl_foobar_xmpl_config, cfg);
+    pr_info("config changed by port %u: dump_runs=%u verbose=%d zerocopy_echo=%d zerocopy_min_len=%u "
+            "xfer_window=%u checksum_max_batch=%u dump_max_in_flight=%u dump_max_records=%u\n", info->snd_portid,
+            cfg->dump_runs, cfg->verbose, cfg->zerocopy_echo, cfg->zerocopy_min_len, cfg->xfer_window,
+            cfg->checksum_max_batch, cfg->dump_max_in_flight, cfg->dump_max_records);
+    mutex_unlock(&gnl_foobar_xmpl_config_mtx);
+    // readers that still see the old config are done after a grace period
+    kfree_rcu(old, rcu);
+
+    // e.g. the echo dump depends on the config
+    gnl_foobar_xmpl_generation_bump_all();
+    return gnl_foobar_xmpl_config_reply(info, GNL_FOOBAR_XMPL_C_SET_CONFIG);
+}
+
+/**
+ * Regular ".doit"-callback function if a Generic Netlink with command `GNL_FOOBAR_XMPL_C_GET_GENERATION` is received.
+ * The reply consists of the generation only, which every reply contains anyway.
+ *
+ * @return success (0) or error.
+ */
+int gnl_cb_get_generation_doit(struct sk_buff *sender_skb, struct genl_info *info) {
+    struct sk_buff *reply_skb;
+    void *msg_head;
+
+    reply_skb = gnl_foobar_xmpl_reply_alloc(0);
+    if (reply_skb == NULL) {
+        return -ENOMEM;
+    }
+    msg_head = gnl_foobar_xmpl_reply_put(reply_skb, gnl_foobar_xmpl_generation(genl_info_net(info)),
+                                         info->snd_portid, info->snd_seq + 1, GNL_FOOBAR_XMPL_C_GET_GENERATION);
+    if (msg_head == NULL) {
+        nlmsg_free(reply_skb);
+        return -EMSGSIZE;
+    }
+    genlmsg_end(reply_skb, msg_head);
+    return genlmsg_reply(reply_skb, info);
+}
+
+/**
+ * ".dumpit"-callback of `GNL_FOOBAR_XMPL_C_PORT_STATS`. One record per socket with accounting; `cb->args[0]`
+ * is the number of sockets in the previous runs. Not admitted nor accounted itself: it must work while
+ * the quotas throttle everybody else.
+ *
+ * @return length of the filled skb or 0 when all sockets are dumped.
+ */
+int gnl_cb_port_stats_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb) {
+    struct net *net = sock_net(cb->skb->sk);
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(net);
+    // before the counters of this run are read
+    const u64 generation = gnl_foobar_xmpl_generation(net);
+    struct gnl_foobar_xmpl_port *p;
+    long idx = 0;
+
+    mutex_lock(&xn->port_mtx);
+    list_for_each_entry(p, &xn->ports, node) {
+        void *msg_head;
+
+        if (idx++ < cb->args[0]) {
+            continue;
+        }
+        msg_head = genlmsg_put(pre_allocated_skb, NETLINK_CB(cb->skb).portid, cb->nlh->nlmsg_seq,
+                               &gnl_foobar_xmpl_family, NLM_F_MULTI, GNL_FOOBAR_XMPL_C_PORT_STATS);
+        if (msg_head == NULL) {
+            idx--;
+            break;
+        }
+        if (gnl_foobar_xmpl_put_generation(pre_allocated_skb, generation) ||
+            nla_put_u32(pre_allocated_skb, GNL_FOOBAR_XMPL_A_PORT_ID, p->portid) ||
+            nla_put_u64_64bit(pre_allocated_skb, GNL_FOOBAR_XMPL_A_PORT_DUMPS, atomic64_read(&p->dumps),
+                              GNL_FOOBAR_XMPL_A_PAD) ||
+            nla_put_u64_64bit(pre_allocated_skb, GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED,
+                              atomic64_read(&p->dumps_rejected), GNL_FOOBAR_XMPL_A_PAD) ||
+            nla_put_u64_64bit(pre_allocated_skb, GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS, atomic64_read(&p->dump_runs),
+                              GNL_FOOBAR_XMPL_A_PAD) ||
+            nla_put_u64_64bit(pre_allocated_skb, GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED,
+                              atomic64_read(&p->dump_runs_deferred), GNL_FOOBAR_XMPL_A_PAD) ||
+            nla_put_u64_64bit(pre_allocated_skb, GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS,
+                              atomic64_read(&p->dump_records), GNL_FOOBAR_XMPL_A_PAD)) {
+            genlmsg_cancel(pre_allocated_skb, msg_head);
+            idx--;
+            break;
+        }
+        genlmsg_end(pre_allocated_skb, msg_head);
+    }
+    mutex_unlock(&xn->port_mtx);
+    cb->args[0] = idx;
+    return pre_allocated_skb->len;
+}
+
+/**
+ * Called before a dump with `gnl_cb_echo_dumpit()` starts.
  * See where this is assigned in `struct genl_ops gnl_foobar_xmpl_ops[]` as
  * `.start` callback for more comments.
  *
  * @return success (0) or error.
  */
+int	gnl_cb_echo_dumpit_before(struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(sock_net(cb->skb->sk));
+    int ret;
+    // the dump keeps this number even if the tunable changes while it runs
+    const u32 dump_runs = gnl_foobar_xmpl_config_get(dump_runs);
+    pr_info_verbose("%s: dump started. initialize the records to go of this dump to %u\n", __func__, dump_runs);
+    // Each dump keeps its progress in `cb->args[]`, hence dumps don't need a lock and run in parallel.
+    // Instead, the number of parallel dumps of a user is bounded by the tunable "dump_max_in_flight".
+    ret = gnl_foobar_xmpl_dump_admit(cb);
+    if (ret != 0) {
+        pr_info_verbose("%s: dump rejected: %i\n", __func__, ret);
+        return ret;
+    }
+    atomic_long_inc(&xn->dump_requests);
+    // records in total and records to go
+    cb->args[0] = dump_runs;
+    cb->args[1] = dump_runs;
+    return 0;
+
+}
+
+/**
+ * Called after a dump with `gnl_cb_echo_dumpit()` is done or was interrupted.
+ * See where this is assigned in `struct genl_ops gnl_foobar_xmpl_ops[]` as
+ * `.done` callback for more comments.
+ *
+ * @return success (0) or error.
+ */
 int	gnl_cb_echo_dumpit_before_after(struct netlink_callback *cb) {
-    pr_info("%s: dump done. release lock\n", __func__);
-    mutex_unlock(&dumpit_cb_progress_data.mtx);
+    pr_info_verbose("%s: dump done\n", __func__);
+    gnl_foobar_xmpl_dump_release(cb);
+    return 0;
+}
+
+/**
+ * Allocates the initial config from the module parameters. Must run before the family is registered.
+ *
+ * @return success (0) or error code.
+ */
+static int __init gnl_foobar_xmpl_config_init(void) {
+    struct gnl_foobar_xmpl_config *cfg = kzalloc(sizeof(*cfg), GFP_KERNEL);
+
+    if (cfg == NULL) {
+        return -ENOMEM;
+    }
+    cfg->dump_runs = 3;
+    cfg->verbose = true;
+    cfg->zerocopy_echo = zerocopy_echo;
+    cfg->zerocopy_min_len = PAGE_SIZE;
+    // same range as the policy of GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW
+    cfg->xfer_window = clamp(xfer_window, 1U, 4096U);
+    cfg->checksum_max_batch = 0;
+    cfg->dump_max_in_flight = 0;
+    cfg->dump_max_records = 0;
+    RCU_INIT_POINTER(gnl_foobar_xmpl_config, cfg);
+    return 0;
+}
+
+/**
+ * Frees the config. Must run after the family is unregistered, i.e. when no readers are left.
+ */
+static void gnl_foobar_xmpl_config_exit(void) {
+    kfree(rcu_dereference_protected(gnl_foobar_xmpl_config, true));
+    RCU_INIT_POINTER(gnl_foobar_xmpl_config, NULL);
+}
+
+/**
+ * Called for every network namespace; for all existing ones during `register_pernet_subsys()` and
+ * afterwards for each newly created one. The memory behind `gnl_foobar_xmpl_pernet(net)` is
+ * already allocated and zeroed.
+ *
+ * @return success (0) or error code.
+ */
+static int __net_init gnl_foobar_xmpl_net_init(struct net *net) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(net);
+
+    mutex_init(&xn->port_mtx);
+    INIT_LIST_HEAD(&xn->ports);
+    mutex_init(&xn->xfer_mtx);
+    idr_init(&xn->xfers);
+    mutex_init(&xn->ring_mtx);
+    idr_init(&xn->rings);
+    mutex_init(&xn->event_mtx);
+    INIT_LIST_HEAD(&xn->event_subs);
+    // a random start: generations from before a module reload or of other namespaces don't match
+    atomic64_set(&xn->generation, get_random_u64());
     return 0;
 }
 
+/**
+ * Called when a network namespace goes away (or for all namespaces on module unload).
+ */
+static void __net_exit gnl_foobar_xmpl_net_exit(struct net *net) {
+    struct gnl_foobar_xmpl_net *xn = gnl_foobar_xmpl_pernet(net);
+    struct gnl_foobar_xmpl_xfer *x;
+    struct gnl_foobar_xmpl_ring *r;
+    struct gnl_foobar_xmpl_event_sub *sub, *tmp;
+    struct gnl_foobar_xmpl_port *p, *ptmp;
+    int id;
+
+    pr_info("network namespace exit: served %li echo requests and %li dumps\n",
+            atomic_long_read(&xn->echo_requests), atomic_long_read(&xn->dump_requests));
+
+    // all sockets are closed and their dumps are done; normally the notifier has removed them already
+    list_for_each_entry_safe(p, ptmp, &xn->ports, node) {
+        list_del(&p->node);
+        kref_put(&p->ref, gnl_foobar_xmpl_port_release);
+    }
+    mutex_destroy(&xn->port_mtx);
+
+    // no sockets are left in the namespace, hence no downloads run anymore
+    idr_for_each_entry(&xn->xfers, x, id) {
+        kref_put(&x->ref, gnl_foobar_xmpl_xfer_release);
+    }
+    idr_destroy(&xn->xfers);
+    mutex_destroy(&xn->xfer_mtx);
+
+    // open files of the misc device pin the namespace, hence no ring is mapped anymore
+    idr_for_each_entry(&xn->rings, r, id) {
+        kref_put(&r->ref, gnl_foobar_xmpl_ring_release);
+    }
+    idr_destroy(&xn->rings);
+    mutex_destroy(&xn->ring_mtx);
+
+    // all sockets are closed; normally the notifier has removed their subscriptions already
+    list_for_each_entry_safe(sub, tmp, &xn->event_subs, node) {
+        list_del(&sub->node);
+        kfree(sub);
+    }
+    mutex_destroy(&xn->event_mtx);
+}
+
+/**
+ * Per network namespace hooks. With ".id" and ".size" set, the kernel allocates
+ * `struct gnl_foobar_xmpl_net` for every namespace, accessible via `net_generic()`.
+ */
+static struct pernet_operations gnl_foobar_xmpl_net_ops = {
+        .init = gnl_foobar_xmpl_net_init,
+        .exit = gnl_foobar_xmpl_net_exit,
+        .id = &gnl_foobar_xmpl_net_id,
+        .size = sizeof(struct gnl_foobar_xmpl_net),
+};
+
 /**
  * Module/driver initializer. Called on module load/insertion.
  *
@@ -501,17 +2695,59 @@ static int __init gnl_foobar_xmpl_module_init(void) {
     int rc;
     pr_info("Generic Netlink Example Module inserted.\n");
 
+    // All handlers read the config, hence it must exist before the family is registered.
+    rc = gnl_foobar_xmpl_config_init();
+    if (rc != 0) {
+        pr_err("FAILED: gnl_foobar_xmpl_config_init(): %i\n", rc);
+        return rc;
+    }
+
+    gnl_foobar_xmpl_skb_cache_init();
+
+    // The per namespace state must exist before the first request can arrive.
+    rc = register_pernet_subsys(&gnl_foobar_xmpl_net_ops);
+    if (rc != 0) {
+        pr_err("FAILED: register_pernet_subsys(): %i\n", rc);
+        gnl_foobar_xmpl_skb_cache_exit();
+        gnl_foobar_xmpl_config_exit();
+        return rc;
+    }
+
+    // Before the first subscription can be created: ends it when its socket is closed.
+    rc = netlink_register_notifier(&gnl_foobar_xmpl_netlink_notifier);
+    if (rc != 0) {
+        pr_err("FAILED: netlink_register_notifier(): %i\n", rc);
+        unregister_pernet_subsys(&gnl_foobar_xmpl_net_ops);
+        gnl_foobar_xmpl_skb_cache_exit();
+        gnl_foobar_xmpl_config_exit();
+        return rc;
+    }
+
     // Register family with its operations and policies
     rc = genl_register_family(&gnl_foobar_xmpl_family);
     if (rc != 0) {
         pr_err("FAILED: genl_register_family(): %i\n", rc);
         pr_err("An error occurred while inserting the generic netlink example module\n");
+        netlink_unregister_notifier(&gnl_foobar_xmpl_netlink_notifier);
+        unregister_pernet_subsys(&gnl_foobar_xmpl_net_ops);
+        gnl_foobar_xmpl_skb_cache_exit();
+        gnl_foobar_xmpl_config_exit();
         return -1;
     } else {
         pr_info("successfully registered custom Netlink family '" FAMILY_NAME "' using Generic Netlink.\n");
     }
 
-    mutex_init(&dumpit_cb_progress_data.mtx);
+    // The rings are created via the family, hence mapping them is only possible afterwards.
+    rc = misc_register(&gnl_foobar_xmpl_ring_dev);
+    if (rc != 0) {
+        pr_err("FAILED: misc_register(): %i\n", rc);
+        genl_unregister_family(&gnl_foobar_xmpl_family);
+        netlink_unregister_notifier(&gnl_foobar_xmpl_netlink_notifier);
+        unregister_pernet_subsys(&gnl_foobar_xmpl_net_ops);
+        gnl_foobar_xmpl_skb_cache_exit();
+        gnl_foobar_xmpl_config_exit();
+        return rc;
+    }
 
     return 0;
 }
@@ -525,6 +2761,9 @@ static void __exit gnl_foobar_xmpl_module_exit(void) {
     int ret;
     pr_info("Generic Netlink Example Module unloaded.\n");
 
+    // no open files can exist anymore (they hold a reference on the module)
+    misc_deregister(&gnl_foobar_xmpl_ring_dev);
+
     // Unregister the family
     ret = genl_unregister_family(&gnl_foobar_xmpl_family);
     if (ret != 0) {
@@ -534,8 +2773,17 @@ static void __exit gnl_foobar_xmpl_module_exit(void) {
         pr_info("successfully unregistered custom Netlink family '" FAMILY_NAME "' using Generic Netlink.\n");
     }
 
-    mutex_destroy(&dumpit_cb_progress_data.mtx);
+    // no requests can arrive anymore; release the state of all network namespaces
+    netlink_unregister_notifier(&gnl_foobar_xmpl_netlink_notifier);
+    unregister_pernet_subsys(&gnl_foobar_xmpl_net_ops);
+    gnl_foobar_xmpl_skb_cache_exit();
+    gnl_foobar_xmpl_config_exit();
 }
 
 module_init(gnl_foobar_xmpl_module_init);
 module_exit(gnl_foobar_xmpl_module_exit);
+
+// The KUnit tests call the static handlers directly, hence they are part of this translation unit.
+#if IS_ENABLED(CONFIG_GNL_FOOBAR_XMPL_KUNIT_TEST)
+#include "gnl_foobar_xmpl_test.c"
+#endif
@@ -0,0 +1,260 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Attribute policy and operations of the "gnl_foobar_xmpl" family for the kernel module.
+ * Included exactly once by "gnl_foobar_xmpl.c"; see there for a detailed description of the
+ * fields of `struct genl_ops` and `struct nla_policy`.
+ *
+ * This file is generated from "spec/gnl_foobar_xmpl.yaml" by "tools/gnl-gen.py". Do not edit it.
+ */
+
+#include <net/genetlink.h>
+
+#include "gnl_foobar_xmpl_prop.h"
+
+// Handlers of the operations. Documentation is on the implementation of these functions.
+int gnl_cb_echo_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_echo_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb);
+int gnl_cb_echo_dumpit_before(struct netlink_callback *cb);
+int gnl_cb_echo_dumpit_before_after(struct netlink_callback *cb);
+int gnl_cb_doit_reply_with_nlmsg_err(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_ping_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_xfer_begin_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_xfer_chunk_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_xfer_commit_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_xfer_get_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb);
+int gnl_cb_xfer_get_dumpit_start(struct netlink_callback *cb);
+int gnl_cb_xfer_get_dumpit_done(struct netlink_callback *cb);
+int gnl_cb_xfer_abort_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_ring_create_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_ring_doorbell_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_ring_stats_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_ring_destroy_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_event_subscribe_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_event_unsubscribe_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_event_emit_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_checksum_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_get_config_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_set_config_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_get_generation_doit(struct sk_buff *sender_skb, struct genl_info *info);
+int gnl_cb_port_stats_dumpit(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb);
+
+/** Range of `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS`; too large for `NLA_POLICY_RANGE()`. */
+static const struct netlink_range_validation gnl_foobar_xmpl_config_dump_runs_range = {
+        .min = 1,
+        .max = 16777216,
+};
+
+/**
+ * Attribute policy: defines which attribute has which type (e.g int, char * etc).
+ * This get validated for each received Generic Netlink message, if not deactivated
+ * in `gnl_foobar_xmpl_ops[].validate`.
+ */
+static const struct nla_policy gnl_foobar_xmpl_policy[GNL_FOOBAR_XMPL_A_MAX + 1] = {
+        [GNL_FOOBAR_XMPL_A_UNSPEC] = {.type = NLA_UNSPEC},
+        [GNL_FOOBAR_XMPL_A_MSG] = {.type = NLA_NUL_STRING},
+        [GNL_FOOBAR_XMPL_A_DATA] = {.type = NLA_BINARY},
+        [GNL_FOOBAR_XMPL_A_PAD] = {.type = NLA_UNSPEC},
+        [GNL_FOOBAR_XMPL_A_CLIENT_TS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_KERNEL_RX_TS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_KERNEL_TX_TS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_XFER_ID] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_XFER_SIZE] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_XFER_OFFSET] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_XFER_WINDOW] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_RING_ID] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_RING_ENTRIES] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_RING_MMAP_LEN] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_RING_COMPLETED] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_RING_RECORDS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_RING_BYTES] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_RING_DOORBELLS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_EVENT_TYPE] = NLA_POLICY_MAX(NLA_U32, 63),
+        [GNL_FOOBAR_XMPL_A_EVENT_KEY] = {.type = NLA_NUL_STRING, .len = 63},
+        [GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX] = {.type = NLA_NUL_STRING, .len = 63},
+        [GNL_FOOBAR_XMPL_A_EVENT_DELIVERED] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_EVENT_FILTERED] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_CHECKSUMS] = {.type = NLA_BINARY},
+        [GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS] = NLA_POLICY_FULL_RANGE(NLA_U32, &gnl_foobar_xmpl_config_dump_runs_range),
+        [GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE] = NLA_POLICY_MAX(NLA_U8, 1),
+        [GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO] = NLA_POLICY_MAX(NLA_U8, 1),
+        [GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW] = NLA_POLICY_RANGE(NLA_U32, 1, 4096),
+        [GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_GENERATION] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_PORT_ID] = {.type = NLA_U32},
+        [GNL_FOOBAR_XMPL_A_PORT_DUMPS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED] = {.type = NLA_U64},
+        [GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS] = {.type = NLA_U64},
+};
+
+/**
+ * The length of `struct genl_ops gnl_foobar_xmpl_ops[]`. One entry per command, except for the
+ * notifications, which the kernel only sends.
+ */
+#define GNL_FOOBAR_OPS_LEN (GNL_FOOBAR_XMPL_COMMAND_COUNT - 2)
+
+/**
+ * Array with all operations that our protocol on top of Generic Netlink supports.
+ */
+static const struct genl_ops gnl_foobar_xmpl_ops[GNL_FOOBAR_OPS_LEN] = {
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_ECHO_MSG,
+                .flags = 0,
+                .doit = gnl_cb_echo_doit,
+                .dumpit = gnl_cb_echo_dumpit,
+                .start = gnl_cb_echo_dumpit_before,
+                .done = gnl_cb_echo_dumpit_before_after,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR,
+                .flags = 0,
+                .doit = gnl_cb_doit_reply_with_nlmsg_err,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_PING,
+                .flags = 0,
+                .doit = gnl_cb_ping_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_XFER_BEGIN,
+                .flags = GENL_UNS_ADMIN_PERM,
+                .doit = gnl_cb_xfer_begin_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_XFER_CHUNK,
+                .flags = GENL_UNS_ADMIN_PERM,
+                .doit = gnl_cb_xfer_chunk_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_XFER_COMMIT,
+                .flags = 0,
+                .doit = gnl_cb_xfer_commit_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_XFER_GET,
+                .flags = 0,
+                .dumpit = gnl_cb_xfer_get_dumpit,
+                .start = gnl_cb_xfer_get_dumpit_start,
+                .done = gnl_cb_xfer_get_dumpit_done,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_XFER_ABORT,
+                .flags = 0,
+                .doit = gnl_cb_xfer_abort_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_RING_CREATE,
+                .flags = 0,
+                .doit = gnl_cb_ring_create_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_RING_DOORBELL,
+                .flags = 0,
+                .doit = gnl_cb_ring_doorbell_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_RING_STATS,
+                .flags = 0,
+                .doit = gnl_cb_ring_stats_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_RING_DESTROY,
+                .flags = 0,
+                .doit = gnl_cb_ring_destroy_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE,
+                .flags = 0,
+                .doit = gnl_cb_event_subscribe_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE,
+                .flags = 0,
+                .doit = gnl_cb_event_unsubscribe_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_EVENT_EMIT,
+                .flags = 0,
+                .doit = gnl_cb_event_emit_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_CHECKSUM,
+                .flags = 0,
+                .doit = gnl_cb_checksum_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_GET_CONFIG,
+                .flags = 0,
+                .doit = gnl_cb_get_config_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_SET_CONFIG,
+                .flags = GENL_ADMIN_PERM,
+                .doit = gnl_cb_set_config_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_GET_GENERATION,
+                .flags = 0,
+                .doit = gnl_cb_get_generation_doit,
+                .validate = 0,
+        },
+        {
+                .cmd = GNL_FOOBAR_XMPL_C_PORT_STATS,
+                .flags = 0,
+                .dumpit = gnl_cb_port_stats_dumpit,
+                .validate = 0,
+        },
+};
+
+/**
+ * Multicast groups of the family; indexed by `enum GNL_FOOBAR_XMPL_MCGRP`.
+ */
+static const struct genl_multicast_group gnl_foobar_xmpl_mcgrps[] = {
+        [GNL_FOOBAR_XMPL_MCGRP_EVENTS] = {.name = GNL_FOOBAR_XMPL_MCGRP_EVENTS_NAME},
+        [GNL_FOOBAR_XMPL_MCGRP_INVALIDATE] = {.name = GNL_FOOBAR_XMPL_MCGRP_INVALIDATE_NAME},
+};
@@ -0,0 +1,394 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// ##################################################################################################
+/*
+ * KUnit tests of the handlers of "gnl_foobar_xmpl.c". This file is included at the end of the module
+ * if CONFIG_GNL_FOOBAR_XMPL_KUNIT_TEST is set, hence the tests can call the (static) handlers and
+ * reply builders directly. They call them with synthetic request skbs and a synthetic `struct genl_info`
+ * or `struct netlink_callback`, i.e. without the Generic Netlink receive path in front of them.
+ *
+ * Replies go to a Netlink socket that the test creates in the kernel; the test reads them from its
+ * receive queue. Run the suite with `$ sh kunit.sh <path to the linux sources>`.
+ */
+
+#include <kunit/test.h>
+#include <linux/net.h>
+#include <linux/socket.h>
+#include <net/sock.h>
+
+/** Number of handler calls per timing test. */
+#define GNL_FOOBAR_XMPL_TEST_ITERATIONS 1000
+/** Upper bound of the average duration of a handler call. Generous: UML and debug kernels are slow. */
+#define GNL_FOOBAR_XMPL_TEST_MAX_AVG_NS (5 * NSEC_PER_MSEC)
+
+static const char GNL_FOOBAR_XMPL_TEST_MSG[] = "Hello from KUnit";
+
+/**
+ * Per test state: the socket that receives the replies, the request and its parsed attributes.
+ */
+struct gnl_foobar_xmpl_test_ctx {
+    struct socket *sock;
+    u32 portid;
+    struct sk_buff *req;
+    struct nlattr *attrs[GNL_FOOBAR_XMPL_A_MAX + 1];
+    struct netlink_ext_ack extack;
+    struct genl_info info;
+};
+
+static int gnl_foobar_xmpl_test_init(struct kunit *test) {
+    struct gnl_foobar_xmpl_test_ctx *ctx;
+    struct sockaddr_nl addr = {.nl_family = AF_NETLINK};
+    int rc;
+
+    ctx = kunit_kzalloc(test, sizeof(*ctx), GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, ctx);
+    rc = sock_create_kern(&init_net, AF_NETLINK, SOCK_RAW, NETLINK_GENERIC, &ctx->sock);
+    KUNIT_ASSERT_EQ(test, rc, 0);
+    // nl_pid = 0: the kernel assigns a free port id like for a userland socket
+    rc = kernel_bind(ctx->sock, (struct sockaddr *) &addr, sizeof(addr));
+    KUNIT_ASSERT_EQ(test, rc, 0);
+    rc = kernel_getsockname(ctx->sock, (struct sockaddr *) &addr);
+    KUNIT_ASSERT_GE(test, rc, 0);
+    ctx->portid = addr.nl_pid;
+    KUNIT_ASSERT_NE(test, ctx->portid, 0U);
+    test->priv = ctx;
+    return 0;
+}
+
+static void gnl_foobar_xmpl_test_exit(struct kunit *test) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+
+    if (ctx == NULL) {
+        return;
+    }
+    kfree_skb(ctx->req);
+    if (ctx->sock != NULL) {
+        // also frees the replies that are left in the receive queue
+        sock_release(ctx->sock);
+    }
+}
+
+/**
+ * Builds a request of `cmd` from the socket of the test, with `GNL_FOOBAR_XMPL_A_MSG` if `msg` isn't NULL,
+ * and parses it into `ctx->info` like the Generic Netlink receive path does.
+ */
+static void gnl_foobar_xmpl_test_request(struct kunit *test, u8 cmd, u16 flags, const char *msg) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+    struct nlmsghdr *nlh;
+    void *msg_head;
+    int rc;
+
+    ctx->req = genlmsg_new(NLMSG_GOODSIZE, GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, ctx->req);
+    msg_head = genlmsg_put(ctx->req, ctx->portid, 41, &gnl_foobar_xmpl_family, flags, cmd);
+    KUNIT_ASSERT_NOT_NULL(test, msg_head);
+    if (msg != NULL) {
+        KUNIT_ASSERT_EQ(test, nla_put_string(ctx->req, GNL_FOOBAR_XMPL_A_MSG, msg), 0);
+    }
+    genlmsg_end(ctx->req, msg_head);
+    // the request comes from the socket of the test
+    ctx->req->sk = ctx->sock->sk;
+    NETLINK_CB(ctx->req).portid = ctx->portid;
+
+    nlh = nlmsg_hdr(ctx->req);
+    rc = genlmsg_parse(nlh, &gnl_foobar_xmpl_family, ctx->attrs, GNL_FOOBAR_XMPL_A_MAX, gnl_foobar_xmpl_policy,
+                       &ctx->extack);
+    KUNIT_ASSERT_EQ(test, rc, 0);
+
+    ctx->info.snd_seq = nlh->nlmsg_seq;
+    ctx->info.snd_portid = ctx->portid;
+    ctx->info.nlhdr = nlh;
+    ctx->info.genlhdr = nlmsg_data(nlh);
+    ctx->info.attrs = ctx->attrs;
+    ctx->info.extack = &ctx->extack;
+    genl_info_net_set(&ctx->info, &init_net);
+}
+
+/**
+ * Takes the next reply from the socket of the test and parses its attributes into `attrs`.
+ *
+ * @return the reply (free it with `kfree_skb()`) or NULL if there is none.
+ */
+static struct sk_buff *gnl_foobar_xmpl_test_reply(struct kunit *test, struct nlattr **attrs) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+    struct sk_buff *skb = skb_dequeue(&ctx->sock->sk->sk_receive_queue);
+    int rc;
+
+    if (skb == NULL) {
+        return NULL;
+    }
+    // zero-copy replies have the payload in fragments
+    KUNIT_ASSERT_EQ(test, skb_linearize(skb), 0);
+    // replies are parsed like the userland does: attributes of other commands are allowed
+    rc = nlmsg_parse_deprecated(nlmsg_hdr(skb), GENL_HDRLEN, attrs, GNL_FOOBAR_XMPL_A_MAX, gnl_foobar_xmpl_policy,
+                                NULL);
+    KUNIT_EXPECT_EQ(test, rc, 0);
+    return skb;
+}
+
+/**
+ * Replaces the config with a copy that has `dump_runs` records per echo dump.
+ *
+ * @return the previous number of records
+ */
+static u32 gnl_foobar_xmpl_test_set_dump_runs(u32 dump_runs) {
+    struct gnl_foobar_xmpl_config *cfg, *old;
+    u32 prev;
+
+    cfg = kmalloc(sizeof(*cfg), GFP_KERNEL | __GFP_NOFAIL);
+    mutex_lock(&gnl_foobar_xmpl_config_mtx);
+    old = rcu_dereference_protected(gnl_foobar_xmpl_config, lockdep_is_held(&gnl_foobar_xmpl_config_mtx));
+    *cfg = *old;
+    prev = old->dump_runs;
+    cfg->dump_runs = dump_runs;
+    rcu_assign_pointer(gnl_foobar_xmpl_config, cfg);
+    mutex_unlock(&gnl_foobar_xmpl_config_mtx);
+    kfree_rcu(old, rcu);
+    return prev;
+}
+
+/**
+ * ECHO_MSG with a message: the reply has the sequence number + 1, the message and the generation.
+ */
+static void gnl_foobar_xmpl_test_echo_doit(struct kunit *test) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+    struct nlattr *attrs[GNL_FOOBAR_XMPL_A_MAX + 1];
+    struct sk_buff *reply;
+    struct nlmsghdr *nlh;
+    struct genlmsghdr *genlhdr;
+
+    gnl_foobar_xmpl_test_request(test, GNL_FOOBAR_XMPL_C_ECHO_MSG, 0, GNL_FOOBAR_XMPL_TEST_MSG);
+    KUNIT_ASSERT_EQ(test, gnl_cb_echo_doit(ctx->req, &ctx->info), 0);
+
+    reply = gnl_foobar_xmpl_test_reply(test, attrs);
+    KUNIT_ASSERT_NOT_NULL(test, reply);
+    nlh = nlmsg_hdr(reply);
+    genlhdr = nlmsg_data(nlh);
+    KUNIT_EXPECT_EQ(test, nlh->nlmsg_type, gnl_foobar_xmpl_family.id);
+    KUNIT_EXPECT_EQ(test, nlh->nlmsg_seq, ctx->info.snd_seq + 1);
+    KUNIT_EXPECT_EQ(test, genlhdr->cmd, GNL_FOOBAR_XMPL_C_ECHO_MSG);
+    KUNIT_ASSERT_NOT_NULL(test, attrs[GNL_FOOBAR_XMPL_A_MSG]);
+    KUNIT_EXPECT_STREQ(test, (char *) nla_data(attrs[GNL_FOOBAR_XMPL_A_MSG]), GNL_FOOBAR_XMPL_TEST_MSG);
+    KUNIT_ASSERT_NOT_NULL(test, attrs[GNL_FOOBAR_XMPL_A_GENERATION]);
+    KUNIT_EXPECT_EQ(test, nla_get_u64(attrs[GNL_FOOBAR_XMPL_A_GENERATION]), gnl_foobar_xmpl_generation(&init_net));
+    kfree_skb(reply);
+
+    // exactly one reply per request
+    KUNIT_EXPECT_NULL(test, gnl_foobar_xmpl_test_reply(test, attrs));
+}
+
+/**
+ * ECHO_MSG without a payload fails with -EINVAL and a message in the extended ACK; nothing is sent.
+ */
+static void gnl_foobar_xmpl_test_echo_doit_missing_attr(struct kunit *test) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+    struct nlattr *attrs[GNL_FOOBAR_XMPL_A_MAX + 1];
+
+    gnl_foobar_xmpl_test_request(test, GNL_FOOBAR_XMPL_C_ECHO_MSG, 0, NULL);
+    KUNIT_EXPECT_EQ(test, gnl_cb_echo_doit(ctx->req, &ctx->info), -EINVAL);
+    KUNIT_ASSERT_NOT_NULL(test, ctx->extack._msg);
+    KUNIT_EXPECT_STREQ(test, ctx->extack._msg, "missing attribute GNL_FOOBAR_XMPL_A_MSG or GNL_FOOBAR_XMPL_A_DATA");
+    KUNIT_EXPECT_NULL(test, ctx->extack.bad_attr);
+    KUNIT_EXPECT_NULL(test, gnl_foobar_xmpl_test_reply(test, attrs));
+}
+
+/**
+ * REPLY_WITH_NLMSG_ERR always fails; the extended ACK points at the message attribute of the request.
+ */
+static void gnl_foobar_xmpl_test_reply_with_nlmsg_err(struct kunit *test) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+    struct nlattr *attrs[GNL_FOOBAR_XMPL_A_MAX + 1];
+
+    gnl_foobar_xmpl_test_request(test, GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR, 0, GNL_FOOBAR_XMPL_TEST_MSG);
+    KUNIT_EXPECT_EQ(test, gnl_cb_doit_reply_with_nlmsg_err(ctx->req, &ctx->info), -EINVAL);
+    KUNIT_ASSERT_NOT_NULL(test, ctx->extack._msg);
+    KUNIT_EXPECT_STREQ(test, ctx->extack._msg, "GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR always fails (on purpose)");
+    KUNIT_EXPECT_PTR_EQ(test, ctx->extack.bad_attr, (const struct nlattr *) ctx->attrs[GNL_FOOBAR_XMPL_A_MSG]);
+    // the NLMSG_ERROR reply is sent by the Generic Netlink receive path, not by the handler
+    KUNIT_EXPECT_NULL(test, gnl_foobar_xmpl_test_reply(test, attrs));
+
+    // without the attribute, only the message is reported
+    kfree_skb(ctx->req);
+    memset(&ctx->extack, 0, sizeof(ctx->extack));
+    gnl_foobar_xmpl_test_request(test, GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR, 0, NULL);
+    KUNIT_EXPECT_EQ(test, gnl_cb_doit_reply_with_nlmsg_err(ctx->req, &ctx->info), -EINVAL);
+    KUNIT_EXPECT_NOT_NULL(test, ctx->extack._msg);
+    KUNIT_EXPECT_NULL(test, ctx->extack.bad_attr);
+}
+
+/**
+ * Sets up `cb` for an echo dump of the request of the test, like netlink_dump_start() does.
+ */
+static void gnl_foobar_xmpl_test_dump_start(struct kunit *test, struct netlink_callback *cb) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+
+    gnl_foobar_xmpl_test_request(test, GNL_FOOBAR_XMPL_C_ECHO_MSG, NLM_F_DUMP, NULL);
+    memset(cb, 0, sizeof(*cb));
+    cb->skb = ctx->req;
+    cb->nlh = nlmsg_hdr(ctx->req);
+    cb->extack = &ctx->extack;
+    KUNIT_ASSERT_EQ(test, gnl_cb_echo_dumpit_before(cb), 0);
+}
+
+/**
+ * Runs the echo dump into skbs with room for `records_per_skb` records until it is done, i.e. in
+ * several runs that resume from `cb->args`. Checks that every record appears exactly once and in order.
+ */
+static void gnl_foobar_xmpl_test_echo_dumpit_runs(struct kunit *test, u32 dump_runs, long max_records,
+                                                  unsigned int records_per_skb) {
+    struct netlink_callback cb;
+    struct sk_buff *skb;
+    unsigned int record_len;
+    long next = 0;
+    int runs = 0;
+    int len;
+    u32 prev_dump_runs;
+
+    // the size of one record, for the size of the skbs below
+    skb = nlmsg_new(NLMSG_GOODSIZE, GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, skb);
+    KUNIT_ASSERT_EQ(test, gnl_echo_dumpit_fill(skb, &init_net, 0, 0), 0);
+    record_len = skb->len;
+    kfree_skb(skb);
+
+    prev_dump_runs = gnl_foobar_xmpl_test_set_dump_runs(dump_runs);
+    gnl_foobar_xmpl_test_dump_start(test, &cb);
+    gnl_foobar_xmpl_test_set_dump_runs(prev_dump_runs);
+    // a running dump keeps its number of records
+    KUNIT_EXPECT_EQ(test, cb.args[0], (long) dump_runs);
+    KUNIT_EXPECT_EQ(test, cb.args[1], (long) dump_runs);
+    // the tunable "dump_max_records", without changing it for everybody
+    cb.args[GNL_FOOBAR_XMPL_DUMP_ARG_MAX_RECORDS] = max_records;
+
+    for (;;) {
+        const long to_go = cb.args[1];
+        struct nlmsghdr *nlh;
+        int rem;
+
+        skb = alloc_skb(records_per_skb * record_len, GFP_KERNEL);
+        KUNIT_ASSERT_NOT_NULL(test, skb);
+        // alloc_skb() may round up; exactly room for `records_per_skb` records is left
+        skb_reserve(skb, skb_tailroom(skb) - records_per_skb * record_len);
+        len = gnl_cb_echo_dumpit(skb, &cb);
+        KUNIT_ASSERT_GE(test, len, 0);
+        if (len == 0) {
+            kfree_skb(skb);
+            break;
+        }
+        runs++;
+        nlmsg_for_each_msg(nlh, (struct nlmsghdr *) skb->data, skb->len, rem) {
+            // the sequence number of a record is its index in the dump
+            KUNIT_EXPECT_EQ(test, (long) nlh->nlmsg_seq, next);
+            next++;
+        }
+        KUNIT_EXPECT_EQ(test, (long) (to_go - cb.args[1]), (long) (skb->len / record_len));
+        KUNIT_EXPECT_LE(test, (long) (to_go - cb.args[1]), max_records);
+        kfree_skb(skb);
+        KUNIT_ASSERT_LE(test, runs, (int) dump_runs);
+    }
+    KUNIT_EXPECT_EQ(test, next, (long) dump_runs);
+    KUNIT_EXPECT_EQ(test, cb.args[1], 0L);
+    KUNIT_EXPECT_EQ(test, runs, (int) DIV_ROUND_UP(dump_runs, min_t(long, max_records, records_per_skb)));
+    KUNIT_EXPECT_EQ(test, gnl_cb_echo_dumpit_before_after(&cb), 0);
+}
+
+/**
+ * The dump resumes where the previous run stopped because the skb was full.
+ */
+static void gnl_foobar_xmpl_test_echo_dumpit_full_skb(struct kunit *test) {
+    gnl_foobar_xmpl_test_echo_dumpit_runs(test, 7, LONG_MAX, 2);
+}
+
+/**
+ * The dump resumes where the previous run stopped because of the records quota.
+ */
+static void gnl_foobar_xmpl_test_echo_dumpit_quota(struct kunit *test) {
+    gnl_foobar_xmpl_test_echo_dumpit_runs(test, 7, 3, 16);
+}
+
+/**
+ * A skb that is too small for a single record fails the dump instead of ending it.
+ */
+static void gnl_foobar_xmpl_test_echo_dumpit_tiny_skb(struct kunit *test) {
+    struct netlink_callback cb;
+    struct sk_buff *skb;
+
+    gnl_foobar_xmpl_test_dump_start(test, &cb);
+    skb = alloc_skb(NLMSG_HDRLEN, GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, skb);
+    skb_reserve(skb, skb_tailroom(skb) - NLMSG_HDRLEN);
+    KUNIT_EXPECT_EQ(test, gnl_cb_echo_dumpit(skb, &cb), -EMSGSIZE);
+    KUNIT_EXPECT_EQ(test, cb.args[1], cb.args[0]);
+    kfree_skb(skb);
+    KUNIT_EXPECT_EQ(test, gnl_cb_echo_dumpit_before_after(&cb), 0);
+}
+
+/**
+ * Average duration of the echo handler including the delivery of the reply to the socket, and of
+ * the reply builder alone. Reported with the test log; fails only if the handler is way too slow.
+ */
+static void gnl_foobar_xmpl_test_echo_doit_timing(struct kunit *test) {
+    struct gnl_foobar_xmpl_test_ctx *ctx = test->priv;
+    struct nlattr *attrs[GNL_FOOBAR_XMPL_A_MAX + 1];
+    struct sk_buff *reply;
+    u64 doit_ns = 0, build_ns = 0, start;
+    int i;
+
+    gnl_foobar_xmpl_test_request(test, GNL_FOOBAR_XMPL_C_ECHO_MSG, 0, GNL_FOOBAR_XMPL_TEST_MSG);
+    for (i = 0; i < GNL_FOOBAR_XMPL_TEST_ITERATIONS; i++) {
+        start = ktime_get_ns();
+        KUNIT_ASSERT_EQ(test, gnl_cb_echo_doit(ctx->req, &ctx->info), 0);
+        doit_ns += ktime_get_ns() - start;
+        // keeps the receive buffer from filling up
+        reply = gnl_foobar_xmpl_test_reply(test, attrs);
+        KUNIT_ASSERT_NOT_NULL(test, reply);
+        kfree_skb(reply);
+
+        start = ktime_get_ns();
+        reply = gnl_echo_data_build_copy_reply(&init_net, ctx->portid, 0, ctx->attrs[GNL_FOOBAR_XMPL_A_MSG]);
+        build_ns += ktime_get_ns() - start;
+        KUNIT_ASSERT_FALSE(test, IS_ERR(reply));
+        kfree_skb(reply);
+    }
+    doit_ns /= GNL_FOOBAR_XMPL_TEST_ITERATIONS;
+    build_ns /= GNL_FOOBAR_XMPL_TEST_ITERATIONS;
+    kunit_info(test, "gnl_cb_echo_doit(): %llu ns, gnl_echo_data_build_copy_reply(): %llu ns (avg. of %d)\n",
+               doit_ns, build_ns, GNL_FOOBAR_XMPL_TEST_ITERATIONS);
+    KUNIT_EXPECT_LT(test, doit_ns, (u64) GNL_FOOBAR_XMPL_TEST_MAX_AVG_NS);
+}
+
+static struct kunit_case gnl_foobar_xmpl_test_cases[] = {
+        KUNIT_CASE(gnl_foobar_xmpl_test_echo_doit),
+        KUNIT_CASE(gnl_foobar_xmpl_test_echo_doit_missing_attr),
+        KUNIT_CASE(gnl_foobar_xmpl_test_reply_with_nlmsg_err),
+        KUNIT_CASE(gnl_foobar_xmpl_test_echo_dumpit_full_skb),
+        KUNIT_CASE(gnl_foobar_xmpl_test_echo_dumpit_quota),
+        KUNIT_CASE(gnl_foobar_xmpl_test_echo_dumpit_tiny_skb),
+        KUNIT_CASE(gnl_foobar_xmpl_test_echo_doit_timing),
+        {}
+};
+
+static struct kunit_suite gnl_foobar_xmpl_test_suite = {
+        .name = "gnl_foobar_xmpl",
+        .init = gnl_foobar_xmpl_test_init,
+        .exit = gnl_foobar_xmpl_test_exit,
+        .test_cases = gnl_foobar_xmpl_test_cases,
+};
+kunit_test_suite(gnl_foobar_xmpl_test_suite);
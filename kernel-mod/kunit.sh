@@ -0,0 +1,36 @@
+#!/bin/sh
+# Runs the KUnit tests of the module (gnl_foobar_xmpl_test.c) with `kunit.py run`, by default in UML.
+# KUnit only builds modules that are part of a kernel tree, hence this links the module into
+# drivers/misc of the given Linux sources first. Further arguments go to kunit.py, e.g. `--arch=x86_64`.
+#
+# usage: sh kunit.sh <path to the linux sources> [kunit.py arguments]
+
+set -e
+
+if [ $# -lt 1 ] || [ ! -x "$1/tools/testing/kunit/kunit.py" ]; then
+    echo "usage: sh kunit.sh <path to the linux sources> [kunit.py arguments]" >&2
+    exit 1
+fi
+KDIR=$(realpath "$1")
+shift
+HERE=$(dirname "$(realpath "$0")")
+DEST="$KDIR/drivers/misc/gnl_foobar_xmpl"
+
+mkdir -p "$DEST"
+for f in gnl_foobar_xmpl.c gnl_foobar_xmpl_nl.h gnl_foobar_xmpl_test.c Kconfig; do
+    ln -sf "$HERE/$f" "$DEST/$f"
+done
+cat > "$DEST/Makefile" <<MAKEFILE
+obj-\$(CONFIG_GNL_FOOBAR_XMPL) += gnl_foobar_xmpl.o
+ccflags-y += -I$HERE/../include
+MAKEFILE
+if ! grep -q gnl_foobar_xmpl "$KDIR/drivers/misc/Kconfig"; then
+    # before the final "endmenu"
+    sed -i '$ i source "drivers/misc/gnl_foobar_xmpl/Kconfig"' "$KDIR/drivers/misc/Kconfig"
+fi
+if ! grep -q gnl_foobar_xmpl "$KDIR/drivers/misc/Makefile"; then
+    echo 'obj-$(CONFIG_GNL_FOOBAR_XMPL) += gnl_foobar_xmpl/' >> "$KDIR/drivers/misc/Makefile"
+fi
+
+cd "$KDIR"
+./tools/testing/kunit/kunit.py run --kunitconfig="$HERE/.kunitconfig" "$@"
@@ -0,0 +1,797 @@
+#!/usr/bin/env python3
+# Copyright 2021 Philipp Schuster
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of
+# this software and associated documentation files (the "Software"), to deal in the
+# Software without restriction, including without limitation the rights to use, copy,
+# modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+# and to permit persons to whom the Software is furnished to do so, subject to the
+# following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies
+# or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+# INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+# PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+# HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+# OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+# SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+"""
+Generates the protocol definitions of the "gnl_foobar_xmpl" family for all languages of this
+repository from the YAML spec in "spec/gnl_foobar_xmpl.yaml". See the header of the spec for the
+list of generated files.
+
+Usage:
+    $ python3 tools/gnl-gen.py           # (re)generate all files
+    $ python3 tools/gnl-gen.py --check   # fail if a generated file is out of date
+
+The generated encoders/decoders are specialized per attribute and per operation: encoding an
+attribute is a direct function call and decoding is a single pass over the message with a
+`switch`/`match` on the attribute type. There are no runtime tables or lookups.
+"""
+
+import argparse
+import os
+import sys
+
+import yaml
+
+REPO_ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+SPEC_PATH = os.path.join(REPO_ROOT, 'spec', 'gnl_foobar_xmpl.yaml')
+
+LICENSE_C = '''/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+'''
+
+GENERATED_NOTE = 'This file is generated from "spec/gnl_foobar_xmpl.yaml" by "tools/gnl-gen.py". Do not edit it.'
+
+# attribute type => (kernel policy type, C type, Rust type, size in bytes for fixed size types)
+SCALAR_TYPES = {
+    'u8': ('NLA_U8', '__u8', 'u8', 1),
+    'u16': ('NLA_U16', '__u16', 'u16', 2),
+    'u32': ('NLA_U32', '__u32', 'u32', 4),
+    'u64': ('NLA_U64', '__u64', 'u64', 8),
+    's32': ('NLA_S32', '__s32', 'i32', 4),
+    's64': ('NLA_S64', '__s64', 'i64', 8),
+}
+# "pad": only used by the kernel to align 64 bit attributes (`nla_put_u64_64bit()`); never sent by
+# clients and skipped by the decoders
+KNOWN_TYPES = set(SCALAR_TYPES) | {'string', 'binary', 'flag', 'pad'}
+
+
+class Attr:
+    def __init__(self, attr_set, yaml_attr, value):
+        self.attr_set = attr_set
+        self.name = yaml_attr['name']
+        self.type = yaml_attr['type']
+        self.doc = yaml_attr.get('doc')
+        self.checks = yaml_attr.get('checks', {})
+        self.value = value
+        if self.type not in KNOWN_TYPES:
+            raise Exception(f'attribute "{self.name}": unsupported type "{self.type}"')
+        self.enum_name = attr_set.name_prefix + c_upper(self.name)
+        self.c_name = c_lower(self.name)
+        self.rust_name = rust_camel(self.name)
+
+
+class AttrSet:
+    def __init__(self, yaml_set):
+        self.name = yaml_set['name']
+        self.enum_name = yaml_set['enum-name']
+        self.name_prefix = yaml_set['name-prefix']
+        self.rust_name = yaml_set['rust-name']
+        self.doc = yaml_set.get('doc')
+        self.attrs = [Attr(self, a, i + 1) for i, a in enumerate(yaml_set['attributes'])]
+        if len(self.attrs) >= 64:
+            raise Exception(f'attribute set "{self.name}": at most 63 attributes fit into the "present" bitmask')
+        self.by_name = {a.name: a for a in self.attrs}
+        # the attribute set called "main" gets the short names
+        self.c_struct = 'gnl_foobar_xmpl_attrs' if self.name == 'main' else f'gnl_foobar_xmpl_{c_lower(self.name)}_attrs'
+        self.rust_struct = 'Attrs' if self.name == 'main' else rust_camel(self.name) + 'Attrs'
+
+
+class Op:
+    def __init__(self, family, yaml_op, value):
+        self.name = yaml_op['name']
+        self.doc = yaml_op.get('doc')
+        self.value = value
+        self.attr_set = family.attr_sets[yaml_op['attribute-set']]
+        self.flags = yaml_op.get('flags', [])
+        self.do = yaml_op.get('do')
+        self.dump = yaml_op.get('dump')
+        # notifications: sent by the kernel only, hence no handler and no entry in the genl_ops table
+        self.event = yaml_op.get('event')
+        self.mcgrp = yaml_op.get('mcgrp')
+        self.enum_name = family.ops_prefix + c_upper(self.name)
+        self.c_name = c_lower(self.name)
+        self.rust_name = rust_camel(self.name)
+
+    def _attrs(self, mode, direction):
+        section = getattr(self, mode) or {}
+        names = (section.get(direction) or {}).get('attributes', [])
+        return [self.attr_set.by_name[n] for n in names]
+
+    def has_handler(self):
+        return bool(self.do or self.dump)
+
+    def reply_attrs(self):
+        """Union of the reply attributes of "do" and "dump" (or of the notification) in spec order."""
+        names = {a.name for a in self._attrs('do', 'reply') + self._attrs('dump', 'reply')}
+        names |= set((self.event or {}).get('attributes', []))
+        return [a for a in self.attr_set.attrs if a.name in names]
+
+    def request_attrs(self):
+        names = {a.name for a in self._attrs('do', 'request') + self._attrs('dump', 'request')}
+        return [a for a in self.attr_set.attrs if a.name in names]
+
+
+class Family:
+    def __init__(self, spec):
+        self.name = spec['name']
+        self.version = spec['version']
+        self.doc = spec.get('doc')
+        self.attr_sets = {s['name']: AttrSet(s) for s in spec['attribute-sets']}
+        ops = spec['operations']
+        self.ops_enum_name = ops['enum-name']
+        self.ops_prefix = ops['name-prefix']
+        self.ops_rust_name = ops['rust-name']
+        self.ops_doc = ops.get('doc')
+        self.ops = [Op(self, o, i + 1) for i, o in enumerate(ops['list'])]
+        mcgrps = spec.get('mcast-groups', {})
+        self.mcgrp_enum_name = mcgrps.get('enum-name')
+        self.mcgrp_prefix = mcgrps.get('name-prefix')
+        self.mcgrps = mcgrps.get('list', [])
+        for op in self.ops:
+            if op.mcgrp is not None and op.mcgrp not in (g['name'] for g in self.mcgrps):
+                raise Exception(f'operation "{op.name}": unknown multicast group "{op.mcgrp}"')
+
+
+def c_upper(name):
+    return name.upper().replace('-', '_')
+
+
+def c_lower(name):
+    return name.lower().replace('-', '_')
+
+
+def rust_camel(name):
+    return ''.join(p.capitalize() for p in name.split('-'))
+
+
+def doc_block(doc, indent='', style='c'):
+    """Formats a doc string as C doc comment or Rust doc comment."""
+    if not doc:
+        return ''
+    lines = doc.rstrip().split('\n')
+    if style in ('rust', 'rust-plain'):
+        prefix = '///' if style == 'rust' else '//'
+        return ''.join(f'{indent}{prefix} {l}'.rstrip() + '\n' for l in lines)
+    if len(lines) == 1:
+        return f'{indent}/** {lines[0]} */\n'
+    out = f'{indent}/**\n'
+    for l in lines:
+        out += f'{indent} * {l}'.rstrip() + '\n'
+    return out + f'{indent} */\n'
+
+
+# ######################################## include/gnl_foobar_xmpl_prop.h
+
+
+def gen_prop_header(family):
+    out = LICENSE_C + '\n#pragma once\n\n'
+    out += '/*\n'
+    out += ' * This file describes the common properties of our custom Netlink family on top of Generic Netlink.\n'
+    out += ' * It is used by all C projects, i.e. the Kernel driver, and the userland components.\n'
+    out += ' *\n'
+    out += f' * {GENERATED_NOTE}\n'
+    out += ' */\n\n'
+    out += doc_block(family.doc)
+    out += f'#define FAMILY_NAME "{family.name}"\n\n'
+
+    unspec_doc = doc_block('0 is never used (=> UNSPEC), you can also see this in other family definitions in Linux code.\n'
+                           'We do the same, although I\'m not sure, if this is really enforced by code.', '    ')
+    marker_doc = '    /** Unused marker field to get the length/count of enum entries. No real attribute. */\n'
+
+    for attr_set in family.attr_sets.values():
+        p = attr_set.name_prefix
+        e = attr_set.enum_name
+        out += doc_block(attr_set.doc)
+        out += f'enum {e} {{\n'
+        out += unspec_doc + f'    {p}UNSPEC,\n'
+        for a in attr_set.attrs:
+            out += doc_block(a.doc, '    ') + f'    {a.enum_name},\n'
+        out += marker_doc + f'    __{p}MAX,\n'
+        out += '};\n'
+        out += f'/**\n * Number of elements in `enum {e}`.\n */\n'
+        out += f'#define {e}_ENUM_LEN (__{p}MAX)\n'
+        out += f'/**\n * The number of actual usable attributes in `enum {e}`.\n'
+        out += f' * This is `{e}_ENUM_LEN` - 1 because "UNSPEC" is never used.\n */\n'
+        out += f'#define {e}_COUNT ({e}_ENUM_LEN - 1)\n'
+        out += f'/**\n * Highest attribute number in `enum {e}`. An attribute policy\n'
+        out += f' * needs `{p}MAX + 1` entries.\n */\n'
+        out += f'#define {p}MAX (__{p}MAX - 1)\n\n'
+
+    p = family.ops_prefix
+    e = family.ops_enum_name
+    out += doc_block(family.ops_doc)
+    out += f'enum {e} {{\n'
+    out += unspec_doc + f'    {p}UNSPEC,\n\n'
+    out += '    // first real command is "1" (>0)\n'
+    for op in family.ops:
+        out += doc_block(op.doc, '    ') + f'    {op.enum_name},\n\n'
+    out += '    /** Unused marker field to get the length/count of enum entries. No real command. */\n'
+    out += f'    __{p}MAX,\n'
+    out += '};\n'
+    out += f'/**\n * Number of elements in `enum {e}`.\n */\n'
+    out += f'#define {e}_ENUM_LEN (__{p}MAX)\n'
+    out += f'/**\n * The number of actual usable commands in `enum {e}`.\n'
+    out += f' * This is `{e}_ENUM_LEN` - 1 because "UNSPEC" is never used.\n */\n'
+    out += f'#define {e}_COUNT ({e}_ENUM_LEN - 1)\n'
+
+    if family.mcgrps:
+        p = family.mcgrp_prefix
+        out += '\n/**\n * Multicast groups of the family. The values are the indices into the groups of the family in the\n'
+        out += ' * kernel, not the group ids; the userland resolves the ids by name via the Generic Netlink control\n'
+        out += ' * interface (`CTRL_ATTR_MCAST_GROUPS`).\n */\n'
+        out += f'enum {family.mcgrp_enum_name} {{\n'
+        for g in family.mcgrps:
+            out += doc_block(g.get('doc'), '    ') + f'    {p}{c_upper(g["name"])},\n'
+        out += '};\n'
+        for g in family.mcgrps:
+            out += f'/** Name of the multicast group `{p}{c_upper(g["name"])}`. */\n'
+            out += f'#define {p}{c_upper(g["name"])}_NAME "{g["name"]}"\n'
+    return out
+
+
+# ######################################## kernel-mod/gnl_foobar_xmpl_nl.h
+
+
+def kernel_range_name(a):
+    """Name of the `struct netlink_range_validation` of an attribute with a range beyond s16."""
+    return f'gnl_foobar_xmpl_{c_lower(a.name)}_range'
+
+
+def kernel_needs_full_range(a):
+    # min and max of `struct nla_policy` are s16; larger ranges go through a pointer
+    return a.type in SCALAR_TYPES and 'min' in a.checks and 'max' in a.checks and \
+        not (-32768 <= a.checks['min'] and a.checks['max'] <= 32767)
+
+
+def kernel_policy_entry(a):
+    checks = a.checks
+    if a.type in SCALAR_TYPES:
+        nla_type = SCALAR_TYPES[a.type][0]
+        if kernel_needs_full_range(a):
+            return f'NLA_POLICY_FULL_RANGE({nla_type}, &{kernel_range_name(a)})'
+        if 'min' in checks and 'max' in checks:
+            return f'NLA_POLICY_RANGE({nla_type}, {checks["min"]}, {checks["max"]})'
+        if 'max' in checks:
+            return f'NLA_POLICY_MAX({nla_type}, {checks["max"]})'
+        if 'min' in checks:
+            return f'NLA_POLICY_MIN({nla_type}, {checks["min"]})'
+        return f'{{.type = {nla_type}}}'
+    if a.type == 'flag':
+        return '{.type = NLA_FLAG}'
+    if a.type == 'pad':
+        return '{.type = NLA_UNSPEC}'
+    nla_type = 'NLA_NUL_STRING' if a.type == 'string' else 'NLA_BINARY'
+    if 'max-len' in checks:
+        return f'{{.type = {nla_type}, .len = {checks["max-len"]}}}'
+    return f'{{.type = {nla_type}}}'
+
+
+def gen_kernel_header(family):
+    main = family.attr_sets['main']
+    out = LICENSE_C + '\n#pragma once\n\n'
+    out += '/*\n'
+    out += ' * Attribute policy and operations of the "gnl_foobar_xmpl" family for the kernel module.\n'
+    out += ' * Included exactly once by "gnl_foobar_xmpl.c"; see there for a detailed description of the\n'
+    out += ' * fields of `struct genl_ops` and `struct nla_policy`.\n'
+    out += ' *\n'
+    out += f' * {GENERATED_NOTE}\n'
+    out += ' */\n\n'
+    out += '#include <net/genetlink.h>\n\n#include "gnl_foobar_xmpl_prop.h"\n\n'
+
+    out += '// Handlers of the operations. Documentation is on the implementation of these functions.\n'
+    handlers = []
+    table_ops = [op for op in family.ops if op.has_handler()]
+    for op in table_ops:
+        if op.do:
+            handlers.append(f'int {op.do["handler"]}(struct sk_buff *sender_skb, struct genl_info *info);')
+        if op.dump:
+            handlers.append(f'int {op.dump["handler"]}(struct sk_buff *pre_allocated_skb, struct netlink_callback *cb);')
+            for cb in ('start', 'done'):
+                if cb in op.dump:
+                    handlers.append(f'int {op.dump[cb]}(struct netlink_callback *cb);')
+    out += '\n'.join(dict.fromkeys(handlers)) + '\n\n'
+
+    for a in main.attrs:
+        if kernel_needs_full_range(a):
+            out += f'/** Range of `{a.enum_name}`; too large for `NLA_POLICY_RANGE()`. */\n'
+            signed = '_signed' if a.type.startswith('s') else ''
+            out += f'static const struct netlink_range_validation{signed} {kernel_range_name(a)} = {{\n'
+            out += f'        .min = {a.checks["min"]},\n        .max = {a.checks["max"]},\n}};\n\n'
+    out += '/**\n * Attribute policy: defines which attribute has which type (e.g int, char * etc).\n'
+    out += ' * This get validated for each received Generic Netlink message, if not deactivated\n'
+    out += ' * in `gnl_foobar_xmpl_ops[].validate`.\n */\n'
+    out += f'static const struct nla_policy gnl_foobar_xmpl_policy[{main.name_prefix}MAX + 1] = {{\n'
+    out += f'        [{main.name_prefix}UNSPEC] = {{.type = NLA_UNSPEC}},\n'
+    for a in main.attrs:
+        out += f'        [{a.enum_name}] = {kernel_policy_entry(a)},\n'
+    out += '};\n\n'
+
+    notifications = len(family.ops) - len(table_ops)
+    if notifications:
+        out += '/**\n * The length of `struct genl_ops gnl_foobar_xmpl_ops[]`. One entry per command, except for the\n'
+        out += ' * notifications, which the kernel only sends.\n */\n'
+        out += f'#define GNL_FOOBAR_OPS_LEN ({family.ops_enum_name}_COUNT - {notifications})\n\n'
+    else:
+        out += '/**\n * The length of `struct genl_ops gnl_foobar_xmpl_ops[]`. One entry per command.\n */\n'
+        out += f'#define GNL_FOOBAR_OPS_LEN ({family.ops_enum_name}_COUNT)\n\n'
+    out += '/**\n * Array with all operations that our protocol on top of Generic Netlink supports.\n */\n'
+    out += 'static const struct genl_ops gnl_foobar_xmpl_ops[GNL_FOOBAR_OPS_LEN] = {\n'
+    for op in table_ops:
+        flags = ' | '.join(f'GENL_{c_upper(f)}' for f in op.flags) or '0'
+        out += '        {\n'
+        out += f'                .cmd = {op.enum_name},\n'
+        out += f'                .flags = {flags},\n'
+        if op.do:
+            out += f'                .doit = {op.do["handler"]},\n'
+        if op.dump:
+            out += f'                .dumpit = {op.dump["handler"]},\n'
+            if 'start' in op.dump:
+                out += f'                .start = {op.dump["start"]},\n'
+            if 'done' in op.dump:
+                out += f'                .done = {op.dump["done"]},\n'
+        out += '                .validate = 0,\n'
+        out += '        },\n'
+    out += '};\n'
+
+    if family.mcgrps:
+        p = family.mcgrp_prefix
+        out += '\n/**\n * Multicast groups of the family; indexed by `enum ' + family.mcgrp_enum_name + '`.\n */\n'
+        out += 'static const struct genl_multicast_group gnl_foobar_xmpl_mcgrps[] = {\n'
+        for g in family.mcgrps:
+            out += f'        [{p}{c_upper(g["name"])}] = {{.name = {p}{c_upper(g["name"])}_NAME}},\n'
+        out += '};\n'
+    return out
+
+
+# ######################################## user-c/gnl_foobar_xmpl_codec.h
+
+
+def c_put_function(a):
+    fn = f'gnl_foobar_xmpl_put_{a.c_name}'
+    if a.type == 'string':
+        return (f'static inline struct nlattr *{fn}(struct nlmsghdr *nlh, const char *value) {{\n'
+                f'    return __gnl_foobar_xmpl_put(nlh, {a.enum_name}, value, strlen(value) + 1);\n}}\n')
+    if a.type == 'binary':
+        return (f'static inline struct nlattr *{fn}(struct nlmsghdr *nlh, const void *value, __u32 len) {{\n'
+                f'    return __gnl_foobar_xmpl_put(nlh, {a.enum_name}, value, len);\n}}\n')
+    if a.type == 'flag':
+        return (f'static inline struct nlattr *{fn}(struct nlmsghdr *nlh) {{\n'
+                f'    return __gnl_foobar_xmpl_put(nlh, {a.enum_name}, NULL, 0);\n}}\n')
+    c_type = SCALAR_TYPES[a.type][1]
+    return (f'static inline struct nlattr *{fn}(struct nlmsghdr *nlh, {c_type} value) {{\n'
+            f'    return __gnl_foobar_xmpl_put(nlh, {a.enum_name}, &value, sizeof(value));\n}}\n')
+
+
+def c_struct_fields(attr_set):
+    out = ''
+    for a in attr_set.attrs:
+        if a.type == 'string':
+            out += f'    /** `{a.enum_name}`; null-terminated */\n    const char *{a.c_name};\n'
+        elif a.type == 'binary':
+            out += f'    /** `{a.enum_name}` */\n    const void *{a.c_name};\n'
+            out += f'    /** Length of `{a.c_name}` in bytes. */\n    __u32 {a.c_name}_len;\n'
+        elif a.type in SCALAR_TYPES:
+            out += f'    /** `{a.enum_name}` */\n    {SCALAR_TYPES[a.type][1]} {a.c_name};\n'
+    return out
+
+
+def c_parse_case(a):
+    out = f'        case {a.enum_name}:\n'
+    if a.type == 'string':
+        out += f'            if (len == 0 || ((const char *) data)[len - 1] != \'\\0\') {{\n                return -1;\n            }}\n'
+        out += f'            attrs->{a.c_name} = data;\n'
+    elif a.type == 'binary':
+        out += f'            attrs->{a.c_name} = data;\n            attrs->{a.c_name}_len = len;\n'
+    elif a.type == 'flag':
+        pass
+    else:
+        c_type = SCALAR_TYPES[a.type][1]
+        out += f'            if (len != sizeof({c_type})) {{\n                return -1;\n            }}\n'
+        out += f'            memcpy(&attrs->{a.c_name}, data, sizeof({c_type}));\n'
+    out += f'            attrs->present |= 1ULL << {a.enum_name};\n'
+    out += '            break;\n'
+    return out
+
+
+def gen_c_codec(family):
+    out = LICENSE_C + '\n#pragma once\n\n'
+    out += '/*\n'
+    out += ' * Specialized encoders and decoders for the messages of the "gnl_foobar_xmpl" family for userland C\n'
+    out += ' * programs. Header only, no dependencies except the Linux UAPI headers.\n'
+    out += ' *\n'
+    out += ' * Encoding: `gnl_foobar_xmpl_<command>_init()` writes the Netlink and Generic Netlink header into a\n'
+    out += ' * buffer, afterwards `gnl_foobar_xmpl_put_<attribute>()` appends typed attributes. The caller must\n'
+    out += ' * ensure that the buffer is big enough. Payloads longer than `GNL_FOOBAR_XMPL_MAX_ATTR_LEN` are\n'
+    out += ' * rejected (NULL) and leave the message unchanged.\n'
+    out += ' * Decoding: `gnl_foobar_xmpl_<command>_reply_parse()` fills a struct with all attributes that the\n'
+    out += ' * reply of the command can carry in one pass over the message; `gnl_foobar_xmpl_<notification>_parse()`\n'
+    out += ' * the same for notifications of the kernel.\n'
+    out += ' *\n'
+    out += f' * {GENERATED_NOTE}\n'
+    out += ' */\n\n'
+    out += '#include <string.h>\n\n#include <linux/netlink.h>\n#include <linux/genetlink.h>\n\n'
+    out += '#include "gnl_foobar_xmpl_prop.h"\n\n'
+    out += '/** Version that is put into the Generic Netlink header of requests. */\n'
+    out += f'#define GNL_FOOBAR_XMPL_VERSION {family.version}\n\n'
+    out += '/** Tests if attribute `attr` was present in the parsed message. */\n'
+    out += '#define GNL_FOOBAR_XMPL_ATTR_PRESENT(attrs, attr) ((((attrs)->present) >> (attr)) & 1)\n\n'
+    out += '/** Max. payload of an attribute: the length including the header must fit into the u16 `nla_len`. */\n'
+    out += '#define GNL_FOOBAR_XMPL_MAX_ATTR_LEN (0xffff - NLA_HDRLEN)\n\n'
+
+    out += '''static inline struct nlmsghdr *__gnl_foobar_xmpl_init(void *buf, __u16 family_id, __u16 flags, __u32 seq, __u8 cmd) {
+    struct nlmsghdr *nlh = buf;
+    struct genlmsghdr *gnlh = (struct genlmsghdr *) NLMSG_DATA(nlh);
+
+    nlh->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    nlh->nlmsg_type = family_id;
+    nlh->nlmsg_flags = NLM_F_REQUEST | flags;
+    nlh->nlmsg_seq = seq;
+    nlh->nlmsg_pid = 0;
+    gnlh->cmd = cmd;
+    gnlh->version = GNL_FOOBAR_XMPL_VERSION;
+    gnlh->reserved = 0;
+    return nlh;
+}
+
+static inline struct nlattr *__gnl_foobar_xmpl_put(struct nlmsghdr *nlh, __u16 type, const void *data, __u32 len) {
+    struct nlattr *na = (struct nlattr *) ((char *) nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+    if (len > GNL_FOOBAR_XMPL_MAX_ATTR_LEN) {
+        return NULL;
+    }
+    na->nla_type = type;
+    na->nla_len = NLA_HDRLEN + len;
+    if (len) {
+        memcpy((char *) na + NLA_HDRLEN, data, len);
+    }
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NLA_ALIGN(na->nla_len);
+    return na;
+}
+
+'''
+    for op in family.ops:
+        if not op.has_handler():
+            continue
+        out += f'/** Initializes a `{op.enum_name}` request in `buf`. `NLM_F_REQUEST` is always set. */\n'
+        out += (f'static inline struct nlmsghdr *gnl_foobar_xmpl_{op.c_name}_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {{\n'
+                f'    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, {op.enum_name});\n}}\n\n')
+
+    for attr_set in family.attr_sets.values():
+        for a in attr_set.attrs:
+            if a.type == 'pad':
+                continue
+            out += f'/** Appends `{a.enum_name}` to the message. */\n'
+            out += c_put_function(a) + '\n'
+
+        out += f'/** Decoded attributes of `enum {attr_set.enum_name}`. Pointers point into the received message. */\n'
+        out += f'struct {attr_set.c_struct} {{\n'
+        out += '    /** Bit `1 << <attribute>` is set for each present attribute; see `GNL_FOOBAR_XMPL_ATTR_PRESENT`. */\n'
+        out += '    __u64 present;\n'
+        out += c_struct_fields(attr_set)
+        out += '};\n\n'
+
+    for op in family.ops:
+        reply = op.reply_attrs()
+        if not reply:
+            continue
+        st = op.attr_set.c_struct
+        what = 'notification' if op.event else 'reply'
+        out += f'/**\n * Parses the {what} of `{op.enum_name}` (`nlh` must not be a NLMSG_ERROR message).\n'
+        out += f' * Attributes that the {what} of this command never carries are skipped.\n *\n'
+        out += ' * @return < 0 on malformed messages or 0 on success.\n */\n'
+        fn = f'{op.c_name}_parse' if op.event else f'{op.c_name}_reply_parse'
+        out += f'static inline int gnl_foobar_xmpl_{fn}(const struct nlmsghdr *nlh, struct {st} *attrs) {{\n'
+        out += '    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;\n'
+        out += '    const char *end = (const char *) nlh + nlh->nlmsg_len;\n\n'
+        out += '    memset(attrs, 0, sizeof(*attrs));\n'
+        out += '    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {\n        return -1;\n    }\n'
+        out += '    while (end - pos >= NLA_HDRLEN) {\n'
+        out += '        const struct nlattr *na = (const struct nlattr *) pos;\n'
+        out += '        const void *data = pos + NLA_HDRLEN;\n'
+        out += '        __u32 len = na->nla_len - NLA_HDRLEN;\n\n'
+        out += '        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {\n            return -1;\n        }\n'
+        out += '        switch (na->nla_type & NLA_TYPE_MASK) {\n'
+        for a in reply:
+            out += c_parse_case(a)
+        out += '        default:\n            break;\n'
+        out += '        }\n'
+        out += '        pos += NLA_ALIGN(na->nla_len);\n'
+        out += '    }\n    return 0;\n}\n\n'
+    return out.rstrip('\n') + '\n'
+
+
+# ######################################## user-rust/src/protocol.rs and user-rust/src/codec.rs
+
+
+def gen_rust_protocol(family):
+    out = f'// {GENERATED_NOTE}\n\n'
+    out += 'use neli::neli_enum;\n\n'
+    out += '// Variants are documented with regular comments because `neli_enum` generates the enum itself.\n\n'
+    out += '/// Name of the Netlink family registered via Generic Netlink\n'
+    out += f'pub const FAMILY_NAME: &str = "{family.name}";\n\n'
+    out += '/// This is for the "cmd" field in Generic Netlink header.\n'
+    out += f'/// {family.ops_rust_name} corresponds to "enum {family.ops_enum_name}" in "gnl_foobar_xmpl_prop.h".\n'
+    out += '/// Describes what callback function shall be invoked in the linux kernel module.\n'
+    out += '#[neli_enum(serialized_type = "u8")]\n'
+    out += f'pub enum {family.ops_rust_name} {{\n    Unspec = 0,\n'
+    for op in family.ops:
+        out += doc_block(op.doc, '    ', 'rust-plain') + f'    {op.rust_name} = {op.value},\n'
+    out += '}\n'
+    out += f'impl neli::consts::genl::Cmd for {family.ops_rust_name} {{}}\n'
+    for attr_set in family.attr_sets.values():
+        out += '\n'
+        out += '/// Describes the value type to data mappings inside the generic netlink packet payload.\n'
+        out += f'/// {attr_set.rust_name} corresponds to "enum {attr_set.enum_name}" in "gnl_foobar_xmpl_prop.h".\n'
+        out += '#[neli_enum(serialized_type = "u16")]\n'
+        out += f'pub enum {attr_set.rust_name} {{\n    Unspec = 0,\n'
+        for a in attr_set.attrs:
+            out += doc_block(a.doc, '    ', 'rust-plain') + f'    {a.rust_name} = {a.value},\n'
+        out += '}\n'
+        out += f'impl neli::consts::genl::NlAttrType for {attr_set.rust_name} {{}}\n'
+    for g in family.mcgrps:
+        out += '\n' + doc_block(g.get('doc'), '', 'rust')
+        out += f'pub const MCGRP_{c_upper(g["name"])}: &str = "{g["name"]}";\n'
+    return out
+
+
+def rust_field_type(a):
+    if a.type == 'string':
+        return "Option<&'a str>"
+    if a.type == 'binary':
+        return "Option<&'a [u8]>"
+    if a.type == 'flag':
+        return 'bool'
+    return f'Option<{SCALAR_TYPES[a.type][2]}>'
+
+
+def rust_put_function(a):
+    fn = f'put_{a.c_name}'
+    if a.type == 'string':
+        return (f'pub fn {fn}(buf: &mut Vec<u8>, value: &str) -> Result<(), CodecError> {{\n'
+                f'    if value.len() + 1 > MAX_ATTR_LEN {{\n'
+                f'        return Err(CodecError::TooLong({a.value}));\n    }}\n'
+                f'    put_attr(buf, {a.value}, &[value.as_bytes(), &[0]]);\n    Ok(())\n}}\n')
+    if a.type == 'binary':
+        return (f'pub fn {fn}(buf: &mut Vec<u8>, value: &[u8]) -> Result<(), CodecError> {{\n'
+                f'    if value.len() > MAX_ATTR_LEN {{\n'
+                f'        return Err(CodecError::TooLong({a.value}));\n    }}\n'
+                f'    put_attr(buf, {a.value}, &[value]);\n    Ok(())\n}}\n')
+    if a.type == 'flag':
+        return f'pub fn {fn}(buf: &mut Vec<u8>) {{\n    put_attr(buf, {a.value}, &[]);\n}}\n'
+    rt = SCALAR_TYPES[a.type][2]
+    return (f'pub fn {fn}(buf: &mut Vec<u8>, value: {rt}) {{\n'
+            f'    put_attr(buf, {a.value}, &[&value.to_ne_bytes()]);\n}}\n')
+
+
+def rust_parse_arm(a):
+    if a.type == 'string':
+        body = (f'let s = match data.split_last() {{\n'
+                f'                    Some((0, s)) => s,\n'
+                f'                    _ => return Err(CodecError::InvalidAttribute({a.value})),\n'
+                f'                }};\n'
+                f'                attrs.{a.c_name} = Some(str::from_utf8(s).map_err(|_| CodecError::InvalidAttribute({a.value}))?);')
+    elif a.type == 'binary':
+        body = f'attrs.{a.c_name} = Some(data);'
+    elif a.type == 'flag':
+        body = f'attrs.{a.c_name} = true;'
+    else:
+        rt = SCALAR_TYPES[a.type][2]
+        body = (f'let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute({a.value}))?;\n'
+                f'                attrs.{a.c_name} = Some({rt}::from_ne_bytes(bytes));')
+    return f'            {a.value} => {{\n                {body}\n            }}\n'
+
+
+def gen_rust_codec(family):
+    out = f'// {GENERATED_NOTE}\n\n'
+    out += '//! Specialized encoders and decoders for the messages of the "gnl_foobar_xmpl" family that work\n'
+    out += '//! on plain byte buffers (e.g. for raw sockets). Independent of `neli`.\n'
+    out += '//!\n'
+    out += '//! Encoding: `<command>_init()` writes the Netlink and Generic Netlink header into a buffer,\n'
+    out += '//! afterwards `put_<attribute>()` appends typed attributes. Strings and binary payloads longer\n'
+    out += '//! than `MAX_ATTR_LEN` are rejected with `CodecError::TooLong` and leave the buffer unchanged.\n'
+    out += '//! Decoding: `<command>_reply_parse()` decodes all attributes that the reply of the command can\n'
+    out += '//! carry in one pass over the message; `<notification>_parse()` the same for notifications of\n'
+    out += '//! the kernel.\n\n'
+    out += 'use std::convert::TryInto;\nuse std::str;\n\n'
+    out += '''/// Length of `struct nlmsghdr`.
+pub const NLMSG_HDRLEN: usize = 16;
+/// Length of `struct genlmsghdr`.
+pub const GENL_HDRLEN: usize = 4;
+/// Length of `struct nlattr`.
+pub const NLA_HDRLEN: usize = 4;
+/// Netlink flag that marks requests; always set by the encoders.
+pub const NLM_F_REQUEST: u16 = 0x1;
+/// Max. payload of an attribute: the length including the header must fit into the u16 `nla_len`.
+pub const MAX_ATTR_LEN: usize = 0xffff - NLA_HDRLEN;
+'''
+    out += f'/// Version that is put into the Generic Netlink header of requests.\npub const VERSION: u8 = {family.version};\n\n'
+    out += '''/// Errors of the encoders and decoders.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CodecError {
+    /// The message is shorter than its headers claim.
+    Truncated,
+    /// The attribute with the given type has an invalid length or content.
+    InvalidAttribute(u16),
+    /// The payload of the attribute with the given type is longer than `MAX_ATTR_LEN`.
+    TooLong(u16),
+}
+
+/// Netlink alignment (4 bytes).
+#[inline]
+fn align(len: usize) -> usize {
+    (len + 3) & !3
+}
+
+fn init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32, cmd: u8) {
+    buf.clear();
+    buf.extend_from_slice(&((NLMSG_HDRLEN + GENL_HDRLEN) as u32).to_ne_bytes());
+    buf.extend_from_slice(&family_id.to_ne_bytes());
+    buf.extend_from_slice(&(NLM_F_REQUEST | flags).to_ne_bytes());
+    buf.extend_from_slice(&seq.to_ne_bytes());
+    // port id; assigned by the kernel
+    buf.extend_from_slice(&0_u32.to_ne_bytes());
+    buf.extend_from_slice(&[cmd, VERSION, 0, 0]);
+}
+
+fn put_attr(buf: &mut Vec<u8>, nla_type: u16, parts: &[&[u8]]) {
+    let len: usize = NLA_HDRLEN + parts.iter().map(|p| p.len()).sum::<usize>();
+    // checked by the callers
+    debug_assert!(len <= 0xffff);
+    buf.resize(align(buf.len()), 0);
+    buf.extend_from_slice(&(len as u16).to_ne_bytes());
+    buf.extend_from_slice(&nla_type.to_ne_bytes());
+    for p in parts {
+        buf.extend_from_slice(p);
+    }
+    buf.resize(align(buf.len()), 0);
+    let nlmsg_len = buf.len() as u32;
+    buf[0..4].copy_from_slice(&nlmsg_len.to_ne_bytes());
+}
+
+/// Returns the attribute stream of the Generic Netlink message `msg`.
+fn attr_stream(msg: &[u8]) -> Result<&[u8], CodecError> {
+    if msg.len() < NLMSG_HDRLEN + GENL_HDRLEN {
+        return Err(CodecError::Truncated);
+    }
+    let nlmsg_len = u32::from_ne_bytes(msg[0..4].try_into().unwrap()) as usize;
+    if nlmsg_len < NLMSG_HDRLEN + GENL_HDRLEN || nlmsg_len > msg.len() {
+        return Err(CodecError::Truncated);
+    }
+    Ok(&msg[NLMSG_HDRLEN + GENL_HDRLEN..nlmsg_len])
+}
+
+/// Returns the next attribute `(type, payload, rest)` of an attribute stream.
+fn next_attr(stream: &[u8]) -> Result<(u16, &[u8], &[u8]), CodecError> {
+    let len = u16::from_ne_bytes(stream[0..2].try_into().unwrap()) as usize;
+    let nla_type = u16::from_ne_bytes(stream[2..4].try_into().unwrap()) & 0x3fff;
+    if len < NLA_HDRLEN || len > stream.len() {
+        return Err(CodecError::Truncated);
+    }
+    let rest = &stream[align(len).min(stream.len())..];
+    Ok((nla_type, &stream[NLA_HDRLEN..len], rest))
+}
+
+'''
+    for op in family.ops:
+        if not op.has_handler():
+            continue
+        out += f'/// Initializes a `{op.enum_name}` request in `buf`. `NLM_F_REQUEST` is always set.\n'
+        out += (f'pub fn {op.c_name}_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {{\n'
+                f'    init(buf, family_id, flags, seq, {op.value});\n}}\n\n')
+
+    for attr_set in family.attr_sets.values():
+        for a in attr_set.attrs:
+            if a.type == 'pad':
+                continue
+            out += f'/// Appends `{a.enum_name}` to the message.\n' + rust_put_function(a) + '\n'
+        out += f'/// Decoded attributes of `enum {attr_set.enum_name}`. Slices point into the received message.\n'
+        out += '#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]\n'
+        out += f"pub struct {attr_set.rust_struct}<'a> {{\n"
+        for a in attr_set.attrs:
+            if a.type == 'pad':
+                continue
+            out += f'    /// `{a.enum_name}`\n    pub {a.c_name}: {rust_field_type(a)},\n'
+        if not any(a.type in ('string', 'binary') for a in attr_set.attrs):
+            out += "    _marker: std::marker::PhantomData<&'a ()>,\n"
+        out += '}\n\n'
+
+    for op in family.ops:
+        reply = op.reply_attrs()
+        if not reply:
+            continue
+        st = op.attr_set.rust_struct
+        what = 'notification' if op.event else 'reply'
+        out += f'/// Parses the {what} of `{op.enum_name}` (`msg` must not be a NLMSG_ERROR message).\n'
+        out += f'/// Attributes that the {what} of this command never carries are skipped.\n'
+        fn = f'{op.c_name}_parse' if op.event else f'{op.c_name}_reply_parse'
+        out += f"pub fn {fn}(msg: &[u8]) -> Result<{st}<'_>, CodecError> {{\n"
+        out += f'    let mut attrs = {st}::default();\n'
+        out += '    let mut stream = attr_stream(msg)?;\n'
+        out += '    while stream.len() >= NLA_HDRLEN {\n'
+        out += '        let (nla_type, data, rest) = next_attr(stream)?;\n'
+        out += '        match nla_type {\n'
+        for a in reply:
+            out += rust_parse_arm(a)
+        out += '            _ => {}\n'
+        out += '        }\n'
+        out += '        stream = rest;\n'
+        out += '    }\n'
+        out += '    Ok(attrs)\n}\n\n'
+    return out.rstrip('\n') + '\n'
+
+
+GENERATORS = {
+    'include/gnl_foobar_xmpl_prop.h': gen_prop_header,
+    'kernel-mod/gnl_foobar_xmpl_nl.h': gen_kernel_header,
+    'user-c/gnl_foobar_xmpl_codec.h': gen_c_codec,
+    'user-rust/src/protocol.rs': gen_rust_protocol,
+    'user-rust/src/codec.rs': gen_rust_codec,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='only check that the generated files are up to date')
+    args = parser.parse_args()
+
+    with open(SPEC_PATH) as f:
+        family = Family(yaml.safe_load(f))
+
+    outdated = []
+    for path, generator in GENERATORS.items():
+        full_path = os.path.join(REPO_ROOT, path)
+        content = generator(family)
+        try:
+            with open(full_path) as f:
+                current = f.read()
+        except FileNotFoundError:
+            current = None
+        if current == content:
+            continue
+        outdated.append(path)
+        if not args.check:
+            with open(full_path, 'w') as f:
+                f.write(content)
+            print(f'generated {path}')
+
+    if args.check and outdated:
+        print('out of date (run "python3 tools/gnl-gen.py"): ' + ', '.join(outdated), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
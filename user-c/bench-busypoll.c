@@ -0,0 +1,194 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Effect of busy polling (see `gnl_client_set_busy_poll()`) on the latency of requests through the
+ * submission queue of "gnl-submit.h", where replies arrive asynchronously: the receiver thread
+ * waits for datagrams and producers wait for their reply. Without busy polling, both are put to
+ * sleep and every reply pays for the wakeups.
+ *
+ * For several spin budgets, `threads` producers send small echo requests. Prints the latency
+ * percentiles per request, the CPU time (user + system of the whole process) per request, and how
+ * often spinning paid off in the receiver and in the producers.
+ *
+ * Usage: ./bench-busypoll [threads] [requests per thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "gnl-submit.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-busypoll] "
+
+#define DEFAULT_THREADS 4
+#define DEFAULT_REQUESTS 20000
+#define BUF_LEN 256
+#define ECHO_MSG "Some data that has `char` in it."
+
+/** Spin budgets in nanoseconds; 0 is the blocking baseline. */
+static const __u64 budgets_ns[] = {0, 1000, 5000, 20000, 100000};
+
+struct worker {
+    pthread_t thread;
+    struct gnl_submit_queue *queue;
+    long requests;
+    /** Latency of each request in ns. */
+    __u64 *samples;
+    long failures;
+};
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static double rusage_cpu_ns(void) {
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e9 + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1e3;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    const __u64 x = *(const __u64 *) a, y = *(const __u64 *) b;
+    return x < y ? -1 : x > y;
+}
+
+static double hit_rate(unsigned long hits, unsigned long misses) {
+    return hits + misses ? 100.0 * hits / (hits + misses) : 0;
+}
+
+static void *worker_thread(void *arg) {
+    struct worker *w = arg;
+    char req[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    char resp[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    long i;
+
+    for (i = 0; i < w->requests; i++) {
+        struct nlmsghdr *nlh = gnl_foobar_xmpl_echo_msg_init(req, w->queue->client.family_id, 0, 0);
+        __u64 start;
+        ssize_t len;
+
+        gnl_foobar_xmpl_put_msg(nlh, ECHO_MSG);
+        start = monotonic_ns();
+        len = gnl_submit(w->queue, nlh, resp, sizeof(resp));
+        w->samples[i] = monotonic_ns() - start;
+        if (len < 0 || ((struct nlmsghdr *) resp)->nlmsg_type == NLMSG_ERROR) {
+            w->failures++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Runs all workers with the spin budget `budget_ns` and prints one line of results.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int bench(__u64 budget_ns, struct worker *workers, int threads, long requests, __u64 *all) {
+    struct gnl_submit_queue *queue = malloc(sizeof(*queue));
+    long n = threads * requests, failures = 0;
+    double cpu_ns;
+    int i;
+
+    if (queue == NULL || gnl_submit_open(queue, budget_ns) < 0) {
+        free(queue);
+        return -1;
+    }
+    cpu_ns = rusage_cpu_ns();
+    for (i = 0; i < threads; i++) {
+        workers[i].queue = queue;
+        workers[i].requests = requests;
+        workers[i].failures = 0;
+        if (pthread_create(&workers[i].thread, NULL, worker_thread, &workers[i]) != 0) {
+            fprintf(stderr, LOG_PREFIX "can't start thread\n");
+            return -1;
+        }
+    }
+    for (i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        memcpy(all + i * requests, workers[i].samples, requests * sizeof(*all));
+        failures += workers[i].failures;
+    }
+    cpu_ns = rusage_cpu_ns() - cpu_ns;
+    gnl_submit_close(queue);
+
+    qsort(all, n, sizeof(*all), compare_u64);
+    printf("%9llu | %8llu | %8llu | %8llu | %8llu | %11.0f | %10.1f%% | %12.1f%% | %8ld\n",
+           (unsigned long long) budget_ns,
+           (unsigned long long) all[n / 2],
+           (unsigned long long) all[n * 99 / 100],
+           (unsigned long long) all[n * 999 / 1000],
+           (unsigned long long) all[n - 1],
+           cpu_ns / n,
+           hit_rate(queue->client.busy_poll.hits, queue->client.busy_poll.misses),
+           hit_rate(queue->stats.wait_spin_hits, queue->stats.wait_spin_misses),
+           failures);
+    free(queue);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int threads = argc > 1 ? atoi(argv[1]) : DEFAULT_THREADS;
+    long requests = argc > 2 ? atol(argv[2]) : DEFAULT_REQUESTS;
+    struct worker *workers;
+    __u64 *all;
+    size_t b;
+    int i;
+
+    if (threads <= 0 || requests <= 0) {
+        fprintf(stderr, "usage: %s [threads] [requests per thread]\n", argv[0]);
+        return 1;
+    }
+    workers = calloc(threads, sizeof(*workers));
+    all = malloc(threads * requests * sizeof(*all));
+    if (workers == NULL || all == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < threads; i++) {
+        workers[i].samples = malloc(requests * sizeof(__u64));
+        if (workers[i].samples == NULL) {
+            fprintf(stderr, LOG_PREFIX "out of memory\n");
+            return 1;
+        }
+    }
+
+    printf(LOG_PREFIX "%d threads, %ld echo requests per thread; latencies in ns\n", threads, requests);
+    printf("budget ns |      p50 |      p99 |    p99.9 |      max | cpu ns/req  | rx spin hit | wait spin hit | failures\n");
+    for (b = 0; b < sizeof(budgets_ns) / sizeof(budgets_ns[0]); b++) {
+        if (bench(budgets_ns[b], workers, threads, requests, all) < 0) {
+            return 1;
+        }
+    }
+
+    for (i = 0; i < threads; i++) {
+        free(workers[i].samples);
+    }
+    free(workers);
+    free(all);
+    return 0;
+}
@@ -0,0 +1,263 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Hit rates and latencies of the client side cache (see "gnl-cache.h") for read-heavy mixes. Each
+ * operation is a read with the probability 1 - writes and a write otherwise:
+ *   - read:  one of `READ_KINDS` read-only requests (GET_CONFIG, RING_STATS and echoes of
+ *            `ECHO_PAYLOAD_LEN` bytes with different payloads), chosen at random
+ *   - write: a RING_DOORBELL, which changes the ring statistics and hence the generation
+ * Every mix runs without the cache ("off") and with both ways to validate cached replies ("query",
+ * "notify"). Reported are the hit rate and the mean and 99th percentile latency of the reads.
+ *
+ * Usage: ./bench-cache [operations per mix]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-cache.h"
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-cache] "
+
+#define DEFAULT_OPERATIONS 100000
+#define ECHO_PAYLOAD_LEN 4096
+/** GET_CONFIG, RING_STATS and 4 echoes. */
+#define READ_KINDS 6
+#define BUF_LEN (ECHO_PAYLOAD_LEN + 1024)
+
+enum cache_mode {
+    CACHE_MODE_OFF,
+    CACHE_MODE_QUERY,
+    CACHE_MODE_NOTIFY,
+};
+
+static const char *const mode_names[] = {
+        [CACHE_MODE_OFF] = "off",
+        [CACHE_MODE_QUERY] = "query",
+        [CACHE_MODE_NOTIFY] = "notify",
+};
+
+/** Write ratios of the mixes in percent. */
+static const int write_percents[] = {0, 1, 10, 50};
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    __u64 x = *(const __u64 *) a, y = *(const __u64 *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Sends `nlh` and receives the reply into `buf`.
+ *
+ * @return < 0 on failure or on an error reply, or 0 on success.
+ */
+static int request(struct gnl_client *client, struct nlmsghdr *nlh, char *buf) {
+    if (gnl_client_send(client, nlh) < 0 || gnl_client_recv(client, buf, BUF_LEN) < 0) {
+        return -1;
+    }
+    if (((struct nlmsghdr *) buf)->nlmsg_type == NLMSG_ERROR) {
+        gnl_msg_print_err((struct nlmsghdr *) buf, LOG_PREFIX);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Creates a ring; only its statistics are used, hence it is never mapped.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int ring_create(struct gnl_client *client, __u32 *id) {
+    char buf[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+
+    nlh = gnl_foobar_xmpl_ring_create_init(buf, client->family_id, 0, client->seq++);
+    gnl_foobar_xmpl_put_ring_entries(nlh, 1);
+    gnl_foobar_xmpl_put_ring_slot_size(nlh, 64);
+    if (request(client, nlh, buf) < 0 || gnl_foobar_xmpl_ring_create_reply_parse((struct nlmsghdr *) buf, &attrs) < 0 ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_RING_ID)) {
+        fprintf(stderr, LOG_PREFIX "RING_CREATE failed\n");
+        return -1;
+    }
+    *id = attrs.ring_id;
+    return 0;
+}
+
+static void ring_destroy(struct gnl_client *client, __u32 id) {
+    char buf[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh;
+
+    nlh = gnl_foobar_xmpl_ring_destroy_init(buf, client->family_id, NLM_F_ACK, client->seq++);
+    gnl_foobar_xmpl_put_ring_id(nlh, id);
+    if (gnl_client_send(client, nlh) == 0) {
+        gnl_client_recv(client, buf, BUF_LEN);
+    }
+}
+
+/**
+ * Builds the read request `kind` into `buf`.
+ */
+static struct nlmsghdr *read_init(struct gnl_client *client, int kind, __u32 ring_id, const char *payload, char *buf) {
+    struct nlmsghdr *nlh;
+
+    switch (kind) {
+        case 0:
+            return gnl_foobar_xmpl_get_config_init(buf, client->family_id, 0, client->seq++);
+        case 1:
+            nlh = gnl_foobar_xmpl_ring_stats_init(buf, client->family_id, 0, client->seq++);
+            gnl_foobar_xmpl_put_ring_id(nlh, ring_id);
+            return nlh;
+        default:
+            // the echoes differ in their payload only
+            nlh = gnl_foobar_xmpl_echo_msg_init(buf, client->family_id, 0, client->seq++);
+            gnl_foobar_xmpl_put_data(nlh, payload + kind, ECHO_PAYLOAD_LEN);
+            return nlh;
+    }
+}
+
+/**
+ * Runs one mix and prints a line of the result table.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int run_mix(struct gnl_client *client, enum cache_mode mode, int write_percent, long operations,
+                   __u32 ring_id, const char *payload, __u64 *latencies) {
+    char req[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    char *resp = malloc(BUF_LEN);
+    struct gnl_cache cache;
+    struct nlmsghdr *nlh;
+    double sum_ns = 0;
+    long i, reads = 0;
+    int rc = -1;
+
+    if (resp == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return -1;
+    }
+    if (mode != CACHE_MODE_OFF &&
+        gnl_cache_open(&cache, client, mode == CACHE_MODE_QUERY ? GNL_CACHE_VALIDATE_QUERY : GNL_CACHE_VALIDATE_NOTIFY) < 0) {
+        free(resp);
+        return -1;
+    }
+    srand(1);
+    for (i = 0; i < operations; i++) {
+        __u64 start;
+        ssize_t len;
+
+        if (rand() % 100 < write_percent) {
+            nlh = gnl_foobar_xmpl_ring_doorbell_init(req, client->family_id, 0, client->seq++);
+            gnl_foobar_xmpl_put_ring_id(nlh, ring_id);
+            if (request(client, nlh, resp) < 0) {
+                goto out;
+            }
+            continue;
+        }
+
+        nlh = read_init(client, rand() % READ_KINDS, ring_id, payload, req);
+        start = monotonic_ns();
+        if (mode == CACHE_MODE_OFF) {
+            len = request(client, nlh, resp) < 0 ? -1 : 0;
+        } else {
+            len = gnl_cache_request(&cache, nlh, resp, BUF_LEN);
+        }
+        latencies[reads] = monotonic_ns() - start;
+        if (len < 0 || ((struct nlmsghdr *) resp)->nlmsg_type == NLMSG_ERROR ||
+            ((struct genlmsghdr *) NLMSG_DATA(resp))->cmd != ((struct genlmsghdr *) NLMSG_DATA(nlh))->cmd) {
+            fprintf(stderr, LOG_PREFIX "invalid reply\n");
+            goto out;
+        }
+        sum_ns += latencies[reads];
+        reads++;
+    }
+
+    qsort(latencies, reads, sizeof(*latencies), cmp_u64);
+    printf("%6s | %6d%% | %7.1f%% | %12.0f | %11llu\n", mode_names[mode], write_percent,
+           mode == CACHE_MODE_OFF || reads == 0 ? 0.0 : 100.0 * cache.stats.hits / reads,
+           reads > 0 ? sum_ns / reads : 0.0, reads > 0 ? (unsigned long long) latencies[reads * 99 / 100] : 0ULL);
+    if (mode != CACHE_MODE_OFF) {
+        gnl_cache_print_stats(stdout, "       cache: ", &cache);
+    }
+    rc = 0;
+
+out:
+    if (mode != CACHE_MODE_OFF) {
+        gnl_cache_close(&cache);
+    }
+    free(resp);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    struct gnl_client client;
+    long operations = argc > 1 ? atol(argv[1]) : DEFAULT_OPERATIONS;
+    char payload[ECHO_PAYLOAD_LEN + READ_KINDS];
+    __u64 *latencies;
+    __u32 ring_id;
+    size_t i;
+    int mode, rc = 0;
+
+    if (operations <= 0) {
+        fprintf(stderr, "usage: %s [operations per mix]\n", argv[0]);
+        return 1;
+    }
+    latencies = malloc(operations * sizeof(*latencies));
+    if (latencies == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < sizeof(payload); i++) {
+        payload[i] = (char) i;
+    }
+    if (gnl_client_open(&client) < 0) {
+        free(latencies);
+        return 1;
+    }
+    if (ring_create(&client, &ring_id) < 0) {
+        gnl_client_close(&client);
+        free(latencies);
+        return 1;
+    }
+
+    printf(LOG_PREFIX "%ld operations per mix, %d kinds of reads, echoes of %d bytes\n", operations, READ_KINDS,
+           ECHO_PAYLOAD_LEN);
+    printf("  mode | writes  | hit rate | read ns mean | read ns p99\n");
+    for (i = 0; i < sizeof(write_percents) / sizeof(write_percents[0]) && rc == 0; i++) {
+        for (mode = CACHE_MODE_OFF; mode <= CACHE_MODE_NOTIFY && rc == 0; mode++) {
+            rc = run_mix(&client, mode, write_percents[i], operations, ring_id, payload, latencies);
+        }
+    }
+
+    ring_destroy(&client, ring_id);
+    gnl_client_close(&client);
+    free(latencies);
+    return rc == 0 ? 0 : 1;
+}
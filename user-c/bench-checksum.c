@@ -0,0 +1,263 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Throughput of CRC32C (`GNL_FOOBAR_XMPL_C_CHECKSUM`) in the kernel against CRC32C in the userland.
+ * For payloads from 64 B to 32 KiB it hashes the same data
+ *   - user sw:      table driven (slicing-by-8) in this process
+ *   - user sse4.2:  with the CRC32 instruction in this process (x86 with SSE 4.2 only)
+ *   - kernel:       one payload per CHECKSUM request
+ *   - kernel batch: as many payloads per CHECKSUM request as fit into `BATCH_LEN`
+ * The kernel numbers include the transfer of the data, i.e. they are what a client pays to send
+ * and verify data in one round trip. All digests of the kernel are compared with the userland.
+ *
+ * Usage: ./bench-checksum [MiB per measurement]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-checksum] "
+
+#define DEFAULT_MIB 64
+#define MIN_PAYLOAD_LEN 64
+#define MAX_PAYLOAD_LEN (32 * 1024)
+/** Payload bytes per batched request. */
+#define BATCH_LEN (60 * 1024)
+#define MAX_BATCH (BATCH_LEN / MIN_PAYLOAD_LEN)
+/** Space for the Netlink and Generic Netlink headers. */
+#define HEADROOM 64
+
+/** CRC32C (Castagnoli) polynomial, reflected. */
+#define CRC32C_POLY 0x82f63b78U
+
+static __u32 crc32c_table[8][256];
+
+static void crc32c_init_table(void) {
+    __u32 i, j;
+
+    for (i = 0; i < 256; i++) {
+        __u32 crc = i;
+
+        for (j = 0; j < 8; j++) {
+            crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        }
+        crc32c_table[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+        for (j = 1; j < 8; j++) {
+            crc32c_table[j][i] = (crc32c_table[j - 1][i] >> 8) ^ crc32c_table[0][crc32c_table[j - 1][i] & 0xff];
+        }
+    }
+}
+
+/** Slicing-by-8: eight table lookups per 8 bytes. */
+static __u32 crc32c_sw(const void *data, size_t len) {
+    const unsigned char *p = data;
+    __u32 crc = ~0U;
+
+    for (; len >= 8; len -= 8, p += 8) {
+        __u32 lo, hi;
+
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = crc32c_table[7][lo & 0xff] ^ crc32c_table[6][(lo >> 8) & 0xff] ^ crc32c_table[5][(lo >> 16) & 0xff] ^
+              crc32c_table[4][lo >> 24] ^ crc32c_table[3][hi & 0xff] ^ crc32c_table[2][(hi >> 8) & 0xff] ^
+              crc32c_table[1][(hi >> 16) & 0xff] ^ crc32c_table[0][hi >> 24];
+    }
+    for (; len > 0; len--, p++) {
+        crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *p) & 0xff];
+    }
+    return ~crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) static __u32 crc32c_sse42(const void *data, size_t len) {
+    const unsigned char *p = data;
+    unsigned long long crc = ~0U;
+
+    for (; len >= 8; len -= 8, p += 8) {
+        unsigned long long v;
+
+        memcpy(&v, p, 8);
+        crc = __builtin_ia32_crc32di(crc, v);
+    }
+    for (; len > 0; len--, p++) {
+        crc = __builtin_ia32_crc32qi((__u32) crc, *p);
+    }
+    return ~(__u32) crc;
+}
+
+static int have_sse42(void) {
+    return __builtin_cpu_supports("sse4.2");
+}
+#else
+static __u32 crc32c_sse42(const void *data, size_t len) {
+    return crc32c_sw(data, len);
+}
+
+static int have_sse42(void) {
+    return 0;
+}
+#endif
+
+static double monotonic_s(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Hashes `count` payloads of `payload_len` bytes starting at `data` in the userland.
+ *
+ * @return the XOR of all digests, so that the compiler can't drop the work.
+ */
+static __u32 hash_user(__u32 (*crc32c)(const void *, size_t), const char *data, size_t payload_len, size_t count) {
+    __u32 acc = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        acc ^= crc32c(data + i * payload_len, payload_len);
+    }
+    return acc;
+}
+
+/**
+ * Hashes `count` payloads of `payload_len` bytes starting at `data` in the kernel with `batch`
+ * payloads per request, and compares each digest with the userland.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int hash_kernel(struct gnl_client *client, const char *data, size_t payload_len, size_t count, size_t batch,
+                       char *req, char *resp) {
+    size_t i, j;
+
+    for (i = 0; i < count; i += batch) {
+        size_t n = count - i < batch ? count - i : batch;
+        struct nlmsghdr *nlh = gnl_foobar_xmpl_checksum_init(req, client->family_id, 0, client->seq++);
+        struct nlmsghdr *reply = (struct nlmsghdr *) resp;
+        struct gnl_foobar_xmpl_attrs attrs;
+        __u32 checksums[MAX_BATCH];
+        ssize_t len;
+
+        for (j = 0; j < n; j++) {
+            gnl_foobar_xmpl_put_data(nlh, data + (i + j) * payload_len, payload_len);
+        }
+        if (gnl_client_send(client, nlh) < 0 || (len = gnl_client_recv(client, resp, BATCH_LEN + HEADROOM)) < 0 ||
+            !NLMSG_OK(reply, len)) {
+            return -1;
+        }
+        if (reply->nlmsg_type == NLMSG_ERROR) {
+            gnl_msg_print_err(reply, LOG_PREFIX);
+            return -1;
+        }
+        if (gnl_foobar_xmpl_checksum_reply_parse(reply, &attrs) < 0 || attrs.checksums_len != n * sizeof(__u32)) {
+            fprintf(stderr, LOG_PREFIX "invalid CHECKSUM reply\n");
+            return -1;
+        }
+        memcpy(checksums, attrs.checksums, attrs.checksums_len);
+        for (j = 0; j < n; j++) {
+            if (checksums[j] != crc32c_sw(data + (i + j) * payload_len, payload_len)) {
+                fprintf(stderr, LOG_PREFIX "digest of payload %zu differs from the userland\n", i + j);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    long mib = argc > 1 ? atol(argv[1]) : DEFAULT_MIB;
+    struct gnl_client client;
+    char *data, *req, *resp;
+    size_t total, payload_len, i;
+    int sse42 = have_sse42();
+    int rc = 0;
+
+    if (mib <= 0) {
+        fprintf(stderr, "usage: %s [MiB per measurement]\n", argv[0]);
+        return 1;
+    }
+    total = (size_t) mib << 20;
+    crc32c_init_table();
+    // the standard check value of CRC32C
+    if (crc32c_sw("123456789", 9) != 0xe3069283 || crc32c_sse42("123456789", 9) != 0xe3069283) {
+        fprintf(stderr, LOG_PREFIX "userland CRC32C is broken\n");
+        return 1;
+    }
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    data = malloc(total);
+    req = malloc(BATCH_LEN + MAX_BATCH * NLA_HDRLEN + HEADROOM);
+    resp = malloc(BATCH_LEN + HEADROOM);
+    if (data == NULL || req == NULL || resp == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < total / sizeof(__u64); i++) {
+        ((__u64 *) data)[i] = i * 0x9e3779b97f4a7c15ULL;
+    }
+
+    printf(LOG_PREFIX "%ld MiB per measurement, MiB/s (kernel: incl. the transfer)\n", mib);
+    printf("   bytes | user sw | user sse4.2 |  kernel | kernel batch (payloads)\n");
+    for (payload_len = MIN_PAYLOAD_LEN; payload_len <= MAX_PAYLOAD_LEN && rc == 0; payload_len *= 8) {
+        size_t count = total / payload_len;
+        size_t batch = BATCH_LEN / payload_len;
+        double t0, t1, t2, t3, t4;
+        volatile __u32 sink;
+
+        t0 = monotonic_s();
+        sink = hash_user(crc32c_sw, data, payload_len, count);
+        t1 = monotonic_s();
+        if (sse42) {
+            sink = hash_user(crc32c_sse42, data, payload_len, count);
+        }
+        t2 = monotonic_s();
+        rc = hash_kernel(&client, data, payload_len, count, 1, req, resp);
+        t3 = monotonic_s();
+        if (rc == 0) {
+            rc = hash_kernel(&client, data, payload_len, count, batch, req, resp);
+        }
+        t4 = monotonic_s();
+        (void) sink;
+        if (rc == 0) {
+            char sse42_col[16] = "n/a";
+
+            if (sse42) {
+                snprintf(sse42_col, sizeof(sse42_col), "%.0f", mib / (t2 - t1));
+            }
+            printf("%8zu | %7.0f | %11s | %7.0f | %7.0f (%zu)\n", payload_len, mib / (t1 - t0), sse42_col,
+                   mib / (t3 - t2), mib / (t4 - t3), batch);
+        }
+    }
+
+    free(data);
+    free(req);
+    free(resp);
+    gnl_client_close(&client);
+    return rc == 0 ? 0 : 1;
+}
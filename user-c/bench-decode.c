@@ -0,0 +1,274 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* End-to-end time of large echo dumps (`GNL_FOOBAR_XMPL_C_ECHO_MSG` with `NLM_F_DUMP`) with the dump
+ * consumer of "gnl-dump.h" for 0, 1, 2, 4, ... decoding workers, compared with a plain loop that receives
+ * and decodes one datagram after another (like "bench-dump.c"). Every record goes through a callback that
+ * checks that the records arrive in the order of the dump: the kernel numbers them 0, 1, 2, ... in the
+ * sequence number of their header. Reported per number of workers are the time per dump, the record
+ * rate, the speedup over the plain loop, the CPU time per record (all threads), the share of the records
+ * that the receiving thread had to decode itself and how long it waited for the workers.
+ *
+ * The number of records of a dump is the tunable "dump-runs". The benchmark refuses to run with
+ * less than `MIN_USEFUL_RECORDS` per dump; make the dumps large first:
+ *   $ sudo ./gnl-tune dump-runs=4000000 verbose=0
+ *   $ ./bench-decode
+ *
+ * Usage: ./bench-decode [max. workers] [dumps per setting]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "gnl-client.h"
+#include "gnl-config.h"
+#include "gnl-dump.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-decode] "
+
+#define DEFAULT_MAX_WORKERS 8
+#define DEFAULT_DUMPS 3
+/** Below this number of records per dump, the benchmark mostly measures the setup of the dumps. */
+#define MIN_USEFUL_RECORDS 1000000
+/** Receive buffer of the plain loop. */
+#define RECV_BUF_LEN (64 * 1024)
+
+/** State of the record callback. */
+struct consumer {
+    /** Sequence number of the next record. */
+    __u32 expected;
+    /** Summed up lengths of the messages, so that the callback reads every record. */
+    unsigned long long msg_bytes;
+    int out_of_order;
+};
+
+/** Results of one setting. */
+struct result {
+    long records;
+    double wall_ns;
+    double cpu_ns;
+};
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static double rusage_cpu_ns(void) {
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e9 + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1e3;
+}
+
+static int on_record(const struct nlmsghdr *nlh, const struct gnl_foobar_xmpl_attrs *attrs, void *arg) {
+    struct consumer *c = arg;
+
+    if (nlh->nlmsg_seq != c->expected++ || attrs->msg == NULL) {
+        c->out_of_order = 1;
+        return -1;
+    }
+    c->msg_bytes += strlen(attrs->msg);
+    return 0;
+}
+
+/**
+ * Receives and decodes one dump in the calling thread only, one datagram after another.
+ *
+ * @return < 0 on failure or the number of records.
+ */
+static long plain_dump(struct gnl_client *client, char *buf, struct consumer *c) {
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+    long records = 0;
+    ssize_t len;
+
+    nlh = gnl_foobar_xmpl_echo_msg_init(buf, client->family_id, NLM_F_DUMP, client->seq++);
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+    for (;;) {
+        len = gnl_client_recv(client, buf, RECV_BUF_LEN);
+        if (len < 0) {
+            return -1;
+        }
+        for (nlh = (struct nlmsghdr *) buf; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                return records;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                gnl_msg_print_err(nlh, LOG_PREFIX);
+                return -1;
+            }
+            if (gnl_foobar_xmpl_echo_msg_reply_parse(nlh, &attrs) < 0) {
+                fprintf(stderr, LOG_PREFIX "invalid dump record\n");
+                return -1;
+            }
+            if (on_record(nlh, &attrs, c) < 0) {
+                return -1;
+            }
+            records++;
+        }
+    }
+}
+
+/**
+ * Runs one dump with the plain loop if `dump` is NULL, or with the dump consumer otherwise.
+ *
+ * @return < 0 on failure or the number of records.
+ */
+static long dump_once(struct gnl_client *client, struct gnl_dump *dump, char *buf) {
+    struct consumer c = {0};
+    struct nlmsghdr *nlh;
+    long records;
+
+    if (dump == NULL) {
+        records = plain_dump(client, buf, &c);
+    } else {
+        nlh = gnl_foobar_xmpl_echo_msg_init(buf, client->family_id, NLM_F_DUMP, client->seq++);
+        records = gnl_dump_run(dump, nlh, gnl_foobar_xmpl_echo_msg_reply_parse, on_record, &c);
+    }
+    if (c.out_of_order) {
+        fprintf(stderr, LOG_PREFIX "record %u arrived out of order\n", c.expected - 1);
+        return -1;
+    }
+    return records;
+}
+
+/**
+ * Runs `dumps` dumps after one warm-up dump.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int run_setting(struct gnl_client *client, struct gnl_dump *dump, char *buf, long dumps,
+                       struct result *r) {
+    double cpu_ns;
+    __u64 start;
+    long i, rc;
+
+    if (dump_once(client, dump, buf) < 0) {
+        return -1;
+    }
+    if (dump != NULL) {
+        memset(&dump->stats, 0, sizeof(dump->stats));
+    }
+    memset(r, 0, sizeof(*r));
+    cpu_ns = rusage_cpu_ns();
+    start = monotonic_ns();
+    for (i = 0; i < dumps; i++) {
+        rc = dump_once(client, dump, buf);
+        if (rc < 0) {
+            return -1;
+        }
+        r->records += rc;
+    }
+    r->wall_ns = monotonic_ns() - start;
+    r->cpu_ns = rusage_cpu_ns() - cpu_ns;
+    return 0;
+}
+
+static void print_result(const char *name, const struct result *r, const struct result *plain, long dumps,
+                         const struct gnl_dump_stats *stats) {
+    printf("%9s | %12.2f | %10.2f | %7.2f | %13.1f", name, r->wall_ns / dumps / 1e6,
+           r->records / (r->wall_ns / 1e9) / 1e6, plain->wall_ns / r->wall_ns, r->cpu_ns / r->records);
+    if (stats == NULL) {
+        printf(" |         - |            -\n");
+    } else {
+        printf(" | %8.1f%% | %12.1f\n", 100.0 * stats->decoded_by_caller / stats->records,
+               stats->wait_ns / 1e3 / dumps);
+    }
+}
+
+int main(int argc, char **argv) {
+    struct gnl_foobar_xmpl_attrs config;
+    struct gnl_client client;
+    struct gnl_dump_stats stats = {0};
+    struct gnl_dump dump;
+    struct result plain, r;
+    int max_workers = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_WORKERS;
+    long dumps = argc > 2 ? atol(argv[2]) : DEFAULT_DUMPS;
+    int workers, rc = 1;
+    char name[16];
+    char *buf;
+
+    if (max_workers < 0 || max_workers > GNL_DUMP_MAX_WORKERS || dumps <= 0) {
+        fprintf(stderr, "usage: %s [max. workers (0..%d)] [dumps per setting]\n", argv[0], GNL_DUMP_MAX_WORKERS);
+        return 1;
+    }
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    buf = malloc(RECV_BUF_LEN);
+    if (buf == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        goto out_close;
+    }
+    if (gnl_config_get(&client, &config) < 0) {
+        goto out_free;
+    }
+    if (config.config_dump_runs == 0) {
+        fprintf(stderr, LOG_PREFIX "dumps have no records (tunable \"dump-runs\")\n");
+        goto out_free;
+    }
+    if (config.config_dump_runs < MIN_USEFUL_RECORDS) {
+        // the results would be noise, but look like measurements
+        fprintf(stderr, LOG_PREFIX "dumps have only %u records, at least %d are needed; make them larger, e.g. "
+                        "with \"sudo ./gnl-tune dump-runs=4000000 verbose=0\"\n", config.config_dump_runs,
+                MIN_USEFUL_RECORDS);
+        goto out_free;
+    }
+
+    printf(LOG_PREFIX "%ld dumps of %u records per setting, receive buffers of %d KiB\n", dumps,
+           config.config_dump_runs, GNL_DUMP_DEFAULT_BUF_LEN / 1024);
+    printf("  workers |  ms per dump | Mrecords/s | speedup | CPU ns/record | by caller | wait us/dump\n");
+    if (run_setting(&client, NULL, buf, dumps, &plain) < 0) {
+        goto out_free;
+    }
+    print_result("plain", &plain, &plain, dumps, NULL);
+
+    for (workers = 0; workers <= max_workers; workers = workers == 0 ? 1 : workers * 2) {
+        if (gnl_dump_open(&dump, &client, workers, 0) < 0) {
+            goto out_free;
+        }
+        if (run_setting(&client, &dump, buf, dumps, &r) < 0) {
+            gnl_dump_close(&dump);
+            goto out_free;
+        }
+        stats = dump.stats;
+        gnl_dump_close(&dump);
+        snprintf(name, sizeof(name), "%d", workers);
+        print_result(name, &r, &plain, dumps, &stats);
+    }
+    printf(LOG_PREFIX "per datagram: %.1f records; per receive buffer: %.1f records\n",
+           (double) stats.records / stats.datagrams, (double) stats.records / stats.buffers);
+    rc = 0;
+
+out_free:
+    free(buf);
+out_close:
+    gnl_client_close(&client);
+    return rc;
+}
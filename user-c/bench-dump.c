@@ -0,0 +1,136 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Benchmark for dumps (`GNL_FOOBAR_XMPL_C_ECHO_MSG` with `NLM_F_DUMP`). Each iteration requests a full
+ * dump and receives all records until NLMSG_DONE. Reports the wall time and the costs from CPU
+ * performance counters (see "perf-counters.h") per dump and per record.
+ *
+ * Usage: ./bench-dump [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+#include "perf-counters.h"
+
+#define LOG_PREFIX "[bench-dump] "
+
+#define DEFAULT_ITERATIONS 10000
+/** A single datagram of a dump can carry multiple records. */
+#define RECV_BUF_LEN (64 * 1024)
+
+/**
+ * Requests one dump and receives all records.
+ *
+ * @return < 0 on failure or the number of received records.
+ */
+static long dump_once(struct gnl_client *client, char *buf) {
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+    long records = 0;
+    ssize_t len;
+
+    nlh = gnl_foobar_xmpl_echo_msg_init(buf, client->family_id, NLM_F_DUMP, client->seq++);
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+
+    for (;;) {
+        len = gnl_client_recv(client, buf, RECV_BUF_LEN);
+        if (len < 0) {
+            return -1;
+        }
+        for (nlh = (struct nlmsghdr *) buf; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                return records;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                gnl_msg_print_err(nlh, LOG_PREFIX);
+                return -1;
+            }
+            if (gnl_foobar_xmpl_echo_msg_reply_parse(nlh, &attrs) < 0) {
+                fprintf(stderr, LOG_PREFIX "invalid dump record\n");
+                return -1;
+            }
+            records++;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    struct gnl_client client;
+    struct perf_counters pc;
+    struct timespec wall_start, wall_end;
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    long records = 0, rc = 0, i;
+    double wall_ns;
+    char *buf;
+
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    buf = malloc(RECV_BUF_LEN);
+    if (buf == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+    if (perf_counters_open(&pc) == 0) {
+        fprintf(stderr, LOG_PREFIX "no performance counters available (see perf_event_paranoid)\n");
+    }
+
+    // warm up (not measured)
+    if (dump_once(&client, buf) < 0) {
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    perf_counters_start(&pc);
+    for (i = 0; i < iterations && rc >= 0; i++) {
+        rc = dump_once(&client, buf);
+        records += rc;
+    }
+    perf_counters_stop(&pc);
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    if (rc < 0) {
+        return 1;
+    }
+    if (records == 0) {
+        fprintf(stderr, LOG_PREFIX "dumps returned no records\n");
+        return 1;
+    }
+
+    wall_ns = (wall_end.tv_sec - wall_start.tv_sec) * 1e9 + (wall_end.tv_nsec - wall_start.tv_nsec);
+    printf(LOG_PREFIX "%ld dumps with %ld records in total\n", iterations, records);
+    printf(LOG_PREFIX "wall ns per dump: %.2f, per record: %.2f\n", wall_ns / iterations, wall_ns / records);
+    perf_counters_print(&pc, LOG_PREFIX "per dump:  ", iterations);
+    perf_counters_print(&pc, LOG_PREFIX "per record:", records);
+
+    perf_counters_close(&pc);
+    free(buf);
+    gnl_client_close(&client);
+    return 0;
+}
@@ -0,0 +1,194 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Benchmark for echoing large binary payloads (`GNL_FOOBAR_XMPL_A_DATA`) through the kernel module.
+ * Reports the kernel CPU time (system time of this process; the .doit handler runs in the context
+ * of our sendto() syscall) per echoed byte for payloads from 4 KiB up to the largest payload that
+ * fits into an attribute (`nla_len` is a u16, hence 64 KiB - 5 bytes).
+ *
+ * To compare the copy with the zero-copy reply path of the kernel module, run it twice:
+ *   $ sudo ./gnl-tune zerocopy-echo=0 && ./bench-echo
+ *   $ sudo ./gnl-tune zerocopy-echo=1 && ./bench-echo
+ *
+ * Additionally the per echo costs from CPU performance counters (cycles, instructions, cache misses
+ * split into user and kernel mode, and context switches) are printed, see "perf-counters.h".
+ *
+ * Usage: ./bench-echo [iterations per payload size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "gnl-client.h"
+#include "gnl-config.h"
+#include "gnl_foobar_xmpl_codec.h"
+#include "perf-counters.h"
+
+#define LOG_PREFIX "[bench-echo] "
+
+#define DEFAULT_ITERATIONS 10000
+#define MIN_PAYLOAD_LEN (4 * 1024)
+/** The length of an attribute including its header must fit into the u16 `nla_len`. */
+#define MAX_PAYLOAD_LEN (0xffff - NLA_HDRLEN)
+/** Space for the Netlink, Generic Netlink and attribute headers in front of the payload. */
+#define HEADROOM 64
+
+/**
+ * Prints the current tunables of the kernel module, so that results can be matched to the
+ * kernel code path that produced them.
+ */
+static void print_config(struct gnl_client *client) {
+    struct gnl_foobar_xmpl_attrs config;
+
+    if (gnl_config_get(client, &config) == 0) {
+        gnl_config_print(stdout, LOG_PREFIX "kernel config: ", &config);
+    }
+}
+
+static double timeval_to_ns(const struct timeval *tv) {
+    return tv->tv_sec * 1e9 + tv->tv_usec * 1e3;
+}
+
+static double timespec_to_ns(const struct timespec *ts) {
+    return ts->tv_sec * 1e9 + ts->tv_nsec;
+}
+
+/**
+ * Sends one echo request with `payload` and receives the reply into `resp`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int echo_once(struct gnl_client *client, const char *payload, char *req, char *resp, size_t payload_len) {
+    struct nlmsghdr *nlh;
+
+    nlh = gnl_foobar_xmpl_echo_msg_init(req, client->family_id, 0, client->seq++);
+    gnl_foobar_xmpl_put_data(nlh, payload, payload_len);
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+    if (gnl_client_recv(client, resp, MAX_PAYLOAD_LEN + HEADROOM) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Echoes `iterations` payloads of size `payload_len` and prints the costs.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int bench_payload_len(struct gnl_client *client, struct perf_counters *pc, const char *payload, char *req,
+                             char *resp, size_t payload_len, long iterations) {
+    struct rusage ru_start, ru_end;
+    struct timespec wall_start, wall_end;
+    struct nlmsghdr *nlh = (struct nlmsghdr *) resp;
+    struct gnl_foobar_xmpl_attrs attrs;
+    double stime_ns, wall_ns, bytes;
+    long i;
+
+    // warm up (not measured); also verifies the reply
+    if (echo_once(client, payload, req, resp, payload_len) < 0) {
+        return -1;
+    }
+    if (nlh->nlmsg_type == NLMSG_ERROR) {
+        gnl_msg_print_err(nlh, LOG_PREFIX);
+        return -1;
+    }
+    if (gnl_foobar_xmpl_echo_msg_reply_parse(nlh, &attrs) < 0 ||
+        attrs.data_len != payload_len || memcmp(attrs.data, payload, payload_len) != 0) {
+        fprintf(stderr, LOG_PREFIX "invalid echo reply for payload length %zu\n", payload_len);
+        return -1;
+    }
+
+    getrusage(RUSAGE_SELF, &ru_start);
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    perf_counters_start(pc);
+    for (i = 0; i < iterations; i++) {
+        if (echo_once(client, payload, req, resp, payload_len) < 0) {
+            return -1;
+        }
+    }
+    perf_counters_stop(pc);
+    getrusage(RUSAGE_SELF, &ru_end);
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+
+    stime_ns = timeval_to_ns(&ru_end.ru_stime) - timeval_to_ns(&ru_start.ru_stime);
+    wall_ns = timespec_to_ns(&wall_end) - timespec_to_ns(&wall_start);
+    bytes = (double) payload_len * iterations;
+    printf("%8zu | %12.3f | %14.2f | %11.2f\n",
+           payload_len, stime_ns / bytes, stime_ns / iterations, wall_ns / iterations);
+    perf_counters_print(pc, "         per echo:", iterations);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    struct gnl_client client;
+    struct perf_counters pc;
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    char *payload, *req, *resp;
+    size_t payload_len;
+    int rc = 0;
+
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations per payload size]\n", argv[0]);
+        return 1;
+    }
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+
+    payload = malloc(MAX_PAYLOAD_LEN);
+    req = malloc(MAX_PAYLOAD_LEN + HEADROOM);
+    resp = malloc(MAX_PAYLOAD_LEN + HEADROOM);
+    if (payload == NULL || req == NULL || resp == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+    for (payload_len = 0; payload_len < MAX_PAYLOAD_LEN; payload_len++) {
+        payload[payload_len] = (char) payload_len;
+    }
+
+    if (perf_counters_open(&pc) == 0) {
+        fprintf(stderr, LOG_PREFIX "no performance counters available (see perf_event_paranoid)\n");
+    }
+    print_config(&client);
+    printf(LOG_PREFIX "%ld iterations per payload size\n", iterations);
+    printf("   bytes | kernel ns/B  | kernel ns/echo | wall ns/echo\n");
+    for (payload_len = MIN_PAYLOAD_LEN; rc == 0; payload_len *= 2) {
+        // powers of two, and the largest payload as the last step
+        if (payload_len > MAX_PAYLOAD_LEN) {
+            payload_len = MAX_PAYLOAD_LEN;
+        }
+        rc = bench_payload_len(&client, &pc, payload, req, resp, payload_len, iterations);
+        if (payload_len == MAX_PAYLOAD_LEN) {
+            break;
+        }
+    }
+
+    perf_counters_close(&pc);
+    free(payload);
+    free(req);
+    free(resp);
+    gnl_client_close(&client);
+    return rc == 0 ? 0 : 1;
+}
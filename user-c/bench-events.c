@@ -0,0 +1,296 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Costs of event delivery to many selective listeners (`GNL_FOOBAR_XMPL_C_EVENT`). Each listener
+ * thread has its own socket and is interested in one of `EVENT_TYPES` event types; the main thread
+ * emits events of all types round-robin. Two ways to listen are compared:
+ *   - group:  join the multicast group "events"; every listener gets every event and drops the
+ *             ones it isn't interested in
+ *   - filter: subscribe with a type mask; the kernel sends only matching events
+ * For both it prints the CPU time of all listeners, the datagrams each listener received and the
+ * CPU time of the emitter, which pays for the filtering in the kernel.
+ *
+ * Usage: ./bench-events [listeners] [rounds]
+ *   round: one event of each type
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-events] "
+
+#define DEFAULT_LISTENERS 64
+#define DEFAULT_ROUNDS 2000
+#define EVENT_TYPES 16
+#define PAYLOAD_LEN 64
+/**
+ * Max. rounds that the emitter runs ahead of the slowest listener. Keeps the unread events of each
+ * listener far below its receive buffer, which would drop events otherwise.
+ */
+#define WINDOW 4
+#define BUF_LEN 8192
+
+enum listen_mode {
+    LISTEN_MODE_GROUP,
+    LISTEN_MODE_FILTER,
+};
+
+static const char *const mode_names[] = {
+        [LISTEN_MODE_GROUP] = "group",
+        [LISTEN_MODE_FILTER] = "filter",
+};
+
+struct listener {
+    pthread_t thread;
+    struct gnl_client client;
+    __u32 type;
+    /** Received events of `type`. Protected by `progress_mtx`. */
+    long matched;
+    long datagrams;
+    double cpu_ns;
+    int failed;
+};
+
+static pthread_mutex_t progress_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t progress_cond = PTHREAD_COND_INITIALIZER;
+static pthread_barrier_t start_barrier;
+static long rounds = DEFAULT_ROUNDS;
+
+static double clock_ns(clockid_t clock) {
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Sends `nlh` with `NLM_F_ACK` set by the caller and waits for the ACK.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int request_ack(struct gnl_client *client, struct nlmsghdr *nlh) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *reply = (struct nlmsghdr *) buf;
+    ssize_t len;
+
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+    len = gnl_client_recv(client, buf, sizeof(buf));
+    if (len < 0 || !NLMSG_OK(reply, len) || reply->nlmsg_type != NLMSG_ERROR) {
+        return -1;
+    }
+    if (((struct nlmsgerr *) NLMSG_DATA(reply))->error != 0) {
+        gnl_msg_print_err(reply, LOG_PREFIX);
+        return -1;
+    }
+    return 0;
+}
+
+static void *listener_main(void *arg) {
+    struct listener *l = arg;
+    char buf[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    double start;
+    long matched = 0;
+
+    pthread_barrier_wait(&start_barrier);
+    start = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    while (matched < rounds) {
+        struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+        struct gnl_foobar_xmpl_attrs attrs;
+        ssize_t len = gnl_client_recv(&l->client, buf, sizeof(buf));
+
+        if (len < 0) {
+            // ENOBUFS: the receive buffer overflowed and events are lost
+            fprintf(stderr, LOG_PREFIX "listener for type %u: recv() failed: %s\n", l->type, strerror(errno));
+            l->failed = 1;
+            break;
+        }
+        l->datagrams++;
+        for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type != l->client.family_id || gnl_foobar_xmpl_event_parse(nlh, &attrs) < 0 ||
+                attrs.event_type != l->type) {
+                continue;
+            }
+            matched++;
+        }
+        pthread_mutex_lock(&progress_mtx);
+        l->matched = matched;
+        pthread_cond_signal(&progress_cond);
+        pthread_mutex_unlock(&progress_mtx);
+    }
+    l->cpu_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - start;
+
+    pthread_mutex_lock(&progress_mtx);
+    // unblocks the emitter if this listener failed
+    l->matched = rounds;
+    pthread_cond_signal(&progress_cond);
+    pthread_mutex_unlock(&progress_mtx);
+    return NULL;
+}
+
+/** Waits until every listener has received `min_matched` events of its type. */
+static void wait_for_listeners(struct listener *listeners, long n, long min_matched) {
+    long i;
+
+    pthread_mutex_lock(&progress_mtx);
+    for (i = 0; i < n; i++) {
+        while (listeners[i].matched < min_matched) {
+            pthread_cond_wait(&progress_cond, &progress_mtx);
+        }
+    }
+    pthread_mutex_unlock(&progress_mtx);
+}
+
+/**
+ * Emits `rounds` rounds of events and prints the costs for listeners in `mode`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int bench_mode(struct gnl_client *emitter, struct listener *listeners, long n, enum listen_mode mode) {
+    char req[512] __attribute__((aligned(NLMSG_ALIGNTO)));
+    char resp[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    char payload[PAYLOAD_LEN] = {0};
+    double wall_start, cpu_start, wall_ns, emitter_cpu_ns, listener_cpu_ns = 0;
+    long i, r, datagrams = 0, filtered = 0, started = 0;
+    int rc = 0;
+
+    for (i = 0; i < n; i++) {
+        struct listener *l = &listeners[i];
+        struct nlmsghdr *nlh;
+
+        memset(l, 0, sizeof(*l));
+        l->type = i % EVENT_TYPES;
+        if (gnl_client_open(&l->client) < 0) {
+            rc = -1;
+            break;
+        }
+        if (mode == LISTEN_MODE_GROUP) {
+            rc = gnl_client_join_group(&l->client, GNL_FOOBAR_XMPL_MCGRP_EVENTS_NAME);
+        } else {
+            nlh = gnl_foobar_xmpl_event_subscribe_init(req, l->client.family_id, NLM_F_ACK, l->client.seq++);
+            gnl_foobar_xmpl_put_event_type_mask(nlh, 1ULL << l->type);
+            rc = request_ack(&l->client, nlh);
+        }
+        if (rc < 0 || pthread_create(&l->thread, NULL, listener_main, l) != 0) {
+            gnl_client_close(&l->client);
+            rc = -1;
+            break;
+        }
+        started++;
+    }
+    if (rc < 0) {
+        // the started listeners wait at the barrier for the missing ones
+        fprintf(stderr, LOG_PREFIX "can't set up %ld listeners\n", n);
+        exit(1);
+    }
+
+    pthread_barrier_wait(&start_barrier);
+    wall_start = clock_ns(CLOCK_MONOTONIC);
+    cpu_start = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    for (r = 0; r < rounds && rc == 0; r++) {
+        __u32 type;
+
+        if (r >= WINDOW) {
+            wait_for_listeners(listeners, n, r - WINDOW);
+        }
+        for (type = 0; type < EVENT_TYPES; type++) {
+            struct nlmsghdr *nlh = gnl_foobar_xmpl_event_emit_init(req, emitter->family_id, 0, emitter->seq++);
+            struct nlmsghdr *reply = (struct nlmsghdr *) resp;
+            struct gnl_foobar_xmpl_attrs attrs;
+            char key[32];
+            ssize_t len;
+
+            snprintf(key, sizeof(key), "object/%u", type);
+            gnl_foobar_xmpl_put_event_type(nlh, type);
+            gnl_foobar_xmpl_put_event_key(nlh, key);
+            gnl_foobar_xmpl_put_data(nlh, payload, sizeof(payload));
+            if (gnl_client_send(emitter, nlh) < 0 || (len = gnl_client_recv(emitter, resp, sizeof(resp))) < 0 ||
+                !NLMSG_OK(reply, len)) {
+                rc = -1;
+                break;
+            }
+            if (reply->nlmsg_type == NLMSG_ERROR) {
+                gnl_msg_print_err(reply, LOG_PREFIX);
+                rc = -1;
+                break;
+            }
+            if (gnl_foobar_xmpl_event_emit_reply_parse(reply, &attrs) == 0) {
+                filtered += attrs.event_filtered;
+            }
+        }
+    }
+    emitter_cpu_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+    if (rc < 0) {
+        fprintf(stderr, LOG_PREFIX "emitting events failed\n");
+        exit(1);
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(listeners[i].thread, NULL);
+        // also ends the subscription
+        gnl_client_close(&listeners[i].client);
+        listener_cpu_ns += listeners[i].cpu_ns;
+        datagrams += listeners[i].datagrams;
+        rc |= -listeners[i].failed;
+    }
+    wall_ns = clock_ns(CLOCK_MONOTONIC) - wall_start;
+
+    printf("%-6s | %15.1f | %14.1f | %18.1f | %15ld | %7.1f\n", mode_names[mode], listener_cpu_ns / 1e6,
+           emitter_cpu_ns / 1e6, (double) datagrams / n, filtered, wall_ns / 1e6);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : DEFAULT_LISTENERS;
+    struct gnl_client emitter;
+    struct listener *listeners;
+    int rc;
+
+    rounds = argc > 2 ? atol(argv[2]) : DEFAULT_ROUNDS;
+    if (n <= 0 || rounds <= 0) {
+        fprintf(stderr, "usage: %s [listeners] [rounds]\n", argv[0]);
+        return 1;
+    }
+    listeners = calloc(n, sizeof(*listeners));
+    if (listeners == NULL || gnl_client_open(&emitter) < 0) {
+        return 1;
+    }
+    pthread_barrier_init(&start_barrier, NULL, n + 1);
+
+    printf(LOG_PREFIX "%ld listeners, %d event types, %ld events per type, %d B payload\n", n, EVENT_TYPES, rounds,
+           PAYLOAD_LEN);
+    printf("mode   | listener CPU ms | emitter CPU ms | datagrams/listener | filtered events | wall ms\n");
+    rc = bench_mode(&emitter, listeners, n, LISTEN_MODE_GROUP);
+    if (rc == 0) {
+        rc = bench_mode(&emitter, listeners, n, LISTEN_MODE_FILTER);
+    }
+
+    pthread_barrier_destroy(&start_barrier);
+    gnl_client_close(&emitter);
+    free(listeners);
+    return rc == 0 ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# Scaling benchmark for the network namespace aware family: creates N network namespaces
+# and runs "bench-echo" in all of them at the same time. Each namespace has its own
+# instance of the family state in the kernel module and the family is "parallel_ops",
+# hence the runs must not serialize on each other. Compare the total wall time with different numbers of namespaces.
+#
+# Usage: sh bench-netns.sh [number of namespaces] [iterations per payload size]
+# Requires root (ip netns) and a loaded kernel module.
+
+NAMESPACES=${1:-16}
+ITERATIONS=${2:-1000}
+NS_PREFIX="gnl_xmpl_bench_"
+LOG_DIR=$(mktemp -d)
+
+if [ ! -x ./bench-echo ]; then
+    echo "./bench-echo not found; run 'make bench-echo' first"
+    exit 1
+fi
+
+for i in $(seq 1 "$NAMESPACES"); do
+    sudo ip netns add "$NS_PREFIX$i" || exit 1
+done
+
+echo "running bench-echo ($ITERATIONS iterations per payload size) in $NAMESPACES network namespaces in parallel"
+START=$(date +%s%N)
+for i in $(seq 1 "$NAMESPACES"); do
+    sudo ip netns exec "$NS_PREFIX$i" ./bench-echo "$ITERATIONS" > "$LOG_DIR/$i.txt" 2>&1 &
+done
+wait
+END=$(date +%s%N)
+
+FAILED=0
+for i in $(seq 1 "$NAMESPACES"); do
+    # the row of the largest payload (64 KiB - 5 bytes) is the last one
+    if ! grep -q "65531 |" "$LOG_DIR/$i.txt"; then
+        echo "namespace $NS_PREFIX$i failed:"
+        cat "$LOG_DIR/$i.txt"
+        FAILED=1
+    fi
+    sudo ip netns delete "$NS_PREFIX$i"
+done
+
+echo "total wall time: $(( (END - START) / 1000000 )) ms for $NAMESPACES namespaces"
+echo "per namespace results: $LOG_DIR"
+exit $FAILED
@@ -0,0 +1,174 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Latency probe with `GNL_FOOBAR_XMPL_C_PING`. Each request carries the send timestamp of this
+ * program; the kernel adds a timestamp at the entry of its handler and one right before it sends
+ * the reply. All timestamps are CLOCK_MONOTONIC, hence each round trip splits into:
+ *   - request leg: sendto() until the handler runs (syscall, Netlink and Generic Netlink dispatch)
+ *   - service:     inside the handler (allocation and construction of the reply)
+ *   - reply leg:   genlmsg_reply() until recv() returned in this program (incl. wakeup)
+ * Prints the distribution (percentiles) of each of them.
+ *
+ * Usage: ./bench-ping [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-ping] "
+
+#define DEFAULT_ITERATIONS 100000
+#define BUF_LEN 256
+
+/** Measured parts of a round trip. */
+enum ping_leg {
+    PING_LEG_REQUEST,
+    PING_LEG_SERVICE,
+    PING_LEG_REPLY,
+    PING_LEG_ROUND_TRIP,
+    /** Unused marker field to get the number of legs. */
+    __PING_LEG_MAX,
+};
+
+static const char *const ping_leg_names[__PING_LEG_MAX] = {
+        [PING_LEG_REQUEST] = "request leg",
+        [PING_LEG_SERVICE] = "service",
+        [PING_LEG_REPLY] = "reply leg",
+        [PING_LEG_ROUND_TRIP] = "round trip",
+};
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    const __u64 x = *(const __u64 *) a, y = *(const __u64 *) b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Sends one ping and stores the duration of each leg in `legs`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int ping_once(struct gnl_client *client, char *buf, __u64 legs[__PING_LEG_MAX]) {
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+    struct nlattr *na;
+    __u64 send_ts, recv_ts;
+
+    nlh = gnl_foobar_xmpl_ping_init(buf, client->family_id, 0, client->seq++);
+    // reserve the attribute first; the timestamp is taken as late as possible
+    na = gnl_foobar_xmpl_put_client_ts(nlh, 0);
+    send_ts = monotonic_ns();
+    memcpy(NLA_DATA(na), &send_ts, sizeof(send_ts));
+    if (gnl_client_send(client, nlh) < 0 || gnl_client_recv(client, buf, BUF_LEN) < 0) {
+        return -1;
+    }
+    recv_ts = monotonic_ns();
+
+    nlh = (struct nlmsghdr *) buf;
+    if (nlh->nlmsg_type == NLMSG_ERROR) {
+        gnl_msg_print_err(nlh, LOG_PREFIX);
+        return -1;
+    }
+    if (gnl_foobar_xmpl_ping_reply_parse(nlh, &attrs) < 0 ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_KERNEL_RX_TS) ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_KERNEL_TX_TS) ||
+        attrs.client_ts != send_ts) {
+        fprintf(stderr, LOG_PREFIX "invalid ping reply\n");
+        return -1;
+    }
+    legs[PING_LEG_REQUEST] = attrs.kernel_rx_ts - send_ts;
+    legs[PING_LEG_SERVICE] = attrs.kernel_tx_ts - attrs.kernel_rx_ts;
+    legs[PING_LEG_REPLY] = recv_ts - attrs.kernel_tx_ts;
+    legs[PING_LEG_ROUND_TRIP] = recv_ts - send_ts;
+    return 0;
+}
+
+/**
+ * Sorts `samples` and prints the percentiles.
+ */
+static void print_distribution(const char *name, __u64 *samples, long n) {
+    qsort(samples, n, sizeof(*samples), compare_u64);
+    printf("%-11s | %8llu | %8llu | %8llu | %8llu | %8llu | %8llu\n", name,
+           (unsigned long long) samples[0],
+           (unsigned long long) samples[n / 2],
+           (unsigned long long) samples[n * 90 / 100],
+           (unsigned long long) samples[n * 99 / 100],
+           (unsigned long long) samples[n * 999 / 1000],
+           (unsigned long long) samples[n - 1]);
+}
+
+int main(int argc, char **argv) {
+    char buf[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct gnl_client client;
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    __u64 *samples[__PING_LEG_MAX];
+    __u64 legs[__PING_LEG_MAX];
+    long i;
+    int leg;
+
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    for (leg = 0; leg < __PING_LEG_MAX; leg++) {
+        samples[leg] = malloc(iterations * sizeof(__u64));
+        if (samples[leg] == NULL) {
+            fprintf(stderr, LOG_PREFIX "out of memory\n");
+            return 1;
+        }
+    }
+
+    // warm up (not measured)
+    if (ping_once(&client, buf, legs) < 0) {
+        return 1;
+    }
+    for (i = 0; i < iterations; i++) {
+        if (ping_once(&client, buf, legs) < 0) {
+            return 1;
+        }
+        for (leg = 0; leg < __PING_LEG_MAX; leg++) {
+            samples[leg][i] = legs[leg];
+        }
+    }
+
+    printf(LOG_PREFIX "%ld pings; all values in ns\n", iterations);
+    printf("            |      min |      p50 |      p90 |      p99 |    p99.9 |      max\n");
+    for (leg = 0; leg < __PING_LEG_MAX; leg++) {
+        print_distribution(ping_leg_names[leg], samples[leg], iterations);
+        free(samples[leg]);
+    }
+
+    gnl_client_close(&client);
+    return 0;
+}
@@ -0,0 +1,306 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Tail latency of echo requests while other sockets run large dumps, i.e. the effect of the dump
+ * quotas of the kernel module (tunables "dump-max-in-flight" and "dump-max-records"). The main
+ * thread sends small echoes one after another, first alone and then while `dumpers` threads (each
+ * with its own socket, but all of the same user, hence sharing "dump-max-in-flight") run echo dumps
+ * back to back. Dumps that the kernel rejects (EBUSY) are
+ * retried after a short pause. Reported are the mean, p50, p99 and max latency of the echoes in
+ * both phases and the accounting of all sockets (`GNL_FOOBAR_XMPL_C_PORT_STATS`), which shows
+ * how often the quotas throttled the dumps.
+ *
+ * Make the dumps large and compare the runs without and with quotas:
+ *   $ sudo ./gnl-tune dump-runs=4096 verbose=0
+ *   $ ./bench-quota
+ *   $ sudo ./gnl-tune dump-max-in-flight=1 dump-max-records=16
+ *   $ ./bench-quota
+ *
+ * Usage: ./bench-quota [dumpers] [echoes per phase]
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gnl-client.h"
+#include "gnl-config.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-quota] "
+
+#define DEFAULT_DUMPERS 4
+#define DEFAULT_ECHOES 100000
+/** A single datagram of a dump can carry multiple records. */
+#define RECV_BUF_LEN (64 * 1024)
+/** Pause of a dumper after its dump was rejected. */
+#define REJECT_BACKOFF_NS 100000
+
+struct dumper {
+    pthread_t thread;
+    struct gnl_client client;
+    long dumps;
+    long rejected;
+    long records;
+    int failed;
+};
+
+static pthread_barrier_t start_barrier;
+static volatile int stop;
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    __u64 x = *(const __u64 *) a, y = *(const __u64 *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Runs one dump and receives all records.
+ *
+ * @return < 0 on failure, 0 if the kernel rejected the dump or 1 if it is complete.
+ */
+static int dump_once(struct dumper *d, char *buf) {
+    struct gnl_ext_ack ack;
+    struct nlmsghdr *nlh;
+    ssize_t len;
+    int len_left;
+
+    nlh = gnl_foobar_xmpl_echo_msg_init(buf, d->client.family_id, NLM_F_DUMP, d->client.seq++);
+    if (gnl_client_send(&d->client, nlh) < 0) {
+        return -1;
+    }
+    for (;;) {
+        len = gnl_client_recv(&d->client, buf, RECV_BUF_LEN);
+        if (len < 0) {
+            return -1;
+        }
+        len_left = (int) len;
+        for (nlh = (struct nlmsghdr *) buf; NLMSG_OK(nlh, len_left); nlh = NLMSG_NEXT(nlh, len_left)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                return 1;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                if (gnl_msg_parse_err(nlh, &ack) == 0 && ack.error == -EBUSY) {
+                    return 0;
+                }
+                gnl_msg_print_err(nlh, LOG_PREFIX);
+                return -1;
+            }
+            d->records++;
+        }
+    }
+}
+
+static void *dumper_thread(void *arg) {
+    const struct timespec backoff = {.tv_sec = 0, .tv_nsec = REJECT_BACKOFF_NS};
+    struct dumper *d = arg;
+    char *buf = malloc(RECV_BUF_LEN);
+    int rc;
+
+    pthread_barrier_wait(&start_barrier);
+    if (buf == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        d->failed = 1;
+        return NULL;
+    }
+    while (!stop) {
+        rc = dump_once(d, buf);
+        if (rc < 0) {
+            d->failed = 1;
+            break;
+        }
+        if (rc == 0) {
+            d->rejected++;
+            nanosleep(&backoff, NULL);
+        } else {
+            d->dumps++;
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+/**
+ * Sends `echoes` small echoes one after another and prints a line of the result table.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int echo_phase(struct gnl_client *client, const char *phase, long echoes, __u64 *latencies) {
+    char buf[1024] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh;
+    double sum_ns = 0;
+    long i;
+
+    for (i = 0; i < echoes; i++) {
+        __u64 start = monotonic_ns();
+
+        nlh = gnl_foobar_xmpl_echo_msg_init(buf, client->family_id, 0, client->seq++);
+        gnl_foobar_xmpl_put_msg(nlh, "are you there?");
+        if (gnl_client_send(client, nlh) < 0 || gnl_client_recv(client, buf, sizeof(buf)) < 0) {
+            return -1;
+        }
+        latencies[i] = monotonic_ns() - start;
+        if (((struct nlmsghdr *) buf)->nlmsg_type == NLMSG_ERROR) {
+            gnl_msg_print_err((struct nlmsghdr *) buf, LOG_PREFIX);
+            return -1;
+        }
+        sum_ns += latencies[i];
+    }
+    qsort(latencies, echoes, sizeof(*latencies), cmp_u64);
+    printf("%-10s | %8ld | %8.0f | %8llu | %8llu | %9llu\n", phase, echoes, sum_ns / echoes,
+           (unsigned long long) latencies[echoes / 2], (unsigned long long) latencies[echoes * 99 / 100],
+           (unsigned long long) latencies[echoes - 1]);
+    return 0;
+}
+
+/**
+ * Prints the accounting of all sockets of the network namespace.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int print_port_stats(struct gnl_client *client) {
+    char *buf = malloc(RECV_BUF_LEN);
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+    ssize_t len;
+    int len_left, rc = -1;
+
+    if (buf == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return -1;
+    }
+    nlh = gnl_foobar_xmpl_port_stats_init(buf, client->family_id, NLM_F_DUMP, client->seq++);
+    if (gnl_client_send(client, nlh) < 0) {
+        goto out;
+    }
+    printf("   port id |    dumps | rejected |     runs | deferred |    records\n");
+    for (;;) {
+        len = gnl_client_recv(client, buf, RECV_BUF_LEN);
+        if (len < 0) {
+            goto out;
+        }
+        len_left = (int) len;
+        for (nlh = (struct nlmsghdr *) buf; NLMSG_OK(nlh, len_left); nlh = NLMSG_NEXT(nlh, len_left)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                rc = 0;
+                goto out;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                gnl_msg_print_err(nlh, LOG_PREFIX);
+                goto out;
+            }
+            if (gnl_foobar_xmpl_port_stats_reply_parse(nlh, &attrs) < 0) {
+                fprintf(stderr, LOG_PREFIX "invalid PORT_STATS record\n");
+                goto out;
+            }
+            printf("%10u | %8llu | %8llu | %8llu | %8llu | %10llu\n", attrs.port_id,
+                   (unsigned long long) attrs.port_dumps, (unsigned long long) attrs.port_dumps_rejected,
+                   (unsigned long long) attrs.port_dump_runs, (unsigned long long) attrs.port_dump_runs_deferred,
+                   (unsigned long long) attrs.port_dump_records);
+        }
+    }
+
+out:
+    free(buf);
+    return rc;
+}
+
+int main(int argc, char **argv) {
+    struct gnl_foobar_xmpl_attrs config;
+    struct gnl_client client;
+    struct dumper *dumpers;
+    int n_dumpers = argc > 1 ? atoi(argv[1]) : DEFAULT_DUMPERS;
+    long echoes = argc > 2 ? atol(argv[2]) : DEFAULT_ECHOES;
+    long dumps = 0, rejected = 0, records = 0;
+    __u64 *latencies;
+    int i, started = 0, rc = 1;
+
+    if (n_dumpers <= 0 || echoes <= 0) {
+        fprintf(stderr, "usage: %s [dumpers] [echoes per phase]\n", argv[0]);
+        return 1;
+    }
+    dumpers = calloc(n_dumpers, sizeof(*dumpers));
+    latencies = malloc(echoes * sizeof(*latencies));
+    if (dumpers == NULL || latencies == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        goto out_free;
+    }
+    if (gnl_client_open(&client) < 0) {
+        goto out_free;
+    }
+    if (gnl_config_get(&client, &config) == 0) {
+        gnl_config_print(stdout, LOG_PREFIX "config: ", &config);
+    }
+    for (; started < n_dumpers; started++) {
+        if (gnl_client_open(&dumpers[started].client) < 0) {
+            goto out_close;
+        }
+    }
+
+    printf(LOG_PREFIX "%ld echoes per phase, %d dumpers\n", echoes, n_dumpers);
+    printf("phase      |   echoes |  mean ns |   p50 ns |   p99 ns |    max ns\n");
+    if (echo_phase(&client, "alone", echoes, latencies) < 0) {
+        goto out_close;
+    }
+
+    pthread_barrier_init(&start_barrier, NULL, n_dumpers + 1);
+    for (i = 0; i < n_dumpers; i++) {
+        if (pthread_create(&dumpers[i].thread, NULL, dumper_thread, &dumpers[i]) != 0) {
+            fprintf(stderr, LOG_PREFIX "pthread_create() failed\n");
+            exit(1);
+        }
+    }
+    pthread_barrier_wait(&start_barrier);
+    rc = echo_phase(&client, "dumps", echoes, latencies) < 0;
+    stop = 1;
+    for (i = 0; i < n_dumpers; i++) {
+        pthread_join(dumpers[i].thread, NULL);
+        rc |= dumpers[i].failed;
+        dumps += dumpers[i].dumps;
+        rejected += dumpers[i].rejected;
+        records += dumpers[i].records;
+    }
+    pthread_barrier_destroy(&start_barrier);
+
+    printf(LOG_PREFIX "dumpers: %ld dumps complete, %ld rejected, %ld records\n", dumps, rejected, records);
+    // before the dumpers close their sockets, which ends their accounting
+    if (print_port_stats(&client) < 0) {
+        rc = 1;
+    }
+
+out_close:
+    for (i = 0; i < started; i++) {
+        gnl_client_close(&dumpers[i].client);
+    }
+    gnl_client_close(&client);
+out_free:
+    free(dumpers);
+    free(latencies);
+    return rc;
+}
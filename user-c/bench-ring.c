@@ -0,0 +1,169 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Compares the shared memory ring (see "gnl-ring.h") with `GNL_FOOBAR_XMPL_C_ECHO_MSG` requests that
+ * carry the payload in `GNL_FOOBAR_XMPL_A_DATA`. Both paths echo the same records through the kernel;
+ * the echo path costs a request and a reply per record, the ring one doorbell per batch of
+ * `RING_ENTRIES` records. Prints the wall time per record for payloads from 64 B to 16 KiB.
+ *
+ * Usage: ./bench-ring [records per payload size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-ring.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-ring] "
+
+#define DEFAULT_RECORDS 100000
+#define MIN_PAYLOAD_LEN 64
+#define MAX_PAYLOAD_LEN (16 * 1024)
+/** Slots per queue, i.e. the records per doorbell. */
+#define RING_ENTRIES 256
+/** Space for the Netlink, Generic Netlink and attribute headers in front of the payload. */
+#define HEADROOM 64
+
+static double monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Echoes `records` payloads with one ECHO_MSG request each.
+ *
+ * @return < 0 on failure or the wall time in ns.
+ */
+static double bench_echo(struct gnl_client *client, const char *payload, size_t payload_len, long records) {
+    static char req[MAX_PAYLOAD_LEN + HEADROOM] __attribute__((aligned(NLMSG_ALIGNTO)));
+    static char resp[MAX_PAYLOAD_LEN + HEADROOM] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = (struct nlmsghdr *) resp;
+    struct gnl_foobar_xmpl_attrs attrs;
+    double start = monotonic_ns();
+    long i;
+
+    for (i = 0; i < records; i++) {
+        struct nlmsghdr *req_nlh = gnl_foobar_xmpl_echo_msg_init(req, client->family_id, 0, client->seq++);
+
+        gnl_foobar_xmpl_put_data(req_nlh, payload, payload_len);
+        if (gnl_client_send(client, req_nlh) < 0 || gnl_client_recv(client, resp, sizeof(resp)) < 0) {
+            return -1;
+        }
+        // verify the first reply only; the costs of the comparison don't belong to the transport
+        if (i == 0 && (gnl_foobar_xmpl_echo_msg_reply_parse(nlh, &attrs) < 0 || attrs.data_len != payload_len ||
+                       memcmp(attrs.data, payload, payload_len) != 0)) {
+            fprintf(stderr, LOG_PREFIX "invalid echo reply for payload length %zu\n", payload_len);
+            return -1;
+        }
+    }
+    return monotonic_ns() - start;
+}
+
+/**
+ * Echoes `records` payloads through a ring in batches of `RING_ENTRIES`.
+ *
+ * @return < 0 on failure or the wall time in ns.
+ */
+static double bench_ring(struct gnl_client *client, struct gnl_ring *ring, const char *payload, size_t payload_len,
+                         long records) {
+    double start = monotonic_ns();
+    long submitted = 0, completed = 0;
+
+    while (completed < records) {
+        int n;
+        __u32 i;
+
+        while (submitted < records && gnl_ring_push(ring, submitted, payload, payload_len) == 0) {
+            submitted++;
+        }
+        n = gnl_ring_doorbell(client, ring);
+        if (n <= 0) {
+            fprintf(stderr, LOG_PREFIX "doorbell completed nothing\n");
+            return -1;
+        }
+        for (i = 0; i < (__u32) n; i++) {
+            const struct gnl_foobar_xmpl_ring_rec *rec = gnl_ring_peek_cqe(ring, i);
+
+            if (rec == NULL || rec->result != 0 || rec->user_data != (__u64) completed + i || rec->len != payload_len ||
+                (completed + i == 0 && memcmp(rec->data, payload, payload_len) != 0)) {
+                fprintf(stderr, LOG_PREFIX "invalid completion %ld for payload length %zu\n", completed + i, payload_len);
+                return -1;
+            }
+        }
+        gnl_ring_cq_advance(ring, n);
+        completed += n;
+    }
+    return monotonic_ns() - start;
+}
+
+int main(int argc, char **argv) {
+    long records = argc > 1 ? atol(argv[1]) : DEFAULT_RECORDS;
+    struct gnl_client client;
+    char payload[MAX_PAYLOAD_LEN];
+    size_t payload_len;
+    int rc = 0;
+
+    if (records <= 0) {
+        fprintf(stderr, "usage: %s [records per payload size]\n", argv[0]);
+        return 1;
+    }
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    for (payload_len = 0; payload_len < MAX_PAYLOAD_LEN; payload_len++) {
+        payload[payload_len] = (char) payload_len;
+    }
+
+    printf(LOG_PREFIX "%ld records per payload size, %d records per doorbell\n", records, RING_ENTRIES);
+    printf("   bytes | echo ns/rec | ring ns/rec | ring MiB/s | speedup\n");
+    for (payload_len = MIN_PAYLOAD_LEN; payload_len <= MAX_PAYLOAD_LEN && rc == 0; payload_len *= 4) {
+        // smallest slot (multiple of 64) that holds the record
+        __u32 slot_size = (sizeof(struct gnl_foobar_xmpl_ring_rec) + payload_len + 63) & ~63U;
+        struct gnl_ring ring;
+        struct gnl_ring_stats stats;
+        double echo_ns, ring_ns;
+
+        if (gnl_ring_create(&client, &ring, RING_ENTRIES, slot_size) < 0) {
+            rc = -1;
+            break;
+        }
+        echo_ns = bench_echo(&client, payload, payload_len, records);
+        ring_ns = bench_ring(&client, &ring, payload, payload_len, records);
+        if (echo_ns < 0 || ring_ns < 0 || gnl_ring_get_stats(&client, &ring, &stats) < 0) {
+            rc = -1;
+        } else if (stats.records != (__u64) records) {
+            fprintf(stderr, LOG_PREFIX "kernel processed %llu of %ld records\n", (unsigned long long) stats.records,
+                    records);
+            rc = -1;
+        } else {
+            printf("%8zu | %11.1f | %11.1f | %10.1f | %6.1fx\n", payload_len, echo_ns / records, ring_ns / records,
+                   (double) stats.bytes / (1 << 20) / (ring_ns / 1e9), echo_ns / ring_ns);
+        }
+        gnl_ring_destroy(&client, &ring);
+    }
+
+    gnl_client_close(&client);
+    return rc == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Compares two ways for many threads to send small echo requests (`GNL_FOOBAR_XMPL_A_MSG`):
+ *   - sockets: each thread has its own socket and does one sendto() and one recv() per request
+ *   - queue:   all threads share one socket via the submission queue of "gnl-submit.h", which
+ *              coalesces concurrent requests into multi-message datagrams
+ * For 1 to 32 threads it prints the throughput, the syscalls per request and the number of
+ * requests per sent datagram.
+ *
+ * Usage: ./bench-submit [requests per thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-submit.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[bench-submit] "
+
+#define DEFAULT_REQUESTS 10000
+#define MAX_THREADS 32
+#define BUF_LEN 256
+#define ECHO_MSG "Some data that has `char` in it."
+
+enum submit_mode {
+    SUBMIT_MODE_SOCKETS,
+    SUBMIT_MODE_QUEUE,
+};
+
+struct worker {
+    pthread_t thread;
+    enum submit_mode mode;
+    /** Only for `SUBMIT_MODE_QUEUE`. */
+    struct gnl_submit_queue *queue;
+    /** Only for `SUBMIT_MODE_SOCKETS`; opened before the measurement. */
+    struct gnl_client client;
+    long requests;
+    long failures;
+    pthread_barrier_t *start;
+};
+
+static double monotonic_s(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @return < 0 on failure or 0 if `resp` is the expected echo reply.
+ */
+static int check_reply(const char *resp, ssize_t len) {
+    const struct nlmsghdr *nlh = (const struct nlmsghdr *) resp;
+    struct gnl_foobar_xmpl_attrs attrs;
+
+    if (len < 0 || nlh->nlmsg_type == NLMSG_ERROR || gnl_foobar_xmpl_echo_msg_reply_parse(nlh, &attrs) < 0 ||
+        attrs.msg == NULL || strcmp(attrs.msg, ECHO_MSG) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static void *worker_thread(void *arg) {
+    struct worker *w = arg;
+    char req[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    char resp[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    __u16 family_id = w->mode == SUBMIT_MODE_QUEUE ? w->queue->client.family_id : w->client.family_id;
+    long i;
+
+    pthread_barrier_wait(w->start);
+    for (i = 0; i < w->requests; i++) {
+        struct nlmsghdr *nlh = gnl_foobar_xmpl_echo_msg_init(req, family_id, 0, w->client.seq++);
+        ssize_t len;
+
+        gnl_foobar_xmpl_put_msg(nlh, ECHO_MSG);
+        if (w->mode == SUBMIT_MODE_QUEUE) {
+            len = gnl_submit(w->queue, nlh, resp, sizeof(resp));
+        } else if (gnl_client_send(&w->client, nlh) < 0) {
+            len = -1;
+        } else {
+            len = gnl_client_recv(&w->client, resp, sizeof(resp));
+        }
+        if (check_reply(resp, len) < 0) {
+            w->failures++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Runs `threads` workers with `requests` each and prints one line of results.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int bench(enum submit_mode mode, int threads, long requests) {
+    static struct worker workers[MAX_THREADS];
+    struct gnl_submit_queue *queue = NULL;
+    pthread_barrier_t start;
+    double start_s, elapsed_s;
+    double total = (double) threads * requests, syscalls, per_datagram;
+    long failures = 0;
+    int i;
+
+    if (mode == SUBMIT_MODE_QUEUE) {
+        queue = malloc(sizeof(*queue));
+        if (queue == NULL || gnl_submit_open(queue, 0) < 0) {
+            free(queue);
+            return -1;
+        }
+    }
+    pthread_barrier_init(&start, NULL, threads + 1);
+    for (i = 0; i < threads; i++) {
+        struct worker *w = &workers[i];
+
+        memset(w, 0, sizeof(*w));
+        w->mode = mode;
+        w->queue = queue;
+        w->requests = requests;
+        w->start = &start;
+        if (mode == SUBMIT_MODE_SOCKETS && gnl_client_open(&w->client) < 0) {
+            return -1;
+        }
+        if (pthread_create(&w->thread, NULL, worker_thread, w) != 0) {
+            fprintf(stderr, LOG_PREFIX "can't start thread\n");
+            return -1;
+        }
+    }
+    pthread_barrier_wait(&start);
+    start_s = monotonic_s();
+    for (i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        failures += workers[i].failures;
+        if (mode == SUBMIT_MODE_SOCKETS) {
+            gnl_client_close(&workers[i].client);
+        }
+    }
+    elapsed_s = monotonic_s() - start_s;
+    pthread_barrier_destroy(&start);
+
+    if (mode == SUBMIT_MODE_QUEUE) {
+        gnl_submit_close(queue);
+        syscalls = queue->stats.datagrams + queue->stats.recvs;
+        per_datagram = queue->stats.datagrams ? (double) queue->stats.requests / queue->stats.datagrams : 0;
+        free(queue);
+    } else {
+        syscalls = 2 * total;
+        per_datagram = 1;
+    }
+    printf("%-7s | %7d | %10.0f | %13.2f | %12.2f | %8ld\n", mode == SUBMIT_MODE_QUEUE ? "queue" : "sockets",
+           threads, total / elapsed_s, syscalls / total, per_datagram, failures);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    long requests = argc > 1 ? atol(argv[1]) : DEFAULT_REQUESTS;
+    int threads;
+
+    if (requests <= 0) {
+        fprintf(stderr, "usage: %s [requests per thread]\n", argv[0]);
+        return 1;
+    }
+    printf(LOG_PREFIX "%ld echo requests per thread\n", requests);
+    printf("mode    | threads |    req/s   | syscalls/req  | req/datagram | failures\n");
+    for (threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        if (bench(SUBMIT_MODE_SOCKETS, threads, requests) < 0 || bench(SUBMIT_MODE_QUEUE, threads, requests) < 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Throughput of chunked transfers (see "gnl-xfer.h"). For objects from 1 MiB to 256 MiB it
+ * uploads, downloads, verifies and deletes the object and prints the throughput of both
+ * directions. The kernel must allow objects of 256 MiB (module parameter `xfer_max_bytes`).
+ *
+ * Usage: sudo ./bench-xfer [chunk length in KiB] [window] (uploads require CAP_NET_ADMIN)
+ *   window: unacknowledged chunks in flight during uploads; default: advertised by the kernel
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-xfer.h"
+
+#define LOG_PREFIX "[bench-xfer] "
+
+#define MIN_SIZE (1ULL << 20)
+#define MAX_SIZE (256ULL << 20)
+
+static double monotonic_s(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    long chunk_kib = argc > 1 ? atol(argv[1]) : (GNL_XFER_DEFAULT_CHUNK_LEN + 1023) / 1024;
+    long window = argc > 2 ? atol(argv[2]) : 0;
+    struct gnl_client client;
+    char *object, *download;
+    __u64 size, i;
+    __u32 chunk_len;
+
+    // 64 KiB stands for the largest chunk, which is 4 bytes short of it (see GNL_XFER_MAX_CHUNK_LEN)
+    if (chunk_kib <= 0 || chunk_kib > 64 || window < 0) {
+        fprintf(stderr, "usage: %s [chunk length in KiB (1..64)] [window]\n", argv[0]);
+        return 1;
+    }
+    chunk_len = chunk_kib * 1024 < GNL_XFER_MAX_CHUNK_LEN ? chunk_kib * 1024 : GNL_XFER_MAX_CHUNK_LEN;
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    object = malloc(MAX_SIZE);
+    download = malloc(MAX_SIZE);
+    if (object == NULL || download == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+    // not compressible and different at every offset, so that misplaced chunks are detected
+    for (i = 0; i < MAX_SIZE / sizeof(__u64); i++) {
+        ((__u64 *) object)[i] = i * 0x9e3779b97f4a7c15ULL;
+    }
+
+    printf(LOG_PREFIX "chunks of %u bytes, window %s\n", chunk_len, window ? argv[2] : "advertised by the kernel");
+    printf("  size MiB | upload MiB/s | download MiB/s\n");
+    for (size = MIN_SIZE; size <= MAX_SIZE; size *= 4) {
+        double start, upload_s, download_s;
+        __u32 id;
+
+        start = monotonic_s();
+        if (gnl_xfer_upload(&client, object, size, chunk_len, window, &id) < 0) {
+            return 1;
+        }
+        upload_s = monotonic_s() - start;
+
+        memset(download, 0, size);
+        start = monotonic_s();
+        if (gnl_xfer_download(&client, id, download, size) < 0) {
+            return 1;
+        }
+        download_s = monotonic_s() - start;
+
+        if (memcmp(object, download, size) != 0) {
+            fprintf(stderr, LOG_PREFIX "downloaded object differs from the uploaded one\n");
+            return 1;
+        }
+        if (gnl_xfer_abort(&client, id) < 0) {
+            return 1;
+        }
+        printf("%10llu | %12.1f | %14.1f\n", (unsigned long long) (size >> 20),
+               (size >> 20) / upload_s, (size >> 20) / download_s);
+    }
+
+    free(object);
+    free(download);
+    gnl_client_close(&client);
+    return 0;
+}
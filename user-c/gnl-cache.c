@@ -0,0 +1,272 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-cache.h". */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "gnl-cache.h"
+#include "gnl-capture.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[gnl-cache] "
+
+/** Receive buffer of the listener; notifications are tiny. */
+#define NOTIFY_BUF_LEN 4096
+
+struct gnl_cache_entry {
+    /** The request from the Netlink header on; only type, flags and payload are compared. */
+    struct nlmsghdr *req;
+    /** The reply as received. */
+    struct nlmsghdr *reply;
+    /** `GNL_FOOBAR_XMPL_A_GENERATION` of the reply. */
+    __u64 generation;
+};
+
+/** FNV-1a over the part of the request that identifies it. */
+static unsigned int request_hash(const struct nlmsghdr *nlh) {
+    const unsigned char *p = NLMSG_DATA(nlh);
+    const unsigned char *end = (const unsigned char *) nlh + nlh->nlmsg_len;
+    __u32 hash = 2166136261u ^ nlh->nlmsg_type ^ ((__u32) nlh->nlmsg_flags << 16);
+
+    for (; p < end; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash % GNL_CACHE_SLOTS;
+}
+
+static int request_equal(const struct nlmsghdr *a, const struct nlmsghdr *b) {
+    return a->nlmsg_len == b->nlmsg_len && a->nlmsg_type == b->nlmsg_type && a->nlmsg_flags == b->nlmsg_flags &&
+           memcmp(NLMSG_DATA(a), NLMSG_DATA(b), a->nlmsg_len - NLMSG_HDRLEN) == 0;
+}
+
+static void entry_free(struct gnl_cache_entry *entry) {
+    if (entry != NULL) {
+        free(entry->req);
+        free(entry->reply);
+        free(entry);
+    }
+}
+
+/**
+ * Extracts `GNL_FOOBAR_XMPL_A_GENERATION` from a reply.
+ *
+ * @return < 0 if the reply has none or 0 on success.
+ */
+static int reply_generation(const struct nlmsghdr *nlh, __u64 *generation) {
+    const struct nlattr *na = gnl_msg_find_attr(nlh, GNL_FOOBAR_XMPL_A_GENERATION);
+
+    if (na == NULL || na->nla_len != NLA_HDRLEN + sizeof(*generation)) {
+        return -1;
+    }
+    memcpy(generation, NLA_DATA(na), sizeof(*generation));
+    return 0;
+}
+
+/**
+ * Sends `nlh` with the next sequence number and receives the reply into `buf`.
+ *
+ * @return < 0 on failure or the length of the reply.
+ */
+static ssize_t round_trip(struct gnl_client *client, const struct nlmsghdr *nlh, void *buf, size_t len) {
+    struct nlmsghdr *reply = buf;
+    ssize_t rc;
+
+    // the header is patched in a copy; `nlh` stays as the caller built it
+    if (nlh->nlmsg_len > len) {
+        fprintf(stderr, LOG_PREFIX "request doesn't fit into the buffer\n");
+        return -1;
+    }
+    memcpy(buf, nlh, nlh->nlmsg_len);
+    reply->nlmsg_seq = client->seq++;
+    if (gnl_client_send(client, reply) < 0) {
+        return -1;
+    }
+    rc = gnl_client_recv(client, buf, len);
+    if (rc < 0 || !NLMSG_OK(reply, rc)) {
+        return -1;
+    }
+    return reply->nlmsg_len;
+}
+
+/**
+ * Queries the current generation with `GNL_FOOBAR_XMPL_C_GET_GENERATION`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int query_generation(struct gnl_cache *cache, __u64 *generation) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    char req[64] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = gnl_foobar_xmpl_get_generation_init(req, cache->client->family_id, 0, 0);
+
+    cache->stats.queries++;
+    if (round_trip(cache->client, nlh, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+    nlh = (struct nlmsghdr *) buf;
+    if (nlh->nlmsg_type == NLMSG_ERROR) {
+        gnl_msg_print_err(nlh, LOG_PREFIX);
+        return -1;
+    }
+    return reply_generation(nlh, generation);
+}
+
+/**
+ * Receives all pending notifications of the listener. If the socket overflowed, notifications
+ * were lost: all entries are dropped.
+ */
+static void drain_notifications(struct gnl_cache *cache) {
+    char buf[NOTIFY_BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    ssize_t rc;
+
+    for (;;) {
+        struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+
+        rc = recv(cache->listener.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (rc < 0) {
+            if (errno == ENOBUFS) {
+                gnl_cache_flush(cache);
+                cache->notified = 0;
+                continue;
+            }
+            // EAGAIN: nothing pending
+            return;
+        }
+        gnl_capture_record(buf, rc, GNL_CAPTURE_IN);
+        for (; NLMSG_OK(nlh, rc); nlh = NLMSG_NEXT(nlh, rc)) {
+            struct gnl_foobar_xmpl_attrs attrs;
+
+            if (gnl_foobar_xmpl_invalidate_parse(nlh, &attrs) == 0 &&
+                GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_GENERATION)) {
+                cache->stats.notifications++;
+                cache->generation = attrs.generation;
+                cache->notified = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @return 1 if `entry` is up to date, 0 if not, or < 0 on failure.
+ */
+static int entry_valid(struct gnl_cache *cache, const struct gnl_cache_entry *entry) {
+    __u64 generation;
+
+    if (cache->validation == GNL_CACHE_VALIDATE_QUERY) {
+        if (query_generation(cache, &generation) < 0) {
+            return -1;
+        }
+        return generation == entry->generation;
+    }
+    drain_notifications(cache);
+    // without any notification since the entry was added nothing has changed
+    return !cache->notified || cache->generation == entry->generation;
+}
+
+int gnl_cache_open(struct gnl_cache *cache, struct gnl_client *client, enum gnl_cache_validation validation) {
+    memset(cache, 0, sizeof(*cache));
+    cache->client = client;
+    cache->validation = validation;
+    cache->listener.fd = -1;
+    if (validation == GNL_CACHE_VALIDATE_NOTIFY) {
+        // must listen before the first entry is added, otherwise changes in between would be missed
+        if (gnl_client_open(&cache->listener) < 0) {
+            return -1;
+        }
+        if (gnl_client_join_group(&cache->listener, GNL_FOOBAR_XMPL_MCGRP_INVALIDATE_NAME) < 0) {
+            gnl_client_close(&cache->listener);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void gnl_cache_close(struct gnl_cache *cache) {
+    gnl_cache_flush(cache);
+    if (cache->listener.fd >= 0) {
+        gnl_client_close(&cache->listener);
+    }
+}
+
+void gnl_cache_flush(struct gnl_cache *cache) {
+    int i;
+
+    for (i = 0; i < GNL_CACHE_SLOTS; i++) {
+        entry_free(cache->slots[i]);
+        cache->slots[i] = NULL;
+    }
+}
+
+ssize_t gnl_cache_request(struct gnl_cache *cache, const struct nlmsghdr *nlh, void *buf, size_t len) {
+    const unsigned int slot = request_hash(nlh);
+    struct gnl_cache_entry *entry = cache->slots[slot];
+    struct nlmsghdr *reply = buf;
+    ssize_t reply_len;
+    int valid;
+
+    if (entry != NULL && request_equal(entry->req, nlh)) {
+        valid = entry_valid(cache, entry);
+        if (valid < 0) {
+            return -1;
+        }
+        if (valid && entry->reply->nlmsg_len <= len) {
+            cache->stats.hits++;
+            memcpy(buf, entry->reply, entry->reply->nlmsg_len);
+            reply->nlmsg_seq = nlh->nlmsg_seq;
+            return reply->nlmsg_len;
+        }
+        cache->stats.stale++;
+    } else {
+        cache->stats.misses++;
+    }
+
+    if (cache->validation == GNL_CACHE_VALIDATE_NOTIFY) {
+        // otherwise older notifications, still queued, would make the new entry look outdated
+        drain_notifications(cache);
+    }
+    reply_len = round_trip(cache->client, nlh, buf, len);
+    if (reply_len < 0) {
+        return -1;
+    }
+
+    entry_free(cache->slots[slot]);
+    cache->slots[slot] = NULL;
+    if (reply->nlmsg_type != NLMSG_ERROR) {
+        entry = calloc(1, sizeof(*entry));
+        if (entry != NULL && reply_generation(reply, &entry->generation) == 0 &&
+            (entry->req = malloc(nlh->nlmsg_len)) != NULL && (entry->reply = malloc(reply_len)) != NULL) {
+            memcpy(entry->req, nlh, nlh->nlmsg_len);
+            memcpy(entry->reply, reply, reply_len);
+            cache->slots[slot] = entry;
+        } else {
+            entry_free(entry);
+        }
+    }
+    reply->nlmsg_seq = nlh->nlmsg_seq;
+    return reply_len;
+}
+
+void gnl_cache_print_stats(FILE *f, const char *prefix, const struct gnl_cache *cache) {
+    fprintf(f, "%shits=%lu misses=%lu stale=%lu queries=%lu notifications=%lu\n", prefix, cache->stats.hits,
+            cache->stats.misses, cache->stats.stale, cache->stats.queries, cache->stats.notifications);
+}
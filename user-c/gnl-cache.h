@@ -0,0 +1,108 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Client side cache for replies of read-only commands (e.g. `GNL_FOOBAR_XMPL_C_GET_CONFIG`,
+ * `GNL_FOOBAR_XMPL_C_RING_STATS` or echoes). Every reply of the kernel module carries the generation of
+ * the state it was built from (`GNL_FOOBAR_XMPL_A_GENERATION`). A cached reply is served again as long
+ * as the generation is unchanged, which the cache checks in one of two ways:
+ *
+ * - `GNL_CACHE_VALIDATE_QUERY`: each hit costs a `GNL_FOOBAR_XMPL_C_GET_GENERATION` round trip. Pays off
+ *   if that is cheaper than the request itself, e.g. for large replies.
+ * - `GNL_CACHE_VALIDATE_NOTIFY`: a second socket listens to the group "invalidate". The kernel queues
+ *   the notification of a change before it answers the request that made the change, hence draining
+ *   the socket with non-blocking receives is enough; a hit costs no round trip.
+ *
+ * Requests are matched by their type, flags and payload. Only requests with a single reply message
+ * (no dumps) may go through the cache; error replies aren't cached.
+ */
+
+#include <stdio.h>
+
+#include "gnl-client.h"
+
+/** Number of entries; the cache is direct mapped, i.e. an entry replaces the one in its slot. */
+#define GNL_CACHE_SLOTS 64
+
+enum gnl_cache_validation {
+    GNL_CACHE_VALIDATE_QUERY,
+    GNL_CACHE_VALIDATE_NOTIFY,
+};
+
+struct gnl_cache_stats {
+    /** Requests served from the cache. */
+    unsigned long hits;
+    /** Requests without an entry. */
+    unsigned long misses;
+    /** Requests whose entry was outdated. */
+    unsigned long stale;
+    /** `GNL_FOOBAR_XMPL_C_GET_GENERATION` round trips. */
+    unsigned long queries;
+    /** Received `GNL_FOOBAR_XMPL_C_INVALIDATE` notifications. */
+    unsigned long notifications;
+};
+
+struct gnl_cache_entry;
+
+struct gnl_cache {
+    /** Connection for the requests; owned by the caller. */
+    struct gnl_client *client;
+    enum gnl_cache_validation validation;
+    /** Only with `GNL_CACHE_VALIDATE_NOTIFY`: member of the group "invalidate". */
+    struct gnl_client listener;
+    /** Generation of the latest notification; only valid if `notified`. */
+    __u64 generation;
+    int notified;
+    struct gnl_cache_entry *slots[GNL_CACHE_SLOTS];
+    struct gnl_cache_stats stats;
+};
+
+/**
+ * Initializes an empty cache for the requests of `client`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_cache_open(struct gnl_cache *cache, struct gnl_client *client, enum gnl_cache_validation validation);
+
+/**
+ * Frees all entries (and closes the listener).
+ */
+void gnl_cache_close(struct gnl_cache *cache);
+
+/**
+ * Drops all entries.
+ */
+void gnl_cache_flush(struct gnl_cache *cache);
+
+/**
+ * Serves the read-only request `nlh` from the cache or sends it (with the next sequence number of the
+ * client) and caches the reply. The reply is copied into `buf`; its sequence number is the one of
+ * `nlh` in both cases.
+ *
+ * @return < 0 on failure or the length of the reply (which may be an NLMSG_ERROR message).
+ */
+ssize_t gnl_cache_request(struct gnl_cache *cache, const struct nlmsghdr *nlh, void *buf, size_t len);
+
+/**
+ * Prints the counters of the cache.
+ */
+void gnl_cache_print_stats(FILE *f, const char *prefix, const struct gnl_cache *cache);
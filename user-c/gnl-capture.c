@@ -0,0 +1,217 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-capture.h". The file format is described in "gnl-pcap.h". */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "gnl-capture.h"
+#include "gnl-pcap.h"
+
+#define LOG_PREFIX "[gnl-capture] "
+
+/** Size of the buffer of each thread. */
+#define CAPTURE_BUF_LEN (1024 * 1024)
+
+struct capture_buf {
+    /** Neighbours in `capture_bufs`. */
+    struct capture_buf *prev, *next;
+    /**
+     * Only contended while `gnl_capture_close()` flushes the buffer. Held while the buffer is written,
+     * hence `capture_fd` can't be closed in between.
+     */
+    pthread_mutex_t mtx;
+    size_t len;
+    char data[CAPTURE_BUF_LEN];
+};
+
+/** File descriptor of the capture or -1 if disabled. Read by all threads without locks. */
+static int capture_fd = -1;
+/** Flushes and frees the buffer of a thread when it exits. */
+static pthread_key_t capture_key;
+static __thread struct capture_buf *capture_tls_buf;
+/** Buffers of all threads, so that `gnl_capture_close()` can flush them. */
+static struct capture_buf *capture_bufs;
+static pthread_mutex_t capture_bufs_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+/** Writes all `iovcnt` buffers with one syscall, so that batches of different threads don't interleave. */
+static void capture_write(int fd, struct iovec *iov, int iovcnt) {
+    if (writev(fd, iov, iovcnt) < 0) {
+        perror(LOG_PREFIX "writev()");
+    }
+}
+
+/** Writes the buffer to `fd` (if >= 0) and empties it. The caller must hold `buf->mtx`. */
+static void capture_flush_buf(struct capture_buf *buf, int fd) {
+    struct iovec iov = {.iov_base = buf->data, .iov_len = buf->len};
+
+    if (fd >= 0 && buf->len > 0) {
+        capture_write(fd, &iov, 1);
+    }
+    buf->len = 0;
+}
+
+static void capture_thread_exit(void *arg) {
+    struct capture_buf *buf = arg;
+
+    pthread_mutex_lock(&capture_bufs_mtx);
+    if (buf->prev != NULL) {
+        buf->prev->next = buf->next;
+    } else {
+        capture_bufs = buf->next;
+    }
+    if (buf->next != NULL) {
+        buf->next->prev = buf->prev;
+    }
+    pthread_mutex_unlock(&capture_bufs_mtx);
+
+    pthread_mutex_lock(&buf->mtx);
+    capture_flush_buf(buf, __atomic_load_n(&capture_fd, __ATOMIC_ACQUIRE));
+    pthread_mutex_unlock(&buf->mtx);
+    pthread_mutex_destroy(&buf->mtx);
+    free(buf);
+}
+
+int gnl_capture_open(const char *path) {
+    struct gnl_pcap_file_hdr hdr = {
+            .magic = GNL_PCAP_MAGIC_NS,
+            .version_major = 2,
+            .version_minor = 4,
+            .snaplen = GNL_PCAP_SNAPLEN,
+            .linktype = GNL_PCAP_LINKTYPE_NETLINK,
+    };
+    int fd;
+
+    if (capture_fd >= 0) {
+        return 0;
+    }
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(LOG_PREFIX "open()");
+        return -1;
+    }
+    if (write(fd, &hdr, sizeof(hdr)) != sizeof(hdr) || pthread_key_create(&capture_key, capture_thread_exit) != 0) {
+        fprintf(stderr, LOG_PREFIX "can't initialize capture '%s'\n", path);
+        close(fd);
+        return -1;
+    }
+    __atomic_store_n(&capture_fd, fd, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void gnl_capture_record(const void *data, size_t len, enum gnl_capture_dir dir) {
+    struct capture_buf *buf = capture_tls_buf;
+    struct gnl_pcap_rec_hdr rec;
+    struct gnl_pcap_netlink_hdr nl;
+    struct timespec now;
+    size_t caplen = len < GNL_PCAP_SNAPLEN - sizeof(nl) ? len : GNL_PCAP_SNAPLEN - sizeof(nl);
+    size_t total = sizeof(rec) + sizeof(nl) + caplen;
+    int fd;
+
+    if (__atomic_load_n(&capture_fd, __ATOMIC_ACQUIRE) < 0) {
+        return;
+    }
+    if (buf == NULL) {
+        buf = malloc(sizeof(*buf));
+        if (buf == NULL) {
+            return;
+        }
+        buf->prev = NULL;
+        buf->len = 0;
+        pthread_mutex_init(&buf->mtx, NULL);
+        pthread_mutex_lock(&capture_bufs_mtx);
+        buf->next = capture_bufs;
+        if (capture_bufs != NULL) {
+            capture_bufs->prev = buf;
+        }
+        capture_bufs = buf;
+        pthread_mutex_unlock(&capture_bufs_mtx);
+        capture_tls_buf = buf;
+        pthread_setspecific(capture_key, buf);
+    }
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    rec.ts_sec = now.tv_sec;
+    rec.ts_nsec = now.tv_nsec;
+    rec.caplen = sizeof(nl) + caplen;
+    rec.len = sizeof(nl) + len;
+    gnl_pcap_netlink_hdr_init(&nl, dir == GNL_CAPTURE_OUT);
+
+    pthread_mutex_lock(&buf->mtx);
+    // checked again under the lock: a concurrent gnl_capture_close() may have closed it in between
+    fd = __atomic_load_n(&capture_fd, __ATOMIC_ACQUIRE);
+    if (fd < 0) {
+        pthread_mutex_unlock(&buf->mtx);
+        return;
+    }
+    if (buf->len + total > CAPTURE_BUF_LEN) {
+        capture_flush_buf(buf, fd);
+    }
+    if (total > CAPTURE_BUF_LEN) {
+        // doesn't fit into any buffer; written directly (after the older records of this thread)
+        struct iovec iov[3] = {
+                {.iov_base = &rec, .iov_len = sizeof(rec)},
+                {.iov_base = &nl, .iov_len = sizeof(nl)},
+                {.iov_base = (void *) data, .iov_len = caplen},
+        };
+        capture_write(fd, iov, 3);
+    } else {
+        memcpy(buf->data + buf->len, &rec, sizeof(rec));
+        memcpy(buf->data + buf->len + sizeof(rec), &nl, sizeof(nl));
+        memcpy(buf->data + buf->len + sizeof(rec) + sizeof(nl), data, caplen);
+        buf->len += total;
+    }
+    pthread_mutex_unlock(&buf->mtx);
+}
+
+void gnl_capture_flush(void) {
+    struct capture_buf *buf = capture_tls_buf;
+
+    if (buf != NULL) {
+        pthread_mutex_lock(&buf->mtx);
+        capture_flush_buf(buf, __atomic_load_n(&capture_fd, __ATOMIC_ACQUIRE));
+        pthread_mutex_unlock(&buf->mtx);
+    }
+}
+
+void gnl_capture_close(void) {
+    int fd = __atomic_exchange_n(&capture_fd, -1, __ATOMIC_ACQ_REL);
+    struct capture_buf *buf;
+
+    if (fd < 0) {
+        return;
+    }
+    // the buffers of all threads that are still alive; the others were flushed when they exited
+    pthread_mutex_lock(&capture_bufs_mtx);
+    for (buf = capture_bufs; buf != NULL; buf = buf->next) {
+        pthread_mutex_lock(&buf->mtx);
+        capture_flush_buf(buf, fd);
+        pthread_mutex_unlock(&buf->mtx);
+    }
+    pthread_mutex_unlock(&capture_bufs_mtx);
+    close(fd);
+}
@@ -0,0 +1,73 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Capture of all datagrams that "gnl-client.c" sends and receives into a pcap file. The format is
+ * the same as a capture on a nlmon device (`LINKTYPE_NETLINK`), hence the files can be opened with
+ * Wireshark or tcpdump, and `gnl-replay` plays them back against the kernel module.
+ *
+ * Each thread appends records to its own buffer; its lock is only contended while
+ * `gnl_capture_close()` flushes it. A full buffer is written with a single write() to the file
+ * (opened with O_APPEND), hence batches of different threads never interleave. Records of different
+ * threads are therefore not sorted by time within the file. Buffers are flushed when they are full,
+ * when their thread exits and by `gnl_capture_close()` (buffers of all threads).
+ *
+ * Programs that use "gnl-client.h" enable the capture with an environment variable:
+ *   $ GNL_CAPTURE=/tmp/trace.pcap ./bench-echo
+ */
+
+#include <stddef.h>
+
+/** Name of the environment variable that enables the capture in `gnl_client_open()`. */
+#define GNL_CAPTURE_ENV "GNL_CAPTURE"
+
+/** Direction of a captured datagram. */
+enum gnl_capture_dir {
+    /** From the kernel to this program. */
+    GNL_CAPTURE_IN,
+    /** From this program to the kernel. */
+    GNL_CAPTURE_OUT,
+};
+
+/**
+ * Creates (truncates) the pcap file `path` and enables the capture for all threads.
+ * Does nothing if the capture is already enabled.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_capture_open(const char *path);
+
+/**
+ * Records the datagram `buf` of length `len` with the current time if the capture is enabled.
+ */
+void gnl_capture_record(const void *buf, size_t len, enum gnl_capture_dir dir);
+
+/**
+ * Writes the buffer of the calling thread to the file.
+ */
+void gnl_capture_flush(void);
+
+/**
+ * Flushes the buffers of all threads and closes the file. Records of other threads that race with
+ * the close may be dropped, but never written to a closed file.
+ */
+void gnl_capture_close(void);
@@ -0,0 +1,361 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-client.h". The steps are documented in detail in "user-pure.c". */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+
+#include "gnl-capture.h"
+#include "gnl-client.h"
+// data/vars/enums/properties that describes our protocol that we implement
+// on top of generic netlink (like functions we want to trigger on the receiving side)
+#include "gnl_foobar_xmpl_prop.h"
+
+#define LOG_PREFIX "[gnl-client] "
+
+/** Receive buffer for the description of the family; it lists all operations and multicast groups. */
+#define CTRL_BUF_LEN 8192
+
+/**
+ * Queries the description of the Netlink family `FAMILY_NAME` from the Generic Netlink control
+ * interface into `buf`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int get_family(struct gnl_client *client, char *buf, size_t len) {
+    struct nlmsghdr *nlh;
+    ssize_t rc;
+
+    nlh = gnl_msg_init(buf, GENL_ID_CTRL, 0, client->seq++, CTRL_CMD_GETFAMILY);
+    gnl_msg_put_attr(nlh, CTRL_ATTR_FAMILY_NAME, FAMILY_NAME, sizeof(FAMILY_NAME));
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+
+    rc = gnl_client_recv(client, buf, len);
+    if (rc < 0) {
+        return -1;
+    }
+    if (!NLMSG_OK(nlh, rc) || nlh->nlmsg_type == NLMSG_ERROR) {
+        if (NLMSG_OK(nlh, rc)) {
+            gnl_msg_print_err(nlh, LOG_PREFIX);
+        }
+        fprintf(stderr, LOG_PREFIX "family '" FAMILY_NAME "' not found. Is the kernel module loaded?\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Resolves the id of the Netlink family `FAMILY_NAME` using Generic Netlink control interface.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int resolve_family_id_by_name(struct gnl_client *client) {
+    char buf[CTRL_BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+    struct nlattr *na;
+
+    if (get_family(client, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+    na = gnl_msg_find_attr(nlh, CTRL_ATTR_FAMILY_ID);
+    if (na == NULL) {
+        fprintf(stderr, LOG_PREFIX "CTRL_ATTR_FAMILY_ID missing in reply\n");
+        return -1;
+    }
+    client->family_id = *(__u16 *) NLA_DATA(na);
+    return 0;
+}
+
+int gnl_client_open(struct gnl_client *client) {
+    struct sockaddr_nl nl_address;
+    const char *capture_path = getenv(GNL_CAPTURE_ENV);
+    int one = 1;
+
+    // see "gnl-capture.h"; closing is idempotent, hence repeated registrations are harmless
+    if (capture_path != NULL && gnl_capture_open(capture_path) == 0) {
+        atexit(gnl_capture_close);
+    }
+
+    memset(client, 0, sizeof(*client));
+    client->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+    if (client->fd < 0) {
+        perror(LOG_PREFIX "socket()");
+        return -1;
+    }
+
+    memset(&nl_address, 0, sizeof(nl_address));
+    nl_address.nl_family = AF_NETLINK;
+    if (bind(client->fd, (struct sockaddr *) &nl_address, sizeof(nl_address)) < 0) {
+        perror(LOG_PREFIX "bind()");
+        close(client->fd);
+        return -1;
+    }
+
+    // Errors only carry the Netlink header of the request instead of a full copy, plus a message
+    // and the offending attribute. Both are optional features of the kernel; we work without them.
+    if (setsockopt(client->fd, SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one)) < 0) {
+        perror(LOG_PREFIX "setsockopt(NETLINK_CAP_ACK)");
+    }
+    if (setsockopt(client->fd, SOL_NETLINK, NETLINK_EXT_ACK, &one, sizeof(one)) < 0) {
+        perror(LOG_PREFIX "setsockopt(NETLINK_EXT_ACK)");
+    }
+
+    if (resolve_family_id_by_name(client) < 0) {
+        close(client->fd);
+        return -1;
+    }
+    return 0;
+}
+
+int gnl_client_join_group(struct gnl_client *client, const char *name) {
+    char buf[CTRL_BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+    struct nlattr *groups, *grp;
+    int remaining;
+
+    if (get_family(client, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+    groups = gnl_msg_find_attr(nlh, CTRL_ATTR_MCAST_GROUPS);
+    if (groups == NULL) {
+        fprintf(stderr, LOG_PREFIX "family '" FAMILY_NAME "' has no multicast groups\n");
+        return -1;
+    }
+    // nested: one attribute per group, each with CTRL_ATTR_MCAST_GRP_NAME and CTRL_ATTR_MCAST_GRP_ID
+    grp = NLA_DATA(groups);
+    remaining = groups->nla_len - NLA_HDRLEN;
+    while (remaining >= NLA_HDRLEN && grp->nla_len >= NLA_HDRLEN && grp->nla_len <= remaining) {
+        struct nlattr *na = NLA_DATA(grp);
+        int left = grp->nla_len - NLA_HDRLEN;
+        const char *grp_name = NULL;
+        __u32 grp_id = 0;
+
+        while (left >= NLA_HDRLEN && na->nla_len >= NLA_HDRLEN && na->nla_len <= left) {
+            if (na->nla_type == CTRL_ATTR_MCAST_GRP_NAME) {
+                grp_name = NLA_DATA(na);
+            } else if (na->nla_type == CTRL_ATTR_MCAST_GRP_ID) {
+                grp_id = *(__u32 *) NLA_DATA(na);
+            }
+            left -= NLA_ALIGN(na->nla_len);
+            na = (struct nlattr *) ((char *) na + NLA_ALIGN(na->nla_len));
+        }
+        if (grp_name != NULL && strcmp(grp_name, name) == 0) {
+            if (setsockopt(client->fd, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &grp_id, sizeof(grp_id)) < 0) {
+                perror(LOG_PREFIX "setsockopt(NETLINK_ADD_MEMBERSHIP)");
+                return -1;
+            }
+            return 0;
+        }
+        remaining -= NLA_ALIGN(grp->nla_len);
+        grp = (struct nlattr *) ((char *) grp + NLA_ALIGN(grp->nla_len));
+    }
+    fprintf(stderr, LOG_PREFIX "multicast group '%s' not found\n", name);
+    return -1;
+}
+
+void gnl_client_close(struct gnl_client *client) {
+    close(client->fd);
+    client->fd = -1;
+}
+
+struct nlmsghdr *gnl_msg_init(void *buf, __u16 type, __u16 flags, __u32 seq, __u8 cmd) {
+    struct nlmsghdr *nlh = buf;
+    struct genlmsghdr *gnlh = NLMSG_DATA(nlh);
+
+    nlh->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_flags = NLM_F_REQUEST | flags;
+    nlh->nlmsg_seq = seq;
+    // let the kernel assign the port id (see "user-pure.c" for what this field means)
+    nlh->nlmsg_pid = 0;
+    gnlh->cmd = cmd;
+    gnlh->version = 1;
+    gnlh->reserved = 0;
+    return nlh;
+}
+
+struct nlattr *gnl_msg_put_attr(struct nlmsghdr *nlh, __u16 type, const void *data, size_t len) {
+    struct nlattr *na = (struct nlattr *) ((char *) nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+    na->nla_type = type;
+    na->nla_len = NLA_HDRLEN + len;
+    memcpy(NLA_DATA(na), data, len);
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NLA_ALIGN(na->nla_len);
+    return na;
+}
+
+struct nlattr *gnl_msg_find_attr(const struct nlmsghdr *nlh, __u16 type) {
+    struct nlattr *na = GENLMSG_DATA(nlh);
+    int remaining = GENLMSG_PAYLOAD(nlh);
+
+    while (remaining >= (int) sizeof(*na) && na->nla_len >= sizeof(*na) && na->nla_len <= remaining) {
+        if ((na->nla_type & NLA_TYPE_MASK) == type) {
+            return na;
+        }
+        remaining -= NLA_ALIGN(na->nla_len);
+        na = (struct nlattr *) ((char *) na + NLA_ALIGN(na->nla_len));
+    }
+    return NULL;
+}
+
+int gnl_client_send(const struct gnl_client *client, const struct nlmsghdr *nlh) {
+    return gnl_client_send_raw(client, nlh, nlh->nlmsg_len);
+}
+
+int gnl_client_send_raw(const struct gnl_client *client, const void *buf, size_t len) {
+    struct sockaddr_nl nl_address;
+    ssize_t rc;
+
+    memset(&nl_address, 0, sizeof(nl_address));
+    nl_address.nl_family = AF_NETLINK;
+    // we target the kernel; kernel pid is 0
+    nl_address.nl_pid = 0;
+
+    rc = sendto(client->fd, buf, len, 0, (struct sockaddr *) &nl_address, sizeof(nl_address));
+    if (rc != (ssize_t) len) {
+        perror(LOG_PREFIX "sendto()");
+        return -1;
+    }
+    gnl_capture_record(buf, len, GNL_CAPTURE_OUT);
+    return 0;
+}
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+ssize_t gnl_client_recv(struct gnl_client *client, void *buf, size_t len) {
+    ssize_t rc;
+
+    if (client->busy_poll_ns > 0) {
+        rc = gnl_client_recv_spin(client, buf, len);
+        if (rc >= 0 || errno != EAGAIN) {
+            return rc;
+        }
+    }
+    rc = recv(client->fd, buf, len, 0);
+    if (rc < 0) {
+        perror(LOG_PREFIX "recv()");
+    } else {
+        gnl_capture_record(buf, rc, GNL_CAPTURE_IN);
+    }
+    return rc;
+}
+
+ssize_t gnl_client_recv_spin(struct gnl_client *client, void *buf, size_t len) {
+    __u64 start = monotonic_ns(), now;
+    ssize_t rc;
+
+    // each iteration is a syscall, hence checking the clock every time is cheap in comparison
+    do {
+        rc = recv(client->fd, buf, len, MSG_DONTWAIT);
+        now = monotonic_ns();
+        if (rc >= 0) {
+            client->busy_poll.hits++;
+            client->busy_poll.spin_ns += now - start;
+            gnl_capture_record(buf, rc, GNL_CAPTURE_IN);
+            return rc;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            perror(LOG_PREFIX "recv()");
+            return -1;
+        }
+    } while (now - start < client->busy_poll_ns);
+
+    client->busy_poll.misses++;
+    client->busy_poll.spin_ns += now - start;
+    errno = EAGAIN;
+    return -1;
+}
+
+void gnl_client_set_busy_poll(struct gnl_client *client, __u64 budget_ns) {
+    client->busy_poll_ns = budget_ns;
+}
+
+int gnl_msg_parse_err(const struct nlmsghdr *nlh, struct gnl_ext_ack *ack) {
+    const struct nlmsgerr *err = NLMSG_DATA(nlh);
+    const struct nlattr *na;
+    int offset, remaining;
+
+    ack->error = 0;
+    ack->msg = NULL;
+    ack->offset = -1;
+    if (nlh->nlmsg_type != NLMSG_ERROR || nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*err))) {
+        return -1;
+    }
+    ack->error = err->error;
+    if (!(nlh->nlmsg_flags & NLM_F_ACK_TLVS)) {
+        return 0;
+    }
+
+    // the TLVs follow the (capped) copy of the request
+    offset = NLMSG_LENGTH(sizeof(*err));
+    if (!(nlh->nlmsg_flags & NLM_F_CAPPED)) {
+        offset += NLMSG_ALIGN(err->msg.nlmsg_len) - NLMSG_HDRLEN;
+    }
+    remaining = (int) nlh->nlmsg_len - offset;
+    na = (const struct nlattr *) ((const char *) nlh + offset);
+    while (remaining >= (int) sizeof(*na) && na->nla_len >= sizeof(*na) && na->nla_len <= remaining) {
+        switch (na->nla_type & NLA_TYPE_MASK) {
+            case NLMSGERR_ATTR_MSG:
+                // null-terminated by the kernel; guard against malformed messages anyway
+                if (na->nla_len > NLA_HDRLEN && ((const char *) na)[na->nla_len - 1] == '\0') {
+                    ack->msg = NLA_DATA(na);
+                }
+                break;
+            case NLMSGERR_ATTR_OFFS:
+                if (na->nla_len >= NLA_HDRLEN + sizeof(__u32)) {
+                    ack->offset = *(const __u32 *) NLA_DATA(na);
+                }
+                break;
+        }
+        remaining -= NLA_ALIGN(na->nla_len);
+        na = (const struct nlattr *) ((const char *) na + NLA_ALIGN(na->nla_len));
+    }
+    return 0;
+}
+
+void gnl_msg_print_err(const struct nlmsghdr *nlh, const char *prefix) {
+    struct gnl_ext_ack ack;
+
+    if (gnl_msg_parse_err(nlh, &ack) < 0) {
+        fprintf(stderr, "%sinvalid NLMSG_ERROR message\n", prefix);
+        return;
+    }
+    fprintf(stderr, "%skernel replied with error %d (%s)", prefix, ack.error, strerror(-ack.error));
+    if (ack.msg != NULL) {
+        fprintf(stderr, ": %s", ack.msg);
+    }
+    if (ack.offset >= 0) {
+        fprintf(stderr, " [attribute at offset %ld]", ack.offset);
+    }
+    fprintf(stderr, "\n");
+}
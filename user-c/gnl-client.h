@@ -0,0 +1,185 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Tiny client library on top of raw Netlink sockets for the "gnl_foobar_xmpl" family. It contains
+ * the same steps as "user-pure.c" (open, bind, resolve family id, build messages, send, receive),
+ * but without global state, so that multiple programs (e.g. the benchmarks) can share them.
+ * "user-pure.c" stays standalone on purpose: it is the documented step-by-step tutorial.
+ */
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+
+// Generic macros for dealing with netlink sockets (same as in "user-pure.c")
+#define GENLMSG_DATA(glh) ((void *)((char *)NLMSG_DATA(glh) + GENL_HDRLEN))
+#define GENLMSG_PAYLOAD(glh) (NLMSG_PAYLOAD(glh, 0) - GENL_HDRLEN)
+#define NLA_DATA(na) ((void *)((char *)(na) + NLA_HDRLEN))
+
+/**
+ * Counters of the busy-poll receive mode (see `gnl_client_set_busy_poll()`).
+ */
+struct gnl_busy_poll_stats {
+    /** Receives that got a datagram while spinning. */
+    unsigned long hits;
+    /** Receives that exhausted the budget and fell back to a blocking wait. */
+    unsigned long misses;
+    /** Total time spent spinning, i.e. the CPU time that busy polling costs. */
+    unsigned long long spin_ns;
+};
+
+/**
+ * A connection to the "gnl_foobar_xmpl" family.
+ */
+struct gnl_client {
+    /** Netlink socket's file descriptor. */
+    int fd;
+    /** The family ID resolved by Generic Netlink control interface. */
+    __u16 family_id;
+    /** Sequence number for the next request. */
+    __u32 seq;
+    /** Spin budget of `gnl_client_recv()` in nanoseconds; 0 disables busy polling. */
+    __u64 busy_poll_ns;
+    struct gnl_busy_poll_stats busy_poll;
+};
+
+/**
+ * Decoded NLMSG_ERROR message. The client enables `NETLINK_CAP_ACK` and `NETLINK_EXT_ACK`, hence
+ * the kernel doesn't copy the whole request back but adds a message and the offset of the
+ * offending attribute (if the handler or the attribute policy reported them).
+ */
+struct gnl_ext_ack {
+    /** 0 for an ACK or a negative errno. */
+    int error;
+    /** Error message from the kernel (`NLMSGERR_ATTR_MSG`) or NULL. Points into the message. */
+    const char *msg;
+    /** Offset of the offending attribute in the request (`NLMSGERR_ATTR_OFFS`) or -1. */
+    long offset;
+};
+
+/**
+ * Opens and binds a Generic Netlink socket and resolves the family id of `FAMILY_NAME`.
+ * Enables capped and extended ACKs (see `struct gnl_ext_ack`); kernels without support for them
+ * still work, they just send the full request back and no error message.
+ * If the environment variable `GNL_CAPTURE_ENV` is set, all datagrams of all clients of the process
+ * are captured into the named pcap file (see "gnl-capture.h").
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_client_open(struct gnl_client *client);
+
+/**
+ * Joins the multicast group `name` of the family (e.g. `GNL_FOOBAR_XMPL_MCGRP_EVENTS_NAME`); its
+ * notifications arrive on the socket of the client from then on.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_client_join_group(struct gnl_client *client, const char *name);
+
+/**
+ * Closes the socket of the client.
+ */
+void gnl_client_close(struct gnl_client *client);
+
+/**
+ * Initializes a Netlink message with a Generic Netlink header at the beginning of `buf`.
+ * `NLM_F_REQUEST` is always added to `flags`.
+ *
+ * @return the Netlink header of the message, i.e. `buf`
+ */
+struct nlmsghdr *gnl_msg_init(void *buf, __u16 type, __u16 flags, __u32 seq, __u8 cmd);
+
+/**
+ * Appends an attribute to the message. The caller must ensure that the buffer behind `nlh` is
+ * big enough, i.e. `nlh->nlmsg_len + NLA_HDRLEN + NLA_ALIGN(len)`.
+ *
+ * @return the appended attribute
+ */
+struct nlattr *gnl_msg_put_attr(struct nlmsghdr *nlh, __u16 type, const void *data, size_t len);
+
+/**
+ * Looks up the first attribute of type `type` in the Generic Netlink message `nlh`.
+ *
+ * @return the attribute or NULL
+ */
+struct nlattr *gnl_msg_find_attr(const struct nlmsghdr *nlh, __u16 type);
+
+/**
+ * Sends the message `nlh` to the kernel.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_client_send(const struct gnl_client *client, const struct nlmsghdr *nlh);
+
+/**
+ * Sends the datagram `buf` of length `len` to the kernel. It may contain multiple Netlink messages;
+ * the kernel processes them one after another.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_client_send_raw(const struct gnl_client *client, const void *buf, size_t len);
+
+/**
+ * Receives one datagram into `buf`. A datagram may contain multiple Netlink messages.
+ * With busy polling enabled, it first spins (see `gnl_client_recv_spin()`) and only blocks if
+ * nothing arrived within the budget.
+ *
+ * @return < 0 on failure or the number of received bytes.
+ */
+ssize_t gnl_client_recv(struct gnl_client *client, void *buf, size_t len);
+
+/**
+ * Polls the socket with non-blocking receives for up to `busy_poll_ns` nanoseconds. Updates the
+ * counters in `client->busy_poll`.
+ *
+ * @return the number of received bytes, or -1 with errno EAGAIN if nothing arrived within the
+ *         budget, or -1 with another errno on failure.
+ */
+ssize_t gnl_client_recv_spin(struct gnl_client *client, void *buf, size_t len);
+
+/**
+ * Enables busy polling in `gnl_client_recv()`: spin with non-blocking receives for up to
+ * `budget_ns` nanoseconds before blocking, which saves the wakeup of the scheduler if the reply
+ * arrives in time, at the price of burning CPU time while waiting. 0 disables it (default).
+ *
+ * The handlers of the kernel module run within the sendto() of the request, hence in a plain
+ * request/reply sequence the reply is queued before recv() is called and spinning doesn't help.
+ * It pays off where replies arrive while the receiver waits, e.g. in the receiver thread of the
+ * submission queue (see "gnl-submit.h").
+ */
+void gnl_client_set_busy_poll(struct gnl_client *client, __u64 budget_ns);
+
+/**
+ * Decodes the NLMSG_ERROR message `nlh` including the extended ACK attributes.
+ *
+ * @return < 0 if `nlh` is not a valid NLMSG_ERROR message or 0 on success.
+ */
+int gnl_msg_parse_err(const struct nlmsghdr *nlh, struct gnl_ext_ack *ack);
+
+/**
+ * Prints the NLMSG_ERROR message `nlh` with the error message and offending attribute to stderr,
+ * prefixed with `prefix`.
+ */
+void gnl_msg_print_err(const struct nlmsghdr *nlh, const char *prefix);
@@ -0,0 +1,159 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-config.h". */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnl-config.h"
+
+#define LOG_PREFIX "[gnl-config] "
+
+/** A tunable: its attribute and where its value is in `struct gnl_foobar_xmpl_attrs`. */
+struct knob {
+    const char *name;
+    __u16 attr;
+    /** 1 for u8 (boolean) or 4 for u32 tunables. */
+    size_t size;
+    size_t offset;
+};
+
+#define KNOB(name, attr, field) {name, attr, sizeof(((struct gnl_foobar_xmpl_attrs *) 0)->field), \
+                                 offsetof(struct gnl_foobar_xmpl_attrs, field)}
+
+static const struct knob knobs[] = {
+        KNOB("dump-runs", GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS, config_dump_runs),
+        KNOB("verbose", GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE, config_verbose),
+        KNOB("zerocopy-echo", GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO, config_zerocopy_echo),
+        KNOB("zerocopy-min-len", GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN, config_zerocopy_min_len),
+        KNOB("xfer-window", GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW, config_xfer_window),
+        KNOB("checksum-max-batch", GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH, config_checksum_max_batch),
+        KNOB("dump-max-in-flight", GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT, config_dump_max_in_flight),
+        KNOB("dump-max-records", GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS, config_dump_max_records),
+};
+
+#define KNOBS_LEN (sizeof(knobs) / sizeof(knobs[0]))
+
+static __u32 knob_value(const struct knob *k, const struct gnl_foobar_xmpl_attrs *config) {
+    const char *field = (const char *) config + k->offset;
+    __u8 u8;
+    __u32 u32;
+
+    if (k->size == sizeof(__u8)) {
+        memcpy(&u8, field, sizeof(u8));
+        return u8;
+    }
+    memcpy(&u32, field, sizeof(u32));
+    return u32;
+}
+
+/**
+ * Sends the request `nlh` and decodes the config of the reply.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int config_request(struct gnl_client *client, struct nlmsghdr *nlh, char *buf, size_t len,
+                          struct gnl_foobar_xmpl_attrs *config) {
+    ssize_t rc;
+
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+    rc = gnl_client_recv(client, buf, len);
+    nlh = (struct nlmsghdr *) buf;
+    if (rc < 0 || !NLMSG_OK(nlh, rc)) {
+        return -1;
+    }
+    if (nlh->nlmsg_type == NLMSG_ERROR) {
+        gnl_msg_print_err(nlh, LOG_PREFIX);
+        return -1;
+    }
+    // GET_CONFIG and SET_CONFIG have the same reply
+    if (gnl_foobar_xmpl_get_config_reply_parse(nlh, config) < 0) {
+        fprintf(stderr, LOG_PREFIX "invalid config reply\n");
+        return -1;
+    }
+    return 0;
+}
+
+int gnl_config_get(struct gnl_client *client, struct gnl_foobar_xmpl_attrs *config) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = gnl_foobar_xmpl_get_config_init(buf, client->family_id, 0, client->seq++);
+
+    return config_request(client, nlh, buf, sizeof(buf), config);
+}
+
+int gnl_config_set(struct gnl_client *client, char *const *assignments, int count,
+                   struct gnl_foobar_xmpl_attrs *config) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = gnl_foobar_xmpl_set_config_init(buf, client->family_id, 0, client->seq++);
+    int i;
+
+    if (count > (int) KNOBS_LEN) {
+        fprintf(stderr, LOG_PREFIX "too many assignments\n");
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        const char *eq = strchr(assignments[i], '=');
+        const struct knob *k = NULL;
+        unsigned long value;
+        char *end;
+        size_t j;
+
+        for (j = 0; eq != NULL && j < KNOBS_LEN; j++) {
+            if (strlen(knobs[j].name) == (size_t) (eq - assignments[i]) &&
+                strncmp(knobs[j].name, assignments[i], eq - assignments[i]) == 0) {
+                k = &knobs[j];
+            }
+        }
+        if (k == NULL) {
+            fprintf(stderr, LOG_PREFIX "expected <name>=<value> with a known name: '%s'\n", assignments[i]);
+            return -1;
+        }
+        value = strtoul(eq + 1, &end, 0);
+        if (eq[1] == '\0' || *end != '\0' || value > (k->size == sizeof(__u8) ? 0xffUL : 0xffffffffUL)) {
+            fprintf(stderr, LOG_PREFIX "invalid value: '%s'\n", assignments[i]);
+            return -1;
+        }
+        // the kernel checks the ranges; see the policy in the spec
+        if (k->size == sizeof(__u8)) {
+            __u8 u8 = value;
+
+            __gnl_foobar_xmpl_put(nlh, k->attr, &u8, sizeof(u8));
+        } else {
+            __u32 u32 = value;
+
+            __gnl_foobar_xmpl_put(nlh, k->attr, &u32, sizeof(u32));
+        }
+    }
+    return config_request(client, nlh, buf, sizeof(buf), config);
+}
+
+void gnl_config_print(FILE *f, const char *prefix, const struct gnl_foobar_xmpl_attrs *config) {
+    size_t i;
+
+    for (i = 0; i < KNOBS_LEN; i++) {
+        if (GNL_FOOBAR_XMPL_ATTR_PRESENT(config, knobs[i].attr)) {
+            fprintf(f, "%s%s=%u\n", prefix, knobs[i].name, knob_value(&knobs[i], config));
+        }
+    }
+}
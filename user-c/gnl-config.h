@@ -0,0 +1,54 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Runtime tunables of the kernel module (`GNL_FOOBAR_XMPL_C_GET_CONFIG` / `GNL_FOOBAR_XMPL_C_SET_CONFIG`).
+ * They are addressed by the names of their attributes without the "config-" prefix, e.g. "dump-runs".
+ * Changes take effect for the next request of every client, hence they can be made while a benchmark
+ * runs (see "gnl-tune.c").
+ */
+
+#include <stdio.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+/**
+ * Queries all tunables. They are in the `config_*` fields of `config`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_config_get(struct gnl_client *client, struct gnl_foobar_xmpl_attrs *config);
+
+/**
+ * Changes the tunables of `count` assignments "<name>=<value>" at once; the others keep their values.
+ * Requires CAP_NET_ADMIN. `config` receives the new values of all tunables.
+ *
+ * @return < 0 on failure (e.g. an unknown name or an invalid value) or 0 on success.
+ */
+int gnl_config_set(struct gnl_client *client, char *const *assignments, int count,
+                   struct gnl_foobar_xmpl_attrs *config);
+
+/**
+ * Prints the tunables of `config` as "<name>=<value>", one per line.
+ */
+void gnl_config_print(FILE *f, const char *prefix, const struct gnl_foobar_xmpl_attrs *config);
@@ -0,0 +1,361 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-dump.h". */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-dump.h"
+
+#define LOG_PREFIX "[gnl-dump] "
+
+/** Initial capacity of the record index of a buffer per byte of the buffer; it grows if needed. */
+#define RECORDS_PER_BYTE (1.0 / 256)
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/**
+ * Decodes the records [first, last) of `b` and remembers the first malformed one.
+ */
+static void decode_chunk(const struct gnl_dump *dump, struct gnl_dump_buf *b, unsigned long first,
+                         unsigned long last) {
+    unsigned long i, bad;
+
+    for (i = first; i < last; i++) {
+        if (dump->parse(b->msgs[i], &b->attrs[i]) < 0) {
+            bad = __atomic_load_n(&b->bad, __ATOMIC_RELAXED);
+            while (i < bad &&
+                   !__atomic_compare_exchange_n(&b->bad, &bad, i, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            }
+            // the records behind it are never delivered
+            break;
+        }
+    }
+    __atomic_add_fetch(&b->decoded, last - first, __ATOMIC_RELEASE);
+}
+
+/**
+ * Claims and decodes chunks of `b` until none are left.
+ *
+ * @return the number of records decoded by the calling thread.
+ */
+static unsigned long decode_chunks(const struct gnl_dump *dump, struct gnl_dump_buf *b) {
+    unsigned long first, last, n = 0;
+
+    for (;;) {
+        first = __atomic_fetch_add(&b->next, GNL_DUMP_CHUNK, __ATOMIC_ACQUIRE);
+        if (first >= b->count) {
+            return n;
+        }
+        last = first + GNL_DUMP_CHUNK < b->count ? first + GNL_DUMP_CHUNK : b->count;
+        decode_chunk(dump, b, first, last);
+        n += last - first;
+    }
+}
+
+static void *worker_thread(void *arg) {
+    struct gnl_dump *dump = arg;
+    struct gnl_dump_buf *b;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&dump->lock);
+    for (;;) {
+        while (!dump->stop && dump->handouts == seen) {
+            pthread_cond_wait(&dump->cond, &dump->lock);
+        }
+        if (dump->stop) {
+            break;
+        }
+        seen = dump->handouts;
+        b = dump->current;
+        // under the lock, so that the buffer isn't refilled before we leave it again
+        __atomic_add_fetch(&b->users, 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&dump->lock);
+
+        decode_chunks(dump, b);
+
+        __atomic_sub_fetch(&b->users, 1, __ATOMIC_RELEASE);
+        pthread_mutex_lock(&dump->lock);
+    }
+    pthread_mutex_unlock(&dump->lock);
+    return NULL;
+}
+
+/**
+ * Doubles the capacity of the record index of `b`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int grow(struct gnl_dump_buf *b) {
+    unsigned long cap = b->cap * 2;
+    const struct nlmsghdr **msgs = realloc(b->msgs, cap * sizeof(*msgs));
+    struct gnl_foobar_xmpl_attrs *attrs;
+
+    if (msgs == NULL) {
+        return -1;
+    }
+    b->msgs = msgs;
+    attrs = realloc(b->attrs, cap * sizeof(*attrs));
+    if (attrs == NULL) {
+        return -1;
+    }
+    b->attrs = attrs;
+    b->cap = cap;
+    return 0;
+}
+
+/**
+ * Receives datagrams into `b` until less than one datagram fits or the dump is done (`*done` is set) and
+ * indexes the records. With `drop`, the records are not indexed.
+ *
+ * @return < 0 if a receive failed, 1 if the kernel replied with an error or 0 on success.
+ */
+static int fill(struct gnl_dump *dump, struct gnl_dump_buf *b, int drop, int *done) {
+    unsigned long count = 0;
+    int rc = 0;
+
+    // a worker that came late for the previous records of the buffer may not have left it yet
+    while (__atomic_load_n(&b->users, __ATOMIC_ACQUIRE) > 0) {
+        cpu_relax();
+    }
+    b->len = 0;
+    while (!*done && dump->buf_len - b->len >= GNL_DUMP_DATAGRAM_LEN) {
+        ssize_t received = gnl_client_recv(dump->client, b->data + b->len, dump->buf_len - b->len);
+        ssize_t len = received;
+        const struct nlmsghdr *nlh;
+
+        if (received < 0) {
+            rc = -1;
+            break;
+        }
+        dump->stats.datagrams++;
+        for (nlh = (struct nlmsghdr *) (b->data + b->len); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                *done = 1;
+                break;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                gnl_msg_print_err(nlh, LOG_PREFIX);
+                *done = 1;
+                rc = 1;
+                break;
+            }
+            if (drop) {
+                continue;
+            }
+            if (count == b->cap && grow(b) < 0) {
+                fprintf(stderr, LOG_PREFIX "out of memory\n");
+                rc = -1;
+                break;
+            }
+            b->msgs[count++] = nlh;
+        }
+        if (rc < 0) {
+            break;
+        }
+        b->len += NLMSG_ALIGN(received);
+    }
+    b->count = count;
+    dump->stats.buffers++;
+    return rc;
+}
+
+/**
+ * Hands the records of `b` to the workers.
+ */
+static void hand_out(struct gnl_dump *dump, struct gnl_dump_buf *b) {
+    b->decoded = 0;
+    b->bad = b->count;
+    __atomic_store_n(&b->next, 0, __ATOMIC_RELEASE);
+    if (dump->workers == 0) {
+        return;
+    }
+    // even without records: the buffer that the workers may take is never the one that is being filled
+    pthread_mutex_lock(&dump->lock);
+    dump->current = b;
+    dump->handouts++;
+    if (b->count > 0) {
+        pthread_cond_broadcast(&dump->cond);
+    }
+    pthread_mutex_unlock(&dump->lock);
+}
+
+/**
+ * Decodes the records of `b` that no worker claimed yet and waits until the workers have decoded theirs.
+ */
+static void finish(struct gnl_dump *dump, struct gnl_dump_buf *b) {
+    __u64 start;
+
+    dump->stats.decoded_by_caller += decode_chunks(dump, b);
+    if (__atomic_load_n(&b->decoded, __ATOMIC_ACQUIRE) == b->count) {
+        return;
+    }
+    // at most one chunk per worker is left
+    start = monotonic_ns();
+    while (__atomic_load_n(&b->decoded, __ATOMIC_ACQUIRE) < b->count) {
+        cpu_relax();
+    }
+    dump->stats.wait_ns += monotonic_ns() - start;
+}
+
+/**
+ * Delivers the decoded records of `b` to `cb`.
+ *
+ * @return < 0 on failure or the number of delivered records.
+ */
+static long deliver(const struct gnl_dump_buf *b, gnl_dump_record_fn cb, void *arg) {
+    unsigned long i;
+
+    for (i = 0; i < b->bad; i++) {
+        if (cb(b->msgs[i], &b->attrs[i], arg) < 0) {
+            return -1;
+        }
+    }
+    if (b->bad < b->count) {
+        fprintf(stderr, LOG_PREFIX "invalid dump record\n");
+        return -1;
+    }
+    return b->count;
+}
+
+long gnl_dump_run(struct gnl_dump *dump, const struct nlmsghdr *nlh, gnl_dump_parse_fn parse,
+                  gnl_dump_record_fn cb, void *arg) {
+    // `current` is only written by this thread
+    struct gnl_dump_buf *prev = NULL, *cur = dump->current == &dump->bufs[0] ? &dump->bufs[1] : &dump->bufs[0];
+    long records = 0, n;
+    int done = 0, failed = 0, rc;
+
+    if (gnl_client_send(dump->client, nlh) < 0) {
+        return -1;
+    }
+    // workers only read it after they took a buffer under the lock
+    dump->parse = parse;
+    while (!done) {
+        rc = fill(dump, cur, failed, &done);
+        if (rc < 0) {
+            // the rest of the dump can't be received; the workers must be done with the previous buffer
+            // before the next dump changes the parser
+            if (prev != NULL) {
+                finish(dump, prev);
+            }
+            return -1;
+        }
+        failed |= rc;
+        if (prev != NULL) {
+            finish(dump, prev);
+        }
+        hand_out(dump, cur);
+        if (prev != NULL && !failed) {
+            n = deliver(prev, cb, arg);
+            failed |= n < 0;
+            records += n;
+        }
+        prev = cur;
+        cur = cur == &dump->bufs[0] ? &dump->bufs[1] : &dump->bufs[0];
+    }
+    finish(dump, prev);
+    if (!failed) {
+        n = deliver(prev, cb, arg);
+        failed |= n < 0;
+        records += n;
+    }
+    dump->stats.dumps++;
+    dump->stats.records += records;
+    return failed ? -1 : records;
+}
+
+static void free_bufs(struct gnl_dump *dump) {
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        free(dump->bufs[i].data);
+        free(dump->bufs[i].msgs);
+        free(dump->bufs[i].attrs);
+    }
+}
+
+int gnl_dump_open(struct gnl_dump *dump, struct gnl_client *client, int workers, size_t buf_len) {
+    int i;
+
+    memset(dump, 0, sizeof(*dump));
+    if (workers < 0 || workers > GNL_DUMP_MAX_WORKERS) {
+        fprintf(stderr, LOG_PREFIX "invalid number of workers: %d\n", workers);
+        return -1;
+    }
+    dump->client = client;
+    dump->buf_len = buf_len > 0 ? buf_len : GNL_DUMP_DEFAULT_BUF_LEN;
+    if (dump->buf_len < GNL_DUMP_DATAGRAM_LEN) {
+        fprintf(stderr, LOG_PREFIX "receive buffers must hold at least one datagram\n");
+        return -1;
+    }
+    for (i = 0; i < 2; i++) {
+        struct gnl_dump_buf *b = &dump->bufs[i];
+
+        b->cap = dump->buf_len * RECORDS_PER_BYTE;
+        b->data = malloc(dump->buf_len);
+        b->msgs = malloc(b->cap * sizeof(*b->msgs));
+        b->attrs = malloc(b->cap * sizeof(*b->attrs));
+        if (b->data == NULL || b->msgs == NULL || b->attrs == NULL) {
+            fprintf(stderr, LOG_PREFIX "out of memory\n");
+            free_bufs(dump);
+            return -1;
+        }
+    }
+    pthread_mutex_init(&dump->lock, NULL);
+    pthread_cond_init(&dump->cond, NULL);
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&dump->threads[i], NULL, worker_thread, dump) != 0) {
+            fprintf(stderr, LOG_PREFIX "can't start the worker threads\n");
+            gnl_dump_close(dump);
+            return -1;
+        }
+        dump->workers++;
+    }
+    return 0;
+}
+
+void gnl_dump_close(struct gnl_dump *dump) {
+    int i;
+
+    pthread_mutex_lock(&dump->lock);
+    dump->stop = 1;
+    pthread_cond_broadcast(&dump->cond);
+    pthread_mutex_unlock(&dump->lock);
+    for (i = 0; i < dump->workers; i++) {
+        pthread_join(dump->threads[i], NULL);
+    }
+    pthread_cond_destroy(&dump->cond);
+    pthread_mutex_destroy(&dump->lock);
+    free_bufs(dump);
+}
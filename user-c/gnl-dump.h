@@ -0,0 +1,144 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Dump consumer that decodes the records of a dump on worker threads while the next datagrams are received.
+ *
+ * There are two receive buffers. The calling thread fills one with datagrams (until less than one datagram
+ * fits or the dump is done) and indexes its messages; meanwhile the workers decode the records of the other
+ * buffer with the parser of the command, `GNL_DUMP_CHUNK` records at a time. Once a buffer is received, the
+ * caller finishes the decoding of the previous one (it decodes the chunks that no worker claimed yet), hands
+ * the new one to the workers and delivers the decoded records of the previous one to the callback, in the
+ * order of the dump. Then it receives into the previous buffer again.
+ *
+ * With 0 workers, the caller receives, decodes and delivers one buffer after another, like the plain
+ * receive loops of the benchmarks.
+ */
+
+#include <pthread.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+/** Room for one datagram at the end of a receive buffer; dump datagrams are at most 32 KiB + a page. */
+#define GNL_DUMP_DATAGRAM_LEN (64 * 1024)
+/** Default length of each of the two receive buffers. */
+#define GNL_DUMP_DEFAULT_BUF_LEN (1024 * 1024)
+/** Number of records that a worker claims at once. */
+#define GNL_DUMP_CHUNK 64
+/** Max. number of worker threads. */
+#define GNL_DUMP_MAX_WORKERS 64
+
+/**
+ * Parser of a record, e.g. `gnl_foobar_xmpl_echo_msg_reply_parse()`.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+typedef int (*gnl_dump_parse_fn)(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs);
+
+/**
+ * Callback for each record. The pointers in `attrs` point into `nlh`; both are only valid during the call.
+ *
+ * @return < 0 to stop the dump or 0 to continue.
+ */
+typedef int (*gnl_dump_record_fn)(const struct nlmsghdr *nlh, const struct gnl_foobar_xmpl_attrs *attrs,
+                                  void *arg);
+
+/**
+ * A receive buffer and the records in it.
+ */
+struct gnl_dump_buf {
+    char *data;
+    /** Received bytes. */
+    size_t len;
+    /** Records (all messages except NLMSG_DONE and NLMSG_ERROR) and their decoded attributes. */
+    const struct nlmsghdr **msgs;
+    struct gnl_foobar_xmpl_attrs *attrs;
+    /** Capacity of `msgs` and `attrs`. */
+    unsigned long cap;
+    unsigned long count;
+    /** First record that no one claimed yet. */
+    unsigned long next;
+    /** Number of decoded records; the buffer is decoded when it reaches `count`. */
+    unsigned long decoded;
+    /** Index of the first malformed record or `count`. */
+    unsigned long bad;
+    /** Workers that took the buffer; it is only refilled when they have left it. */
+    int users;
+};
+
+/** Counters of all dumps of a consumer. */
+struct gnl_dump_stats {
+    unsigned long dumps;
+    /** Records delivered to the callbacks. */
+    unsigned long records;
+    /** Number of recv() calls. */
+    unsigned long datagrams;
+    /** Number of filled receive buffers. */
+    unsigned long buffers;
+    /** Records that the calling thread decoded itself because no worker claimed them in time. */
+    unsigned long decoded_by_caller;
+    /** Time that the calling thread spent waiting for workers to finish their chunks. */
+    unsigned long long wait_ns;
+};
+
+struct gnl_dump {
+    struct gnl_client *client;
+    struct gnl_dump_buf bufs[2];
+    size_t buf_len;
+    /** Parser of the running dump. */
+    gnl_dump_parse_fn parse;
+    int workers;
+    pthread_t threads[GNL_DUMP_MAX_WORKERS];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    /** Buffer that the workers decode; protected by `lock`. */
+    struct gnl_dump_buf *current;
+    /** Incremented for each buffer that is handed out; protected by `lock`. */
+    unsigned long handouts;
+    /** Protected by `lock`. */
+    int stop;
+    struct gnl_dump_stats stats;
+};
+
+/**
+ * Allocates two receive buffers of `buf_len` bytes (0 for `GNL_DUMP_DEFAULT_BUF_LEN`) and starts `workers`
+ * decoding threads (0 to `GNL_DUMP_MAX_WORKERS`) for dumps on the socket of `client`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_dump_open(struct gnl_dump *dump, struct gnl_client *client, int workers, size_t buf_len);
+
+/**
+ * Stops the workers and frees the buffers. The client stays open.
+ */
+void gnl_dump_close(struct gnl_dump *dump);
+
+/**
+ * Sends the dump request `nlh` (`NLM_F_DUMP` must be set), decodes each record with `parse` and calls `cb`
+ * for it in the order of the dump. If `cb` stops the dump, a record is malformed or the kernel replies with
+ * an error, the rest of the dump is received and dropped, so the socket is ready for the next request.
+ *
+ * @return < 0 on failure or the number of delivered records.
+ */
+long gnl_dump_run(struct gnl_dump *dump, const struct nlmsghdr *nlh, gnl_dump_parse_fn parse,
+                  gnl_dump_record_fn cb, void *arg);
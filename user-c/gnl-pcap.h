@@ -0,0 +1,91 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * pcap file format as written by a capture on a nlmon device (see https://www.tcpdump.org/linktypes.html):
+ *
+ *   file header (`struct gnl_pcap_file_hdr`, host byte order)
+ *   per datagram:
+ *     record header (`struct gnl_pcap_rec_hdr`, host byte order)
+ *     `struct gnl_pcap_netlink_hdr` (LINKTYPE_NETLINK, same layout as LINKTYPE_LINUX_SLL, big endian)
+ *     the datagram: one or more Netlink messages (host byte order)
+ *
+ * We write timestamps with nanosecond resolution (magic `GNL_PCAP_MAGIC_NS`).
+ */
+
+#include <string.h>
+#include <arpa/inet.h>
+
+#include <linux/if_arp.h>
+#include <linux/netlink.h>
+#include <linux/types.h>
+
+#define GNL_PCAP_MAGIC_US 0xa1b2c3d4
+#define GNL_PCAP_MAGIC_NS 0xa1b23c4d
+#define GNL_PCAP_LINKTYPE_NETLINK 253
+/** Max. bytes per record (link header + datagram); longer datagrams are truncated. */
+#define GNL_PCAP_SNAPLEN (256 * 1024)
+/** `pkttype` of datagrams to a userland socket (PACKET_USER), as set by nlmon. */
+#define GNL_PCAP_PKTTYPE_USER 6
+/** `pkttype` of datagrams to a kernel socket (PACKET_KERNEL), as set by nlmon. */
+#define GNL_PCAP_PKTTYPE_KERNEL 7
+
+struct gnl_pcap_file_hdr {
+    __u32 magic;
+    __u16 version_major;
+    __u16 version_minor;
+    __s32 thiszone;
+    __u32 sigfigs;
+    __u32 snaplen;
+    __u32 linktype;
+};
+
+struct gnl_pcap_rec_hdr {
+    __u32 ts_sec;
+    /** Nanoseconds or microseconds, depending on the magic of the file. */
+    __u32 ts_nsec;
+    /** Number of bytes of the record in the file. */
+    __u32 caplen;
+    /** Original length of the packet. */
+    __u32 len;
+};
+
+struct gnl_pcap_netlink_hdr {
+    __be16 pkttype;
+    /** ARPHRD_NETLINK */
+    __be16 hatype;
+    __be16 halen;
+    __u8 addr[8];
+    /** Netlink protocol, i.e. NETLINK_GENERIC */
+    __be16 protocol;
+};
+
+/**
+ * Initializes the link header of a datagram to the kernel (`to_kernel`) or from the kernel, with the
+ * same `pkttype` that nlmon uses, i.e. by the kind of the receiving socket.
+ */
+static inline void gnl_pcap_netlink_hdr_init(struct gnl_pcap_netlink_hdr *nl, int to_kernel) {
+    memset(nl, 0, sizeof(*nl));
+    nl->pkttype = htons(to_kernel ? GNL_PCAP_PKTTYPE_KERNEL : GNL_PCAP_PKTTYPE_USER);
+    nl->hatype = htons(ARPHRD_NETLINK);
+    nl->protocol = htons(NETLINK_GENERIC);
+}
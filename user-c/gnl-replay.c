@@ -0,0 +1,438 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Replays a capture of "gnl-capture.h" (or of a nlmon device, see README) against the kernel module
+ * and reports the latency of each request, overall and per command.
+ *
+ * Only requests from the userland to our family are replayed; lookups of the family id via the
+ * Generic Netlink controller are skipped, as are replies and messages of other families. A datagram
+ * may carry several requests (e.g. of the submission queue, see "gnl-submit.h"); each of them is
+ * replayed on its own. Our family
+ * is recognized by the id in the captured replies of the controller (e.g. to CTRL_CMD_GETFAMILY),
+ * hence the capture must include the lookup; all clients of this repository do it first. Each
+ * request is sent with the family id of the currently loaded module and a new sequence number.
+ * Requests are sent one after another on a single socket, like the benchmarks do: a request is
+ * complete with NLMSG_DONE (dumps), with the ACK (`NLM_F_ACK`) or with the first reply otherwise.
+ *
+ * Without `speed`, requests are sent at their original time offsets. `speed` scales them, e.g. 2
+ * replays twice as fast. With a speed of 0 requests are sent back to back. A request that is due
+ * while the previous one is still in flight is sent as soon as possible; the number of these late
+ * requests is reported, because they indicate that the module is slower than in the capture.
+ *
+ * Usage: ./gnl-replay <capture.pcap> [speed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gnl-client.h"
+#include "gnl-pcap.h"
+#include "gnl_foobar_xmpl_prop.h"
+
+#define LOG_PREFIX "[gnl-replay] "
+
+/** Large enough for any datagram of the capture and any datagram of a dump. */
+#define BUF_LEN GNL_PCAP_SNAPLEN
+
+/** A request of the capture. */
+struct replay_req {
+    /** Capture time in nanoseconds. */
+    __u64 ts;
+    /** Points into the mapped capture. */
+    const struct nlmsghdr *nlh;
+};
+
+/** Latencies of all requests of one kind. */
+struct replay_stats {
+    long count;
+    long errors;
+    __u64 *samples;
+};
+
+/** Requests are grouped by command and whether they are dumps. */
+#define REPLAY_STATS_LEN (256 * 2)
+
+static const char *const cmd_names[GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN] = {
+        [GNL_FOOBAR_XMPL_C_ECHO_MSG] = "echo-msg",
+        [GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR] = "reply-with-nlmsg-err",
+        [GNL_FOOBAR_XMPL_C_PING] = "ping",
+        [GNL_FOOBAR_XMPL_C_XFER_BEGIN] = "xfer-begin",
+        [GNL_FOOBAR_XMPL_C_XFER_CHUNK] = "xfer-chunk",
+        [GNL_FOOBAR_XMPL_C_XFER_COMMIT] = "xfer-commit",
+        [GNL_FOOBAR_XMPL_C_XFER_GET] = "xfer-get",
+        [GNL_FOOBAR_XMPL_C_XFER_ABORT] = "xfer-abort",
+        [GNL_FOOBAR_XMPL_C_RING_CREATE] = "ring-create",
+        [GNL_FOOBAR_XMPL_C_RING_DOORBELL] = "ring-doorbell",
+        [GNL_FOOBAR_XMPL_C_RING_STATS] = "ring-stats",
+        [GNL_FOOBAR_XMPL_C_RING_DESTROY] = "ring-destroy",
+        [GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE] = "event-subscribe",
+        [GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE] = "event-unsubscribe",
+        [GNL_FOOBAR_XMPL_C_EVENT_EMIT] = "event-emit",
+        [GNL_FOOBAR_XMPL_C_CHECKSUM] = "checksum",
+        [GNL_FOOBAR_XMPL_C_GET_CONFIG] = "get-config",
+        [GNL_FOOBAR_XMPL_C_SET_CONFIG] = "set-config",
+        [GNL_FOOBAR_XMPL_C_GET_GENERATION] = "get-generation",
+        [GNL_FOOBAR_XMPL_C_PORT_STATS] = "port-stats",
+};
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    const __u64 x = *(const __u64 *) a, y = *(const __u64 *) b;
+    return x < y ? -1 : x > y;
+}
+
+/** Orders requests by capture time; requests with the same time keep their order in the capture. */
+static int compare_req(const void *a, const void *b) {
+    const struct replay_req *x = a, *y = b;
+
+    if (x->ts != y->ts) {
+        return x->ts < y->ts ? -1 : 1;
+    }
+    return x->nlh < y->nlh ? -1 : x->nlh > y->nlh;
+}
+
+/**
+ * Reads the whole file `path` into memory.
+ *
+ * @return NULL on failure or the content (to be freed by the caller).
+ */
+static char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    char *data;
+    long size;
+
+    if (f == NULL) {
+        perror(LOG_PREFIX "fopen()");
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) < 0 || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) < 0) {
+        perror(LOG_PREFIX "fseek()");
+        fclose(f);
+        return NULL;
+    }
+    data = malloc(size > 0 ? size : 1);
+    if (data == NULL || fread(data, 1, size, f) != (size_t) size) {
+        fprintf(stderr, LOG_PREFIX "can't read '%s'\n", path);
+        free(data);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *len = size;
+    return data;
+}
+
+/** The ids of our family in the capture, one bit per id. More than one if the module was reloaded. */
+static unsigned char family_ids[(0xffff + 1) / 8];
+static int family_id_count;
+
+static int is_family_id(__u16 id) {
+    return family_ids[id / 8] & (1 << (id % 8));
+}
+
+/**
+ * Remembers the id of our family if the datagram `nlh` of length `len` to the userland contains a reply
+ * of the Generic Netlink controller about our family.
+ */
+static void find_family_id(const struct nlmsghdr *nlh, int len) {
+    for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+        const struct nlattr *na = (const struct nlattr *) ((const char *) NLMSG_DATA(nlh) + GENL_HDRLEN);
+        int remaining = (int) nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+        int is_ours = 0, id = -1;
+
+        if (nlh->nlmsg_type != GENL_ID_CTRL || remaining < 0 ||
+            ((const struct genlmsghdr *) NLMSG_DATA(nlh))->cmd != CTRL_CMD_NEWFAMILY) {
+            continue;
+        }
+        while (remaining >= NLA_HDRLEN && na->nla_len >= NLA_HDRLEN && na->nla_len <= remaining) {
+            if (na->nla_type == CTRL_ATTR_FAMILY_NAME) {
+                is_ours = na->nla_len == NLA_HDRLEN + sizeof(FAMILY_NAME) &&
+                          memcmp(NLA_DATA(na), FAMILY_NAME, sizeof(FAMILY_NAME)) == 0;
+            } else if (na->nla_type == CTRL_ATTR_FAMILY_ID && na->nla_len >= NLA_HDRLEN + sizeof(__u16)) {
+                id = *(const __u16 *) NLA_DATA(na);
+            }
+            remaining -= NLA_ALIGN(na->nla_len);
+            na = (const struct nlattr *) ((const char *) na + NLA_ALIGN(na->nla_len));
+        }
+        if (is_ours && id >= 0 && !is_family_id(id)) {
+            family_ids[id / 8] |= 1 << (id % 8);
+            family_id_count++;
+        }
+    }
+}
+
+/**
+ * Collects the requests to our family from the capture `data`. The first pass finds the ids of our
+ * family, the second pass the requests; records of different threads aren't in time order anyway.
+ *
+ * @return < 0 on failure or the number of requests in `reqs` (to be freed by the caller).
+ */
+static long parse_capture(const char *data, size_t len, struct replay_req **reqs) {
+    const struct gnl_pcap_file_hdr *hdr = (const struct gnl_pcap_file_hdr *) data;
+    size_t offset = sizeof(*hdr);
+    long count = 0, capacity = 1024;
+    __u64 ts_scale;
+    int pass;
+
+    if (len < sizeof(*hdr) || (hdr->magic != GNL_PCAP_MAGIC_NS && hdr->magic != GNL_PCAP_MAGIC_US)) {
+        fprintf(stderr, LOG_PREFIX "not a pcap file in host byte order\n");
+        return -1;
+    }
+    if (hdr->linktype != GNL_PCAP_LINKTYPE_NETLINK) {
+        fprintf(stderr, LOG_PREFIX "unsupported link type %u; expected LINKTYPE_NETLINK\n", hdr->linktype);
+        return -1;
+    }
+    ts_scale = hdr->magic == GNL_PCAP_MAGIC_NS ? 1 : 1000;
+
+    *reqs = malloc(capacity * sizeof(**reqs));
+    if (*reqs == NULL) {
+        return -1;
+    }
+    for (pass = 0; pass < 2; pass++, offset = sizeof(*hdr)) {
+        while (offset + sizeof(struct gnl_pcap_rec_hdr) <= len) {
+            const struct gnl_pcap_rec_hdr *rec = (const struct gnl_pcap_rec_hdr *) (data + offset);
+            const struct gnl_pcap_netlink_hdr *nl = (const struct gnl_pcap_netlink_hdr *) (rec + 1);
+            const struct nlmsghdr *nlh = (const struct nlmsghdr *) (nl + 1);
+            int nl_len = (int) rec->caplen - (int) sizeof(*nl);
+
+            offset += sizeof(*rec) + rec->caplen;
+            if (offset > len) {
+                if (pass == 0) {
+                    fprintf(stderr, LOG_PREFIX "capture is truncated; ignoring the last record\n");
+                }
+                break;
+            }
+            if (nl_len < (int) NLMSG_HDRLEN || ntohs(nl->protocol) != NETLINK_GENERIC) {
+                continue;
+            }
+            if (pass == 0) {
+                if (ntohs(nl->pkttype) == GNL_PCAP_PKTTYPE_USER) {
+                    find_family_id(nlh, nl_len);
+                }
+                continue;
+            }
+            // only complete datagrams from the userland
+            if (rec->caplen != rec->len || ntohs(nl->pkttype) != GNL_PCAP_PKTTYPE_KERNEL) {
+                continue;
+            }
+            // every request to our family in the datagram; they keep their order as they share the time
+            for (; NLMSG_OK(nlh, nl_len); nlh = NLMSG_NEXT(nlh, nl_len)) {
+                if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN) || nlh->nlmsg_type < NLMSG_MIN_TYPE ||
+                    !is_family_id(nlh->nlmsg_type)) {
+                    continue;
+                }
+                if (count == capacity) {
+                    struct replay_req *grown = realloc(*reqs, 2 * capacity * sizeof(**reqs));
+                    if (grown == NULL) {
+                        free(*reqs);
+                        return -1;
+                    }
+                    *reqs = grown;
+                    capacity *= 2;
+                }
+                (*reqs)[count].ts = (__u64) rec->ts_sec * 1000000000ULL + (__u64) rec->ts_nsec * ts_scale;
+                (*reqs)[count].nlh = nlh;
+                count++;
+            }
+        }
+        if (pass == 0 && family_id_count == 0) {
+            fprintf(stderr, LOG_PREFIX "the capture has no reply of the controller about '" FAMILY_NAME "'; "
+                            "capture the lookup of the family id, too\n");
+            free(*reqs);
+            return -1;
+        }
+    }
+    return count;
+}
+
+/**
+ * Receives the replies to a request with flags `flags` until it is complete.
+ *
+ * @return < 0 on failure, 1 if the kernel replied with an error or 0 on success.
+ */
+static int recv_replies(struct gnl_client *client, char *buf, __u16 flags) {
+    int failed = 0;
+
+    for (;;) {
+        ssize_t len = gnl_client_recv(client, buf, BUF_LEN);
+        struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+
+        if (len < 0) {
+            return -1;
+        }
+        for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                // an ACK (error 0) or an error always ends a request
+                return ((struct nlmsgerr *) NLMSG_DATA(nlh))->error != 0 || failed;
+            }
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                if (!(flags & NLM_F_ACK)) {
+                    return failed;
+                }
+                continue;
+            }
+            if (!(flags & (NLM_F_DUMP | NLM_F_ACK))) {
+                return failed;
+            }
+        }
+    }
+}
+
+/**
+ * Sorts the samples of `stats` and prints their percentiles.
+ */
+static void print_stats(const char *name, const char *kind, struct replay_stats *stats) {
+    __u64 *s = stats->samples;
+    long n = stats->count;
+
+    qsort(s, n, sizeof(*s), compare_u64);
+    printf("%-20s %-4s | %8ld | %6ld | %8llu | %8llu | %8llu | %8llu | %8llu\n", name, kind, n, stats->errors,
+           (unsigned long long) s[0],
+           (unsigned long long) s[n / 2],
+           (unsigned long long) s[n * 99 / 100],
+           (unsigned long long) s[n * 999 / 1000],
+           (unsigned long long) s[n - 1]);
+}
+
+int main(int argc, char **argv) {
+    static char buf[BUF_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+    static struct replay_stats stats[REPLAY_STATS_LEN];
+    struct replay_stats total = {0};
+    struct gnl_client client;
+    struct replay_req *reqs;
+    double speed = argc > 2 ? atof(argv[2]) : 1.0;
+    __u64 start, elapsed;
+    size_t capture_len;
+    char *capture;
+    long count, late = 0, i;
+    int k;
+
+    if (argc < 2 || speed < 0) {
+        fprintf(stderr, "usage: %s <capture.pcap> [speed]\n", argv[0]);
+        return 1;
+    }
+    capture = read_file(argv[1], &capture_len);
+    if (capture == NULL) {
+        return 1;
+    }
+    count = parse_capture(capture, capture_len, &reqs);
+    if (count < 0) {
+        return 1;
+    }
+    if (count == 0) {
+        fprintf(stderr, LOG_PREFIX "no requests to '" FAMILY_NAME "' in '%s'\n", argv[1]);
+        return 1;
+    }
+    // merged captures or captures of several CPUs aren't sorted; the schedule below needs increasing times
+    qsort(reqs, count, sizeof(*reqs), compare_req);
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    total.samples = malloc(count * sizeof(__u64));
+    if (total.samples == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return 1;
+    }
+
+    start = monotonic_ns();
+    for (i = 0; i < count; i++) {
+        const struct nlmsghdr *req = reqs[i].nlh;
+        struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+        struct replay_stats *s;
+        __u64 sent, latency;
+        int rc;
+
+        if (speed > 0) {
+            __u64 due = start + (__u64) ((reqs[i].ts - reqs[0].ts) / speed);
+            __u64 now = monotonic_ns();
+
+            if (now < due) {
+                struct timespec ts = {.tv_sec = due / 1000000000ULL, .tv_nsec = due % 1000000000ULL};
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+            } else if (now > due + 1000000) {
+                // more than 1 ms behind schedule
+                late++;
+            }
+        }
+
+        memcpy(buf, req, req->nlmsg_len);
+        nlh->nlmsg_type = client.family_id;
+        nlh->nlmsg_seq = client.seq++;
+        nlh->nlmsg_pid = 0;
+        sent = monotonic_ns();
+        if (gnl_client_send(&client, nlh) < 0) {
+            return 1;
+        }
+        rc = recv_replies(&client, buf, req->nlmsg_flags);
+        if (rc < 0) {
+            return 1;
+        }
+        latency = monotonic_ns() - sent;
+
+        k = ((struct genlmsghdr *) NLMSG_DATA(req))->cmd * 2 + ((req->nlmsg_flags & NLM_F_DUMP) == NLM_F_DUMP);
+        s = &stats[k];
+        if (s->samples == NULL) {
+            s->samples = malloc(count * sizeof(__u64));
+            if (s->samples == NULL) {
+                fprintf(stderr, LOG_PREFIX "out of memory\n");
+                return 1;
+            }
+        }
+        s->samples[s->count++] = latency;
+        s->errors += rc;
+        total.samples[total.count++] = latency;
+        total.errors += rc;
+    }
+    elapsed = monotonic_ns() - start;
+
+    printf(LOG_PREFIX "replayed %ld requests in %.3f s (captured: %.3f s, speed %g, %ld late by > 1 ms)\n",
+           count, elapsed / 1e9, (reqs[count - 1].ts - reqs[0].ts) / 1e9, speed, late);
+    printf("%-25s |    count | errors |      min |      p50 |      p99 |    p99.9 |      max\n", "latency in ns");
+    for (k = 0; k < REPLAY_STATS_LEN; k++) {
+        char name[32];
+        int cmd = k / 2;
+
+        if (stats[k].count == 0) {
+            continue;
+        }
+        if (cmd < GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN && cmd_names[cmd] != NULL) {
+            snprintf(name, sizeof(name), "%s", cmd_names[cmd]);
+        } else {
+            snprintf(name, sizeof(name), "cmd %d", cmd);
+        }
+        print_stats(name, k % 2 ? "dump" : "do", &stats[k]);
+        free(stats[k].samples);
+    }
+    print_stats("all", "", &total);
+
+    free(total.samples);
+    free(reqs);
+    free(capture);
+    gnl_client_close(&client);
+    return 0;
+}
@@ -0,0 +1,198 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-ring.h". */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "gnl-ring.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[gnl-ring] "
+
+/** Path of the misc device of the kernel module. */
+#define RING_DEV_PATH "/dev/" GNL_FOOBAR_XMPL_RING_DEV
+
+/**
+ * Sends the request `nlh` and receives its reply into `buf`. Prints errors.
+ *
+ * @return < 0 on failure or on an error reply, or 0 on success.
+ */
+static int request(struct gnl_client *client, struct nlmsghdr *nlh, char *buf, size_t len) {
+    struct nlmsghdr *reply = (struct nlmsghdr *) buf;
+    ssize_t rc;
+
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+    rc = gnl_client_recv(client, buf, len);
+    if (rc < 0 || !NLMSG_OK(reply, rc)) {
+        return -1;
+    }
+    if (reply->nlmsg_type == NLMSG_ERROR && ((struct nlmsgerr *) NLMSG_DATA(reply))->error != 0) {
+        gnl_msg_print_err(reply, LOG_PREFIX);
+        return -1;
+    }
+    return 0;
+}
+
+int gnl_ring_create(struct gnl_client *client, struct gnl_ring *ring, __u32 entries, __u32 slot_size) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+    nlh = gnl_foobar_xmpl_ring_create_init(buf, client->family_id, 0, client->seq++);
+    gnl_foobar_xmpl_put_ring_entries(nlh, entries);
+    gnl_foobar_xmpl_put_ring_slot_size(nlh, slot_size);
+    if (request(client, nlh, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+    if (gnl_foobar_xmpl_ring_create_reply_parse((struct nlmsghdr *) buf, &attrs) < 0 ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_RING_ID) ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_RING_MMAP_LEN)) {
+        fprintf(stderr, LOG_PREFIX "invalid RING_CREATE reply\n");
+        return -1;
+    }
+    ring->id = attrs.ring_id;
+    ring->mmap_len = attrs.ring_mmap_len;
+
+    ring->fd = open(RING_DEV_PATH, O_RDWR | O_CLOEXEC);
+    if (ring->fd < 0) {
+        perror(LOG_PREFIX "open(" RING_DEV_PATH ")");
+        goto err_destroy;
+    }
+    // the page offset selects the ring
+    ring->mem = mmap(NULL, ring->mmap_len, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd,
+                     (off_t) ring->id * page_size);
+    if (ring->mem == MAP_FAILED) {
+        perror(LOG_PREFIX "mmap()");
+        ring->mem = NULL;
+        goto err_destroy;
+    }
+    ring->hdr = ring->mem;
+    ring->entries = ring->hdr->entries;
+    ring->slot_size = ring->hdr->slot_size;
+    ring->sq = (char *) ring->mem + ring->hdr->sq_off;
+    ring->cq = (char *) ring->mem + ring->hdr->cq_off;
+    return 0;
+
+err_destroy:
+    gnl_ring_destroy(client, ring);
+    return -1;
+}
+
+void gnl_ring_destroy(struct gnl_client *client, struct gnl_ring *ring) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh;
+
+    if (ring->mem != NULL) {
+        munmap(ring->mem, ring->mmap_len);
+        ring->mem = NULL;
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+        ring->fd = -1;
+    }
+    nlh = gnl_foobar_xmpl_ring_destroy_init(buf, client->family_id, NLM_F_ACK, client->seq++);
+    gnl_foobar_xmpl_put_ring_id(nlh, ring->id);
+    request(client, nlh, buf, sizeof(buf));
+}
+
+int gnl_ring_push(struct gnl_ring *ring, __u64 user_data, const void *data, __u32 len) {
+    struct gnl_foobar_xmpl_ring_rec *rec;
+    // the kernel frees slots concurrently; the acquire orders its reads of the slots before our writes
+    __u32 sq_head = __atomic_load_n(&ring->hdr->sq_head, __ATOMIC_ACQUIRE);
+
+    if (ring->sq_tail - sq_head >= ring->entries || len > gnl_ring_max_len(ring)) {
+        return -1;
+    }
+    rec = (struct gnl_foobar_xmpl_ring_rec *) (ring->sq + (ring->sq_tail & (ring->entries - 1)) * ring->slot_size);
+    rec->user_data = user_data;
+    rec->len = len;
+    memcpy(rec->data, data, len);
+    ring->sq_tail++;
+    return 0;
+}
+
+void gnl_ring_publish(struct gnl_ring *ring) {
+    __atomic_store_n(&ring->hdr->sq_tail, ring->sq_tail, __ATOMIC_RELEASE);
+}
+
+int gnl_ring_doorbell(struct gnl_client *client, struct gnl_ring *ring) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+
+    gnl_ring_publish(ring);
+    nlh = gnl_foobar_xmpl_ring_doorbell_init(buf, client->family_id, 0, client->seq++);
+    gnl_foobar_xmpl_put_ring_id(nlh, ring->id);
+    if (request(client, nlh, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+    if (gnl_foobar_xmpl_ring_doorbell_reply_parse((struct nlmsghdr *) buf, &attrs) < 0 ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_RING_COMPLETED)) {
+        fprintf(stderr, LOG_PREFIX "invalid RING_DOORBELL reply\n");
+        return -1;
+    }
+    return (int) attrs.ring_completed;
+}
+
+const struct gnl_foobar_xmpl_ring_rec *gnl_ring_peek_cqe(const struct gnl_ring *ring, __u32 i) {
+    // pairs with the store-release of the kernel: the completions up to the tail are complete
+    __u32 cq_tail = __atomic_load_n(&ring->hdr->cq_tail, __ATOMIC_ACQUIRE);
+
+    if (cq_tail - ring->cq_head <= i) {
+        return NULL;
+    }
+    return (const struct gnl_foobar_xmpl_ring_rec *) (ring->cq +
+                                                      ((ring->cq_head + i) & (ring->entries - 1)) * ring->slot_size);
+}
+
+void gnl_ring_cq_advance(struct gnl_ring *ring, __u32 n) {
+    ring->cq_head += n;
+    __atomic_store_n(&ring->hdr->cq_head, ring->cq_head, __ATOMIC_RELEASE);
+}
+
+int gnl_ring_get_stats(struct gnl_client *client, const struct gnl_ring *ring, struct gnl_ring_stats *stats) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+
+    nlh = gnl_foobar_xmpl_ring_stats_init(buf, client->family_id, 0, client->seq++);
+    gnl_foobar_xmpl_put_ring_id(nlh, ring->id);
+    if (request(client, nlh, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+    if (gnl_foobar_xmpl_ring_stats_reply_parse((struct nlmsghdr *) buf, &attrs) < 0) {
+        fprintf(stderr, LOG_PREFIX "invalid RING_STATS reply\n");
+        return -1;
+    }
+    stats->records = attrs.ring_records;
+    stats->bytes = attrs.ring_bytes;
+    stats->doorbells = attrs.ring_doorbells;
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Shared memory rings (`GNL_FOOBAR_XMPL_C_RING_*`): Netlink is only the control channel, the records
+ * travel through memory that the kernel module and this process share ("gnl_foobar_xmpl_ring.h").
+ *
+ * The client writes any number of records into the submission queue, publishes them and rings
+ * the doorbell with one small request. The kernel echoes all of them into the completion queue
+ * before it replies, hence a batch of N records costs one round trip instead of N and the
+ * payloads are never copied into or out of an skb.
+ *
+ * A ring has a single producer and a single consumer on each side; threads that share a ring must
+ * serialize their calls.
+ */
+
+#include <stddef.h>
+
+#include "gnl-client.h"
+#include "gnl_foobar_xmpl_ring.h"
+
+/**
+ * A mapped ring.
+ */
+struct gnl_ring {
+    /** Id of the ring in the kernel. */
+    __u32 id;
+    /** File descriptor of the misc device through which the ring is mapped. */
+    int fd;
+    /** The mapping; starts with the header. */
+    void *mem;
+    size_t mmap_len;
+    struct gnl_foobar_xmpl_ring_hdr *hdr;
+    __u32 entries;
+    __u32 slot_size;
+    char *sq;
+    char *cq;
+    /** Next SQ index that is filled; published by `gnl_ring_publish()`. */
+    __u32 sq_tail;
+    /** Next CQ index that is consumed; published by `gnl_ring_cq_advance()`. */
+    __u32 cq_head;
+};
+
+/**
+ * Statistics of a ring (`GNL_FOOBAR_XMPL_C_RING_STATS`).
+ */
+struct gnl_ring_stats {
+    __u64 records;
+    __u64 bytes;
+    __u64 doorbells;
+};
+
+/**
+ * Creates a ring with `entries` slots (power of two) of `slot_size` bytes (multiple of 64) per queue
+ * and maps it. The ring belongs to the socket of `client`; all other calls must use the same client,
+ * and closing it destroys the ring.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_ring_create(struct gnl_client *client, struct gnl_ring *ring, __u32 entries, __u32 slot_size);
+
+/**
+ * Unmaps and destroys the ring.
+ */
+void gnl_ring_destroy(struct gnl_client *client, struct gnl_ring *ring);
+
+/**
+ * Max. payload of a record in the ring.
+ */
+static inline size_t gnl_ring_max_len(const struct gnl_ring *ring) {
+    return ring->slot_size - sizeof(struct gnl_foobar_xmpl_ring_rec);
+}
+
+/**
+ * Copies a record into the next free slot of the submission queue. The kernel doesn't see it
+ * before `gnl_ring_publish()`.
+ *
+ * @return < 0 if the submission queue is full or `len` exceeds `gnl_ring_max_len()`, or 0 on success.
+ */
+int gnl_ring_push(struct gnl_ring *ring, __u64 user_data, const void *data, __u32 len);
+
+/**
+ * Makes all pushed records visible to the kernel.
+ */
+void gnl_ring_publish(struct gnl_ring *ring);
+
+/**
+ * Publishes the pushed records and tells the kernel to process them.
+ *
+ * @return < 0 on failure or the number of completions that the kernel posted.
+ */
+int gnl_ring_doorbell(struct gnl_client *client, struct gnl_ring *ring);
+
+/**
+ * Returns the `i`-th unconsumed completion or NULL if there are at most `i` of them.
+ */
+const struct gnl_foobar_xmpl_ring_rec *gnl_ring_peek_cqe(const struct gnl_ring *ring, __u32 i);
+
+/**
+ * Frees the oldest `n` completions, i.e. their slots can be reused by the kernel.
+ */
+void gnl_ring_cq_advance(struct gnl_ring *ring, __u32 n);
+
+/**
+ * Queries the statistics of the ring.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_ring_get_stats(struct gnl_client *client, const struct gnl_ring *ring, struct gnl_ring_stats *stats);
@@ -0,0 +1,340 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-submit.h". */
+
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "gnl-submit.h"
+
+#define LOG_PREFIX "[gnl-submit] "
+
+/** Receive buffer; the kernel may put many replies into one datagram. */
+#define RECV_BUF_LEN (64 * 1024)
+
+static void futex_wait(int *addr, int val) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static void futex_wake(int *addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static __u64 monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/**
+ * Spins for up to the busy-poll budget of the socket until `*done` is set, so that a producer
+ * whose reply arrives in time isn't put to sleep.
+ */
+static void wait_spin(struct gnl_submit_queue *q, const int *done) {
+    __u64 start = monotonic_ns(), now = start;
+    unsigned int i;
+
+    for (i = 1; now - start < q->client.busy_poll_ns; i++) {
+        if (__atomic_load_n(done, __ATOMIC_ACQUIRE)) {
+            __atomic_add_fetch(&q->stats.wait_spin_hits, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        cpu_relax();
+        // reading the clock costs more than checking the flag
+        if (i % 64 == 0) {
+            now = monotonic_ns();
+        }
+    }
+    __atomic_add_fetch(&q->stats.wait_spin_misses, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Hands the result to the producer of `req`. `req` must not be accessed afterwards, as the
+ * producer may already have returned (a late wakeup of a reused address is harmless).
+ */
+static void complete_req(struct gnl_submit_req *req, const struct nlmsghdr *reply, ssize_t error) {
+    if (reply == NULL) {
+        req->result = error;
+    } else if (reply->nlmsg_len > req->resp_len) {
+        req->result = -EMSGSIZE;
+    } else {
+        memcpy(req->resp, reply, reply->nlmsg_len);
+        req->result = reply->nlmsg_len;
+    }
+    __atomic_store_n(&req->done, 1, __ATOMIC_RELEASE);
+    futex_wake(&req->done);
+}
+
+/**
+ * Sends the coalesced requests with the sequence numbers [`first_seq`, `end_seq`) in `buf`.
+ * Fails them if the datagram can't be sent.
+ */
+static void flush_batch(struct gnl_submit_queue *q, char *buf, size_t *len, __u32 first_seq, __u32 end_seq) {
+    __u32 seq;
+
+    if (*len == 0) {
+        return;
+    }
+    if (gnl_client_send_raw(&q->client, buf, *len) < 0) {
+        // no replies will come; only the writer and (for sent requests) the receiver clear slots
+        for (seq = first_seq; seq != end_seq; seq++) {
+            struct gnl_submit_req *req =
+                    __atomic_exchange_n(&q->inflight[seq % GNL_SUBMIT_MAX_INFLIGHT], NULL, __ATOMIC_ACQ_REL);
+            if (req != NULL) {
+                complete_req(req, NULL, -EIO);
+            }
+        }
+    }
+    q->stats.datagrams++;
+    q->stats.requests += end_seq - first_seq;
+    *len = 0;
+}
+
+/**
+ * Registers and sends all requests of `req` (oldest first) in as few datagrams as possible.
+ */
+static void send_requests(struct gnl_submit_queue *q, char *buf, struct gnl_submit_req *req) {
+    __u32 first_seq = q->client.seq;
+    size_t len = 0;
+
+    for (; req != NULL; req = req->next) {
+        struct nlmsghdr *nlh = req->nlh;
+        struct gnl_submit_req **slot;
+        size_t msg_len = NLMSG_ALIGN(nlh->nlmsg_len);
+
+        if (msg_len > GNL_SUBMIT_BATCH_LEN) {
+            complete_req(req, NULL, -EMSGSIZE);
+            continue;
+        }
+        if (len + msg_len > GNL_SUBMIT_BATCH_LEN) {
+            flush_batch(q, buf, &len, first_seq, q->client.seq);
+            first_seq = q->client.seq;
+        }
+        slot = &q->inflight[q->client.seq % GNL_SUBMIT_MAX_INFLIGHT];
+        if (__atomic_load_n(slot, __ATOMIC_ACQUIRE) != NULL) {
+            // more than GNL_SUBMIT_MAX_INFLIGHT requests in flight; wait for the oldest one
+            flush_batch(q, buf, &len, first_seq, q->client.seq);
+            first_seq = q->client.seq;
+            while (__atomic_load_n(slot, __ATOMIC_ACQUIRE) != NULL) {
+                sched_yield();
+            }
+        }
+        nlh->nlmsg_seq = q->client.seq++;
+        nlh->nlmsg_pid = 0;
+        // the request must be findable before the kernel can reply
+        __atomic_store_n(slot, req, __ATOMIC_RELEASE);
+        memcpy(buf + len, nlh, nlh->nlmsg_len);
+        len += msg_len;
+    }
+    flush_batch(q, buf, &len, first_seq, q->client.seq);
+}
+
+static void *writer_thread(void *arg) {
+    struct gnl_submit_queue *q = arg;
+    char *buf = malloc(GNL_SUBMIT_BATCH_LEN);
+
+    if (buf == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        abort();
+    }
+    for (;;) {
+        struct gnl_submit_req *stack = __atomic_exchange_n(&q->head, NULL, __ATOMIC_ACQUIRE);
+        struct gnl_submit_req *fifo = NULL;
+
+        if (stack == NULL) {
+            if (__atomic_load_n(&q->stop, __ATOMIC_SEQ_CST)) {
+                break;
+            }
+            // producers check `writer_idle` after their push; recheck the queue after setting it
+            __atomic_store_n(&q->writer_idle, 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&q->head, __ATOMIC_SEQ_CST) == NULL && !__atomic_load_n(&q->stop, __ATOMIC_SEQ_CST)) {
+                futex_wait(&q->writer_idle, 1);
+            }
+            __atomic_store_n(&q->writer_idle, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        // the stack is newest first
+        while (stack != NULL) {
+            struct gnl_submit_req *next = stack->next;
+            stack->next = fifo;
+            fifo = stack;
+            stack = next;
+        }
+        send_requests(q, buf, fifo);
+    }
+    free(buf);
+    return NULL;
+}
+
+/**
+ * Maps a reply to the sequence number of its request.
+ *
+ * @return < 0 if the message isn't a reply to a request or 0 on success.
+ */
+static int reply_req_seq(const struct nlmsghdr *nlh, __u32 *seq) {
+    const struct nlmsgerr *err = NLMSG_DATA(nlh);
+
+    if (nlh->nlmsg_type == NLMSG_ERROR) {
+        // the ACK of the NOOP of `gnl_submit_close()` belongs to no request
+        if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*err)) || err->msg.nlmsg_type < NLMSG_MIN_TYPE) {
+            return -1;
+        }
+        *seq = err->msg.nlmsg_seq;
+        return 0;
+    }
+    if (nlh->nlmsg_type < NLMSG_MIN_TYPE) {
+        return -1;
+    }
+    // see `genlmsg_put()` in the kernel module
+    *seq = nlh->nlmsg_seq - 1;
+    return 0;
+}
+
+/**
+ * Fails all requests in flight, e.g. after replies were lost (ENOBUFS).
+ */
+static void fail_inflight(struct gnl_submit_queue *q, int error) {
+    int i;
+
+    for (i = 0; i < GNL_SUBMIT_MAX_INFLIGHT; i++) {
+        struct gnl_submit_req *req = __atomic_exchange_n(&q->inflight[i], NULL, __ATOMIC_ACQ_REL);
+        if (req != NULL) {
+            complete_req(req, NULL, error);
+        }
+    }
+}
+
+static void *receiver_thread(void *arg) {
+    struct gnl_submit_queue *q = arg;
+    char *buf = malloc(RECV_BUF_LEN);
+
+    if (buf == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        abort();
+    }
+    while (!__atomic_load_n(&q->stop, __ATOMIC_ACQUIRE)) {
+        struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+        ssize_t len = gnl_client_recv(&q->client, buf, RECV_BUF_LEN);
+
+        q->stats.recvs++;
+        if (len < 0) {
+            fail_inflight(q, -errno);
+            continue;
+        }
+        for (; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            struct gnl_submit_req **slot, *req;
+            __u32 seq;
+
+            if (reply_req_seq(nlh, &seq) < 0) {
+                continue;
+            }
+            slot = &q->inflight[seq % GNL_SUBMIT_MAX_INFLIGHT];
+            req = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+            if (req == NULL || req->nlh->nlmsg_seq != seq) {
+                fprintf(stderr, LOG_PREFIX "dropping reply for unknown request %u\n", seq);
+                continue;
+            }
+            __atomic_store_n(slot, NULL, __ATOMIC_RELEASE);
+            complete_req(req, nlh, 0);
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+static void stop_writer(struct gnl_submit_queue *q) {
+    __atomic_store_n(&q->stop, 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&q->writer_idle, 0, __ATOMIC_SEQ_CST);
+    futex_wake(&q->writer_idle);
+    pthread_join(q->writer, NULL);
+}
+
+int gnl_submit_open(struct gnl_submit_queue *q, __u64 busy_poll_ns) {
+    memset(q, 0, sizeof(*q));
+    if (gnl_client_open(&q->client) < 0) {
+        return -1;
+    }
+    gnl_client_set_busy_poll(&q->client, busy_poll_ns);
+    if (pthread_create(&q->writer, NULL, writer_thread, q) != 0) {
+        fprintf(stderr, LOG_PREFIX "can't start the writer thread\n");
+        gnl_client_close(&q->client);
+        return -1;
+    }
+    if (pthread_create(&q->receiver, NULL, receiver_thread, q) != 0) {
+        fprintf(stderr, LOG_PREFIX "can't start the receiver thread\n");
+        stop_writer(q);
+        gnl_client_close(&q->client);
+        return -1;
+    }
+    return 0;
+}
+
+void gnl_submit_close(struct gnl_submit_queue *q) {
+    struct nlmsghdr noop = {
+            .nlmsg_len = NLMSG_HDRLEN,
+            .nlmsg_type = NLMSG_NOOP,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK,
+    };
+
+    stop_writer(q);
+    // The receiver blocks in recv(); the kernel ACKs the NOOP, which wakes it up.
+    // The writer has stopped, hence the socket is ours.
+    if (gnl_client_send(&q->client, &noop) == 0) {
+        pthread_join(q->receiver, NULL);
+    } else {
+        pthread_cancel(q->receiver);
+        pthread_join(q->receiver, NULL);
+    }
+    gnl_client_close(&q->client);
+}
+
+ssize_t gnl_submit(struct gnl_submit_queue *q, struct nlmsghdr *nlh, void *resp, size_t resp_len) {
+    struct gnl_submit_req req = {.nlh = nlh, .resp = resp, .resp_len = resp_len};
+
+    req.next = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&q->head, &req.next, &req, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+    }
+    if (__atomic_load_n(&q->writer_idle, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&q->writer_idle, 0, __ATOMIC_SEQ_CST)) {
+        futex_wake(&q->writer_idle);
+    }
+    if (q->client.busy_poll_ns > 0) {
+        wait_spin(q, &req.done);
+    }
+    while (!__atomic_load_n(&req.done, __ATOMIC_ACQUIRE)) {
+        futex_wait(&req.done, 0);
+    }
+    return req.result;
+}
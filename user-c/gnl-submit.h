@@ -0,0 +1,112 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Submission queue that lets many threads share one Netlink socket.
+ *
+ * Producers push their request onto a lock-free MPSC queue (an intrusive stack that the writer
+ * takes over as a whole with a single atomic exchange) and wait for the reply. A writer thread
+ * assigns sequence numbers and coalesces all queued requests into as few datagrams as possible,
+ * i.e. one sendto() for many requests. A receiver thread routes each reply by its sequence number
+ * to the waiting producer. Hence the number of syscalls per request drops with the number of
+ * concurrent producers, while each producer still sees a simple blocking call.
+ *
+ * Only requests with exactly one reply message are supported (e.g. echo, ping or errors); dumps
+ * (`NLM_F_DUMP`) need a socket of their own. The kernel module replies with the sequence number of
+ * the request + 1, while NLMSG_ERROR replies carry the header of the request; both are mapped back.
+ */
+
+#include <pthread.h>
+
+#include "gnl-client.h"
+
+/** Max. number of requests in flight (power of two). Slots are indexed by the sequence number. */
+#define GNL_SUBMIT_MAX_INFLIGHT 1024
+/** Max. length of a coalesced datagram. */
+#define GNL_SUBMIT_BATCH_LEN (32 * 1024)
+
+/**
+ * A request of a producer. Lives on the stack of the producer while `gnl_submit()` waits.
+ */
+struct gnl_submit_req {
+    /** Next older request in the queue. */
+    struct gnl_submit_req *next;
+    struct nlmsghdr *nlh;
+    void *resp;
+    size_t resp_len;
+    /** Length of the reply or < 0 (negative errno). */
+    ssize_t result;
+    /** Set to 1 when `result` is valid; futex word. */
+    int done;
+};
+
+/** Counters of the writer and the receiver. Read them after `gnl_submit_close()`. */
+struct gnl_submit_stats {
+    /** Number of sent requests. */
+    unsigned long requests;
+    /** Number of sendto() calls. */
+    unsigned long datagrams;
+    /** Number of recv() calls. */
+    unsigned long recvs;
+    /** Producers whose reply arrived while they were spinning (busy polling only). */
+    unsigned long wait_spin_hits;
+    /** Producers that exhausted the spin budget and went to sleep (busy polling only). */
+    unsigned long wait_spin_misses;
+};
+
+struct gnl_submit_queue {
+    struct gnl_client client;
+    /** Newest queued request; producers push here. */
+    struct gnl_submit_req *head;
+    /** 1 while the writer sleeps on it (futex word). */
+    int writer_idle;
+    int stop;
+    /** In-flight requests; written by the writer, cleared by the receiver. */
+    struct gnl_submit_req *inflight[GNL_SUBMIT_MAX_INFLIGHT];
+    pthread_t writer;
+    pthread_t receiver;
+    struct gnl_submit_stats stats;
+};
+
+/**
+ * Opens the socket (see `gnl_client_open()`) and starts the writer and the receiver thread.
+ * With `busy_poll_ns` > 0, the receiver busy polls the socket (see `gnl_client_set_busy_poll()`;
+ * counters in `q->client.busy_poll`) and producers spin for up to the same budget before they
+ * sleep until their reply arrives.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_submit_open(struct gnl_submit_queue *q, __u64 busy_poll_ns);
+
+/**
+ * Stops both threads and closes the socket. No request may be pending.
+ */
+void gnl_submit_close(struct gnl_submit_queue *q);
+
+/**
+ * Sends the request `nlh` via the queue and waits for its reply, which is copied into `resp`.
+ * The sequence number and port id of `nlh` are overwritten. Thread-safe.
+ *
+ * @return the length of the reply message, -EMSGSIZE if `resp_len` is too small or another
+ *         negative errno if the request couldn't be sent or the reply was lost.
+ */
+ssize_t gnl_submit(struct gnl_submit_queue *q, struct nlmsghdr *nlh, void *resp, size_t resp_len);
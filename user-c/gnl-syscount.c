@@ -0,0 +1,606 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Counts the system calls of a client (any program, no changes needed) with ptrace and attributes
+ * them to the Generic Netlink operations of the client. Compares the counts with a budget file and
+ * fails if the client needs more system calls than recorded, see "syscall-budget.sh".
+ *
+ * The attribution follows the Netlink traffic of the client:
+ * - "start": everything before the first request, i.e. loading the program, initializing the runtime
+ *   and setting up the socket.
+ * - one entry per kind of request, named after the command (e.g. "ctrl-getfamily", "echo-msg",
+ *   "echo-msg-dump"): from sending the request up to the last receive before the next request.
+ *   As the family is resolved at this point, the entry of a data request is its warm cost.
+ * - "other": everything between requests and after the last one (printing, cleanup, exit).
+ * - "total": all system calls, the cold start of a client that does a single request.
+ *
+ * Budget file: one budget per line, "<client> <entry> <max system calls> [per record]". For the
+ * entries of requests the maximum applies to each single request; "per record" allows additional
+ * system calls for each record of a dump (a fraction, as a receive carries many records). A client
+ * that doesn't do a budgeted request fails, too.
+ * Child processes of the client and its threads are counted as well.
+ *
+ * Usage: ./gnl-syscount [-b <budget file>] [-n <client>] [-r] -- <program> [args ...]
+ *        -r prints the counts of the run as budget lines instead of checking them. For dumps, the
+ *           receives that carried records become the per record part, everything else the maximum.
+ *
+ * Like strace, the counts go to stderr; stdout belongs to the client.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <libgen.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ptrace.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+
+#include "gnl_foobar_xmpl_prop.h"
+
+#define LOG_PREFIX "[gnl-syscount] "
+
+/** Upper bound of the entries (kinds of requests plus "start" and "other"). */
+#define MAX_ENTRIES 64
+/** Upper bound of the threads and processes of a client that are traced at the same time. */
+#define MAX_TASKS 64
+/** Upper bound of the file descriptors whose Generic Netlink sockets are tracked. */
+#define MAX_FDS 1024
+/** Number of bytes of a received datagram in which records are counted. */
+#define PEEK_LEN (64 * 1024)
+
+static const char *const cmd_names[GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN] = {
+        [GNL_FOOBAR_XMPL_C_ECHO_MSG] = "echo-msg",
+        [GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR] = "reply-with-nlmsg-err",
+        [GNL_FOOBAR_XMPL_C_PING] = "ping",
+        [GNL_FOOBAR_XMPL_C_XFER_BEGIN] = "xfer-begin",
+        [GNL_FOOBAR_XMPL_C_XFER_CHUNK] = "xfer-chunk",
+        [GNL_FOOBAR_XMPL_C_XFER_COMMIT] = "xfer-commit",
+        [GNL_FOOBAR_XMPL_C_XFER_GET] = "xfer-get",
+        [GNL_FOOBAR_XMPL_C_XFER_ABORT] = "xfer-abort",
+        [GNL_FOOBAR_XMPL_C_RING_CREATE] = "ring-create",
+        [GNL_FOOBAR_XMPL_C_RING_DOORBELL] = "ring-doorbell",
+        [GNL_FOOBAR_XMPL_C_RING_STATS] = "ring-stats",
+        [GNL_FOOBAR_XMPL_C_RING_DESTROY] = "ring-destroy",
+        [GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE] = "event-subscribe",
+        [GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE] = "event-unsubscribe",
+        [GNL_FOOBAR_XMPL_C_EVENT_EMIT] = "event-emit",
+        [GNL_FOOBAR_XMPL_C_CHECKSUM] = "checksum",
+        [GNL_FOOBAR_XMPL_C_GET_CONFIG] = "get-config",
+        [GNL_FOOBAR_XMPL_C_SET_CONFIG] = "set-config",
+        [GNL_FOOBAR_XMPL_C_GET_GENERATION] = "get-generation",
+        [GNL_FOOBAR_XMPL_C_PORT_STATS] = "port-stats",
+};
+
+/** System calls attributed to one entry. */
+struct syscount_entry {
+    char name[48];
+    /** Number of requests of this kind; 0 for "start" and "other". */
+    long requests;
+    long syscalls;
+    /** Maximum of a single request. */
+    long max;
+    /** Records received by the request with the most system calls. */
+    long max_records;
+    /** Records received by all requests of this kind. */
+    long records;
+    /** Maximum of a single request without the receives that carried records. */
+    long max_base;
+    /** Maximum of the receives that carried records per record of a single request. */
+    double max_per_record;
+    /** Budget of this entry, if any. */
+    long budget;
+    double budget_per_record;
+    int has_budget;
+    /** Set if a single request exceeded the budget. */
+    int exceeded;
+};
+
+/** A traced thread or process; the arguments are needed when the system call returns. */
+struct syscount_task {
+    pid_t pid;
+    long nr;
+    unsigned long long args[6];
+};
+
+static struct syscount_entry entries[MAX_ENTRIES];
+static int entries_len;
+static struct syscount_task tasks[MAX_TASKS];
+static unsigned char genl_fds[MAX_FDS];
+
+/** Entry of the request in flight or -1 before the first request. */
+static int current = -1;
+/** System calls since the last receive, not yet attributed. */
+static long pending;
+/** System calls and records of the request in flight. */
+static long current_syscalls;
+static long current_records;
+/** Receives of the request in flight that carried records. */
+static long current_record_recvs;
+static long total;
+
+static struct syscount_entry *entry_get(const char *name) {
+    int i;
+
+    for (i = 0; i < entries_len; i++) {
+        if (strcmp(entries[i].name, name) == 0) {
+            return &entries[i];
+        }
+    }
+    if (entries_len == MAX_ENTRIES) {
+        // all further kinds of requests share the last entry
+        return &entries[MAX_ENTRIES - 1];
+    }
+    snprintf(entries[entries_len].name, sizeof(entries[entries_len].name), "%s", name);
+    return &entries[entries_len++];
+}
+
+static struct syscount_task *task_get(pid_t pid) {
+    int i;
+
+    for (i = 0; i < MAX_TASKS; i++) {
+        if (tasks[i].pid == pid) {
+            return &tasks[i];
+        }
+    }
+    for (i = 0; i < MAX_TASKS; i++) {
+        if (tasks[i].pid == 0) {
+            tasks[i].pid = pid;
+            tasks[i].nr = -1;
+            return &tasks[i];
+        }
+    }
+    return NULL;
+}
+
+static void task_put(pid_t pid) {
+    struct syscount_task *task = task_get(pid);
+
+    if (task != NULL) {
+        task->pid = 0;
+    }
+}
+
+static int genl_fd(unsigned long long fd) {
+    return fd < MAX_FDS && genl_fds[fd];
+}
+
+/**
+ * Reads `len` bytes at `addr` of the tracee.
+ *
+ * @return < 0 on failure or the number of bytes read.
+ */
+static ssize_t peek(pid_t pid, unsigned long long addr, void *buf, size_t len) {
+    struct iovec local = {.iov_base = buf, .iov_len = len};
+    struct iovec remote = {.iov_base = (void *) (unsigned long) addr, .iov_len = len};
+
+    return process_vm_readv(pid, &local, 1, &remote, 1, 0);
+}
+
+/**
+ * Finds the buffer of a send or receive system call: the buffer itself or the first I/O vector of
+ * the message header.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int syscall_buf(const struct syscount_task *task, unsigned long long *addr, size_t *len) {
+    struct msghdr msg;
+    struct iovec iov;
+
+    switch (task->nr) {
+        case SYS_sendto:
+        case SYS_recvfrom:
+        case SYS_write:
+        case SYS_read:
+            *addr = task->args[1];
+            *len = task->args[2];
+            return 0;
+        case SYS_sendmsg:
+        case SYS_recvmsg:
+        case SYS_sendmmsg:
+            // the message header is the first member of struct mmsghdr
+            if (peek(task->pid, task->args[1], &msg, sizeof(msg)) != sizeof(msg) || msg.msg_iovlen == 0 ||
+                peek(task->pid, (unsigned long) msg.msg_iov, &iov, sizeof(iov)) != sizeof(iov)) {
+                return -1;
+            }
+            *addr = (unsigned long) iov.iov_base;
+            *len = iov.iov_len;
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+static int send_syscall(long nr) {
+    return nr == SYS_sendto || nr == SYS_sendmsg || nr == SYS_sendmmsg || nr == SYS_write;
+}
+
+static int recv_syscall(long nr) {
+    return nr == SYS_recvfrom || nr == SYS_recvmsg || nr == SYS_recvmmsg || nr == SYS_read;
+}
+
+/** Names a request after its command, e.g. "echo-msg-dump". */
+static void request_name(pid_t pid, unsigned long long addr, char *name, size_t len) {
+    struct {
+        struct nlmsghdr n;
+        struct genlmsghdr g;
+    } hdr;
+    char cmd[32];
+
+    if (peek(pid, addr, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        snprintf(name, len, "unknown");
+        return;
+    }
+    if (hdr.n.nlmsg_type == GENL_ID_CTRL) {
+        snprintf(cmd, sizeof(cmd), hdr.g.cmd == CTRL_CMD_GETFAMILY ? "ctrl-getfamily" : "ctrl-cmd-%u", hdr.g.cmd);
+    } else if (hdr.g.cmd < GNL_FOOBAR_XMPL_COMMAND_ENUM_LEN && cmd_names[hdr.g.cmd] != NULL) {
+        snprintf(cmd, sizeof(cmd), "%s", cmd_names[hdr.g.cmd]);
+    } else {
+        snprintf(cmd, sizeof(cmd), "cmd-%u", hdr.g.cmd);
+    }
+    snprintf(name, len, "%s%s", cmd, (hdr.n.nlmsg_flags & NLM_F_DUMP) == NLM_F_DUMP ? "-dump" : "");
+}
+
+/** Counts the records (messages of the family) in a received datagram. */
+static long count_records(pid_t pid, unsigned long long addr, size_t len) {
+    static char buf[PEEK_LEN];
+    struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+    ssize_t rc;
+    long records = 0;
+    int rest;
+
+    rc = peek(pid, addr, buf, len < sizeof(buf) ? len : sizeof(buf));
+    if (rc <= 0) {
+        return 0;
+    }
+    for (rest = (int) rc; NLMSG_OK(nlh, rest); nlh = NLMSG_NEXT(nlh, rest)) {
+        if (nlh->nlmsg_type >= NLMSG_MIN_TYPE && nlh->nlmsg_type != GENL_ID_CTRL) {
+            records++;
+        }
+    }
+    return records;
+}
+
+/** Attributes the pending system calls outside of requests to "start" or "other". */
+static void flush_pending(void) {
+    struct syscount_entry *e = entry_get(current < 0 ? "start" : "other");
+
+    e->syscalls += pending;
+    e->max = e->syscalls;
+    pending = 0;
+}
+
+/** Completes the request in flight. */
+static void finish_request(void) {
+    struct syscount_entry *e;
+
+    if (current < 0) {
+        return;
+    }
+    e = &entries[current];
+    e->requests++;
+    e->syscalls += current_syscalls;
+    e->records += current_records;
+    if (current_syscalls > e->max) {
+        e->max = current_syscalls;
+        e->max_records = current_records;
+    }
+    if (current_syscalls - current_record_recvs > e->max_base) {
+        e->max_base = current_syscalls - current_record_recvs;
+    }
+    if (current_records > 0 && (double) current_record_recvs / current_records > e->max_per_record) {
+        e->max_per_record = (double) current_record_recvs / current_records;
+    }
+    if (e->has_budget && current_syscalls > e->budget + e->budget_per_record * current_records) {
+        e->exceeded = 1;
+    }
+    current_syscalls = 0;
+    current_records = 0;
+    current_record_recvs = 0;
+}
+
+static void on_syscall_entry(struct syscount_task *task, const struct __ptrace_syscall_info *info) {
+    char name[64];
+    unsigned long long addr;
+    size_t len;
+
+    task->nr = (long) info->entry.nr;
+    memcpy(task->args, info->entry.args, sizeof(task->args));
+    total++;
+
+    if (send_syscall(task->nr) && genl_fd(task->args[0]) && syscall_buf(task, &addr, &len) == 0 &&
+        len >= NLMSG_HDRLEN) {
+        // a new request starts with this system call
+        finish_request();
+        flush_pending();
+        request_name(task->pid, addr, name, sizeof(name));
+        current = (int) (entry_get(name) - entries);
+    } else if (task->nr == SYS_close && task->args[0] < MAX_FDS) {
+        genl_fds[task->args[0]] = 0;
+    }
+    pending++;
+}
+
+static void on_syscall_exit(struct syscount_task *task, const struct __ptrace_syscall_info *info) {
+    unsigned long long addr;
+    size_t len;
+    long records;
+    int peeking;
+
+    if (task->nr == SYS_socket && !info->exit.is_error && task->args[0] == AF_NETLINK &&
+        task->args[2] == NETLINK_GENERIC && info->exit.rval < MAX_FDS) {
+        genl_fds[info->exit.rval] = 1;
+    } else if (recv_syscall(task->nr) && genl_fd(task->args[0]) && current >= 0) {
+        // the system calls so far belong to the request in flight
+        current_syscalls += pending;
+        pending = 0;
+        peeking = (task->nr == SYS_recvfrom && (task->args[3] & MSG_PEEK)) ||
+                  (task->nr == SYS_recvmsg && (task->args[2] & MSG_PEEK));
+        if (!info->exit.is_error && !peeking && task->nr != SYS_recvmmsg && syscall_buf(task, &addr, &len) == 0) {
+            records = count_records(task->pid, addr, (size_t) info->exit.rval);
+            current_records += records;
+            current_record_recvs += records > 0;
+        }
+    }
+    task->nr = -1;
+}
+
+/**
+ * Runs the client until it and all its children exit and counts their system calls.
+ *
+ * @return < 0 on failure or the exit status of the client.
+ */
+static int trace(char **argv) {
+    struct __ptrace_syscall_info info;
+    struct syscount_task *task;
+    int status, sig, exit_status = -1;
+    pid_t child, pid;
+
+    child = fork();
+    if (child < 0) {
+        perror(LOG_PREFIX "fork()");
+        return -1;
+    }
+    if (child == 0) {
+        ptrace(PTRACE_TRACEME, 0, NULL, NULL);
+        raise(SIGSTOP);
+        execvp(argv[0], argv);
+        perror(LOG_PREFIX "execvp()");
+        _exit(127);
+    }
+    if (waitpid(child, &status, 0) < 0 || !WIFSTOPPED(status)) {
+        perror(LOG_PREFIX "waitpid()");
+        return -1;
+    }
+    if (ptrace(PTRACE_SETOPTIONS, child, NULL,
+               PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACEEXEC | PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK |
+               PTRACE_O_TRACEVFORK | PTRACE_O_EXITKILL) < 0) {
+        perror(LOG_PREFIX "ptrace(PTRACE_SETOPTIONS)");
+        kill(child, SIGKILL);
+        return -1;
+    }
+    task_get(child);
+    ptrace(PTRACE_SYSCALL, child, NULL, NULL);
+
+    while ((pid = waitpid(-1, &status, __WALL)) > 0) {
+        if (WIFEXITED(status) || WIFSIGNALED(status)) {
+            if (pid == child) {
+                exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            }
+            task_put(pid);
+            continue;
+        }
+        sig = WSTOPSIG(status);
+        task = task_get(pid);
+        if (sig == (SIGTRAP | 0x80)) {
+            sig = 0;
+            if (task != NULL && ptrace(PTRACE_GET_SYSCALL_INFO, pid, sizeof(info), &info) > 0) {
+                if (info.op == PTRACE_SYSCALL_INFO_ENTRY) {
+                    on_syscall_entry(task, &info);
+                } else if (info.op == PTRACE_SYSCALL_INFO_EXIT && task->nr >= 0) {
+                    on_syscall_exit(task, &info);
+                }
+            }
+        } else if (status >> 16 != 0) {
+            // fork, clone or exec event; new tasks are attached automatically
+            sig = 0;
+        } else if (sig == SIGSTOP && task != NULL && task->nr == -1) {
+            // initial stop of a new task
+            sig = 0;
+        }
+        ptrace(PTRACE_SYSCALL, pid, NULL, sig);
+    }
+    if (errno != ECHILD) {
+        perror(LOG_PREFIX "waitpid()");
+        return -1;
+    }
+    finish_request();
+    flush_pending();
+    return exit_status;
+}
+
+/**
+ * Loads the budgets of `client` from `path`.
+ *
+ * @return < 0 on failure or the number of budgets.
+ */
+static int load_budget(const char *path, const char *client) {
+    char line[256], name[64], entry[48];
+    long max;
+    double per_record;
+    int n, count = 0, lineno = 0;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL) {
+        perror(LOG_PREFIX "fopen()");
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        struct syscount_entry *e;
+
+        lineno++;
+        if (line[strspn(line, " \t")] == '#' || line[strspn(line, " \t\n")] == '\0') {
+            continue;
+        }
+        per_record = 0;
+        n = sscanf(line, "%63s %47s %ld %lf", name, entry, &max, &per_record);
+        if (n < 3) {
+            fprintf(stderr, LOG_PREFIX "%s:%d: expected \"<client> <entry> <max> [per record]\"\n", path, lineno);
+            fclose(f);
+            return -1;
+        }
+        if (strcmp(name, client) != 0) {
+            continue;
+        }
+        e = entry_get(entry);
+        e->budget = max;
+        e->budget_per_record = per_record;
+        e->has_budget = 1;
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+/**
+ * Prints the counts and compares them with the budgets.
+ *
+ * @return the number of budgets that are exceeded or not met.
+ */
+static int report(const char *client) {
+    struct syscount_entry *e;
+    int i, failed = 0;
+
+    fprintf(stderr, LOG_PREFIX "%s: %ld system calls\n", client, total);
+    fprintf(stderr, "| entry                  | requests | syscalls | max/request | records | budget     |\n");
+    fprintf(stderr, "|------------------------|----------|----------|-------------|---------|------------|\n");
+    e = entry_get("total");
+    e->max = e->syscalls = total;
+    for (i = 0; i < entries_len; i++) {
+        char budget[32] = "-";
+        const char *verdict = "";
+
+        e = &entries[i];
+        if (e->has_budget) {
+            if (e->budget_per_record > 0) {
+                snprintf(budget, sizeof(budget), "%ld+%.3f/rec", e->budget, e->budget_per_record);
+            } else {
+                snprintf(budget, sizeof(budget), "%ld", e->budget);
+            }
+            if (e->requests == 0 && e->syscalls == 0) {
+                verdict = "  MISSING";
+                failed++;
+            } else if (e->exceeded || (e->requests == 0 && e->max > e->budget)) {
+                verdict = "  EXCEEDED";
+                failed++;
+            }
+        }
+        fprintf(stderr, "| %-22s | %8ld | %8ld | %11ld | %7ld | %-10s |%s\n", e->name, e->requests, e->syscalls,
+                e->max, e->records, budget, verdict);
+    }
+    return failed;
+}
+
+/**
+ * Prints the counts as budget lines for `client`. A dump gets a budget of the form "base + per record":
+ * the receives that carried records scale with the records, everything else (send, final receive of
+ * NLMSG_DONE, polls) doesn't. The per record part is rounded up to the precision that is printed.
+ */
+static void record(const char *client) {
+    const struct syscount_entry *e;
+    size_t len;
+    int i;
+
+    entry_get("total")->max = entry_get("total")->syscalls = total;
+    for (i = 0; i < entries_len; i++) {
+        e = &entries[i];
+        len = strlen(e->name);
+        if (e->requests == 0 && e->syscalls == 0 && strcmp(e->name, "total") != 0) {
+            continue;
+        }
+        if (len > 5 && strcmp(e->name + len - 5, "-dump") == 0 && e->records > 0) {
+            fprintf(stderr, "%-16s %-22s %-6ld %.3f\n", client, e->name, e->max_base,
+                    ceil(e->max_per_record * 1000) / 1000);
+        } else {
+            fprintf(stderr, "%-16s %-22s %ld\n", client, e->name, e->max);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *budget_path = NULL, *client = NULL;
+    int opt, status, do_record = 0, failed;
+
+    while ((opt = getopt(argc, argv, "+b:n:r")) != -1) {
+        switch (opt) {
+            case 'b':
+                budget_path = optarg;
+                break;
+            case 'n':
+                client = optarg;
+                break;
+            case 'r':
+                do_record = 1;
+                break;
+            default:
+                optind = argc;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-b <budget file>] [-n <client>] [-r] -- <program> [args ...]\n", argv[0]);
+        return 2;
+    }
+    if (client == NULL) {
+        client = basename(argv[optind]);
+    }
+    if (budget_path != NULL && !do_record && load_budget(budget_path, client) <= 0) {
+        fprintf(stderr, LOG_PREFIX "no budget for %s in %s\n", client, budget_path);
+        return 2;
+    }
+
+    status = trace(&argv[optind]);
+    if (status < 0) {
+        return 2;
+    }
+    if (status != 0) {
+        // the counts of a failed run don't tell anything about the budget
+        fprintf(stderr, LOG_PREFIX "%s exited with status %d\n", client, status);
+        return 1;
+    }
+    if (do_record) {
+        record(client);
+        return 0;
+    }
+    failed = report(client);
+    if (failed > 0) {
+        fprintf(stderr, LOG_PREFIX "%s: %d budget(s) exceeded or not met\n", client, failed);
+        return 1;
+    }
+    return 0;
+}
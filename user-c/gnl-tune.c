@@ -0,0 +1,57 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Shows or changes the runtime tunables of the kernel module, e.g. while a benchmark runs in another
+ * terminal, to see the effect of a setting on live traffic without reloading the module:
+ *
+ *   $ ./gnl-tune                                   # show all tunables
+ *   $ sudo ./gnl-tune dump-runs=100 verbose=0      # change some of them at once
+ *
+ * Changing tunables requires CAP_NET_ADMIN. See "gnl-config.h" for the names.
+ *
+ * Usage: ./gnl-tune [<name>=<value> ...]
+ */
+
+#include <stdio.h>
+
+#include "gnl-client.h"
+#include "gnl-config.h"
+
+#define LOG_PREFIX "[gnl-tune] "
+
+int main(int argc, char **argv) {
+    struct gnl_client client;
+    struct gnl_foobar_xmpl_attrs config;
+    int rc;
+
+    if (gnl_client_open(&client) < 0) {
+        return 1;
+    }
+    if (argc > 1) {
+        rc = gnl_config_set(&client, argv + 1, argc - 1, &config);
+    } else {
+        rc = gnl_config_get(&client, &config);
+    }
+    if (rc == 0) {
+        gnl_config_print(stdout, "", &config);
+    }
+    gnl_client_close(&client);
+    return rc == 0 ? 0 : 1;
+}
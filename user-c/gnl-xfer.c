@@ -0,0 +1,195 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "gnl-xfer.h". */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gnl-xfer.h"
+#include "gnl_foobar_xmpl_codec.h"
+
+#define LOG_PREFIX "[gnl-xfer] "
+
+/** Room for the headers and attributes of a chunk in front of its payload. */
+#define CHUNK_HEADROOM 64
+/** Receive buffer; dump datagrams are at most 32 KiB. */
+#define RECV_BUF_LEN (64 * 1024)
+
+/**
+ * Receives the reply (data or NLMSG_ERROR) of a request into `buf`. Prints errors.
+ *
+ * @return < 0 on failure or on an error reply, or 0 on success.
+ */
+static int recv_reply(struct gnl_client *client, char *buf, size_t len) {
+    struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+    ssize_t rc = gnl_client_recv(client, buf, len);
+
+    if (rc < 0 || !NLMSG_OK(nlh, rc)) {
+        return -1;
+    }
+    if (nlh->nlmsg_type == NLMSG_ERROR && ((struct nlmsgerr *) NLMSG_DATA(nlh))->error != 0) {
+        gnl_msg_print_err(nlh, LOG_PREFIX);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Sends a request that only carries `GNL_FOOBAR_XMPL_A_XFER_ID` with `NLM_F_ACK` and waits for the ACK.
+ */
+static int xfer_id_request(struct gnl_client *client, __u8 cmd, __u32 id) {
+    char buf[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr *nlh = gnl_msg_init(buf, client->family_id, NLM_F_ACK, client->seq++, cmd);
+
+    gnl_foobar_xmpl_put_xfer_id(nlh, id);
+    if (gnl_client_send(client, nlh) < 0) {
+        return -1;
+    }
+    return recv_reply(client, buf, sizeof(buf));
+}
+
+int gnl_xfer_upload(struct gnl_client *client, const void *data, __u64 size, __u32 chunk_len, __u32 window,
+                    __u32 *id) {
+    char reply[256] __attribute__((aligned(NLMSG_ALIGNTO)));
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh;
+    char *req;
+    __u64 offset;
+    __u32 in_flight = 0;
+    int rc = -1;
+
+    if (chunk_len == 0 || chunk_len > GNL_XFER_MAX_CHUNK_LEN) {
+        fprintf(stderr, LOG_PREFIX "chunk length %u not in 1..%u\n", chunk_len, GNL_XFER_MAX_CHUNK_LEN);
+        return -1;
+    }
+    nlh = gnl_foobar_xmpl_xfer_begin_init(reply, client->family_id, 0, client->seq++);
+    gnl_foobar_xmpl_put_xfer_size(nlh, size);
+    if (gnl_client_send(client, nlh) < 0 || recv_reply(client, reply, sizeof(reply)) < 0) {
+        return -1;
+    }
+    if (gnl_foobar_xmpl_xfer_begin_reply_parse((struct nlmsghdr *) reply, &attrs) < 0 ||
+        !GNL_FOOBAR_XMPL_ATTR_PRESENT(&attrs, GNL_FOOBAR_XMPL_A_XFER_ID)) {
+        fprintf(stderr, LOG_PREFIX "invalid XFER_BEGIN reply\n");
+        return -1;
+    }
+    *id = attrs.xfer_id;
+    if (window == 0) {
+        window = attrs.xfer_window > 0 ? attrs.xfer_window : 1;
+    }
+
+    req = malloc(chunk_len + CHUNK_HEADROOM);
+    if (req == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        goto out_abort;
+    }
+    for (offset = 0; offset < size || in_flight > 0;) {
+        if (offset < size && in_flight < window) {
+            __u32 len = size - offset < chunk_len ? size - offset : chunk_len;
+
+            nlh = gnl_foobar_xmpl_xfer_chunk_init(req, client->family_id, NLM_F_ACK, client->seq++);
+            gnl_foobar_xmpl_put_xfer_id(nlh, *id);
+            gnl_foobar_xmpl_put_xfer_offset(nlh, offset);
+            gnl_foobar_xmpl_put_data(nlh, (const char *) data + offset, len);
+            if (gnl_client_send(client, nlh) < 0) {
+                goto out_free;
+            }
+            offset += len;
+            in_flight++;
+            continue;
+        }
+        // window full or everything sent: wait for the oldest ACK
+        in_flight--;
+        if (recv_reply(client, reply, sizeof(reply)) < 0) {
+            goto out_free;
+        }
+    }
+    rc = xfer_id_request(client, GNL_FOOBAR_XMPL_C_XFER_COMMIT, *id);
+
+out_free:
+    free(req);
+    // the replies of the chunks still in flight must not be mistaken for the ACK of the abort
+    for (; in_flight > 0; in_flight--) {
+        if (gnl_client_recv(client, reply, sizeof(reply)) < 0) {
+            break;
+        }
+    }
+out_abort:
+    if (rc < 0) {
+        // the object must not stay in the kernel
+        gnl_xfer_abort(client, *id);
+    }
+    return rc;
+}
+
+int gnl_xfer_download(struct gnl_client *client, __u32 id, void *buf, __u64 size) {
+    char *resp = malloc(RECV_BUF_LEN);
+    struct gnl_foobar_xmpl_attrs attrs;
+    struct nlmsghdr *nlh = (struct nlmsghdr *) resp;
+    __u64 received = 0;
+    int rc = -1;
+
+    if (resp == NULL) {
+        fprintf(stderr, LOG_PREFIX "out of memory\n");
+        return -1;
+    }
+    nlh = gnl_foobar_xmpl_xfer_get_init(resp, client->family_id, NLM_F_DUMP, client->seq++);
+    gnl_foobar_xmpl_put_xfer_id(nlh, id);
+    if (gnl_client_send(client, nlh) < 0) {
+        goto out;
+    }
+    for (;;) {
+        ssize_t len = gnl_client_recv(client, resp, RECV_BUF_LEN);
+
+        if (len < 0) {
+            goto out;
+        }
+        for (nlh = (struct nlmsghdr *) resp; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                rc = received == size ? 0 : -1;
+                if (rc < 0) {
+                    fprintf(stderr, LOG_PREFIX "download ended after %llu of %llu bytes\n",
+                            (unsigned long long) received, (unsigned long long) size);
+                }
+                goto out;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                gnl_msg_print_err(nlh, LOG_PREFIX);
+                goto out;
+            }
+            if (gnl_foobar_xmpl_xfer_get_reply_parse(nlh, &attrs) < 0 || attrs.xfer_offset != received ||
+                attrs.data_len > size - received) {
+                fprintf(stderr, LOG_PREFIX "invalid XFER_GET record at offset %llu\n", (unsigned long long) received);
+                goto out;
+            }
+            memcpy((char *) buf + received, attrs.data, attrs.data_len);
+            received += attrs.data_len;
+        }
+    }
+
+out:
+    free(resp);
+    return rc;
+}
+
+int gnl_xfer_abort(struct gnl_client *client, __u32 id) {
+    return xfer_id_request(client, GNL_FOOBAR_XMPL_C_XFER_ABORT, id);
+}
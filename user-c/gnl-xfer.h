@@ -0,0 +1,61 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Chunked transfers of objects that are larger than a Netlink message (`GNL_FOOBAR_XMPL_C_XFER_*`).
+ *
+ * Upload: `XFER_BEGIN` reserves the object in the kernel, then the object is sent as
+ * `XFER_CHUNK` requests with `NLM_F_ACK`. Up to `window` chunks are in flight before the client
+ * waits for the oldest ACK, hence the socket's receive buffer never overflows with ACKs and an
+ * error stops the upload after at most `window` chunks. `XFER_COMMIT` finishes it.
+ * Download: an `XFER_GET` dump; the kernel fills each datagram with as much of the object as fits.
+ */
+
+#include "gnl-client.h"
+
+/** Max. length of the payload of a chunk: the u16 `nla_len` of the attribute includes its header. */
+#define GNL_XFER_MAX_CHUNK_LEN (0xffff - NLA_HDRLEN)
+/** Default length of the payload of each uploaded chunk. */
+#define GNL_XFER_DEFAULT_CHUNK_LEN GNL_XFER_MAX_CHUNK_LEN
+
+/**
+ * Uploads and commits the object `data` of `size` bytes in chunks of `chunk_len` bytes
+ * (1..`GNL_XFER_MAX_CHUNK_LEN`). `window` overrides the window that the kernel advertises if it is > 0.
+ *
+ * @return < 0 on failure or 0 on success; `*id` is the id of the object.
+ */
+int gnl_xfer_upload(struct gnl_client *client, const void *data, __u64 size, __u32 chunk_len, __u32 window,
+                    __u32 *id);
+
+/**
+ * Downloads the committed object `id` of `size` bytes into `buf`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_xfer_download(struct gnl_client *client, __u32 id, void *buf, __u64 size);
+
+/**
+ * Deletes the object `id` in the kernel.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+int gnl_xfer_abort(struct gnl_client *client, __u32 id);
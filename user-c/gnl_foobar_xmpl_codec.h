@@ -0,0 +1,1356 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Specialized encoders and decoders for the messages of the "gnl_foobar_xmpl" family for userland C
+ * programs. Header only, no dependencies except the Linux UAPI headers.
+ *
+ * Encoding: `gnl_foobar_xmpl_<command>_init()` writes the Netlink and Generic Netlink header into a
+ * buffer, afterwards `gnl_foobar_xmpl_put_<attribute>()` appends typed attributes. The caller must
+ * ensure that the buffer is big enough. Payloads longer than `GNL_FOOBAR_XMPL_MAX_ATTR_LEN` are
+ * rejected (NULL) and leave the message unchanged.
+ * Decoding: `gnl_foobar_xmpl_<command>_reply_parse()` fills a struct with all attributes that the
+ * reply of the command can carry in one pass over the message; `gnl_foobar_xmpl_<notification>_parse()`
+ * the same for notifications of the kernel.
+ *
+ * This file is generated from "spec/gnl_foobar_xmpl.yaml" by "tools/gnl-gen.py". Do not edit it.
+ */
+
+#include <string.h>
+
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+
+#include "gnl_foobar_xmpl_prop.h"
+
+/** Version that is put into the Generic Netlink header of requests. */
+#define GNL_FOOBAR_XMPL_VERSION 1
+
+/** Tests if attribute `attr` was present in the parsed message. */
+#define GNL_FOOBAR_XMPL_ATTR_PRESENT(attrs, attr) ((((attrs)->present) >> (attr)) & 1)
+
+/** Max. payload of an attribute: the length including the header must fit into the u16 `nla_len`. */
+#define GNL_FOOBAR_XMPL_MAX_ATTR_LEN (0xffff - NLA_HDRLEN)
+
+static inline struct nlmsghdr *__gnl_foobar_xmpl_init(void *buf, __u16 family_id, __u16 flags, __u32 seq, __u8 cmd) {
+    struct nlmsghdr *nlh = buf;
+    struct genlmsghdr *gnlh = (struct genlmsghdr *) NLMSG_DATA(nlh);
+
+    nlh->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    nlh->nlmsg_type = family_id;
+    nlh->nlmsg_flags = NLM_F_REQUEST | flags;
+    nlh->nlmsg_seq = seq;
+    nlh->nlmsg_pid = 0;
+    gnlh->cmd = cmd;
+    gnlh->version = GNL_FOOBAR_XMPL_VERSION;
+    gnlh->reserved = 0;
+    return nlh;
+}
+
+static inline struct nlattr *__gnl_foobar_xmpl_put(struct nlmsghdr *nlh, __u16 type, const void *data, __u32 len) {
+    struct nlattr *na = (struct nlattr *) ((char *) nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+    if (len > GNL_FOOBAR_XMPL_MAX_ATTR_LEN) {
+        return NULL;
+    }
+    na->nla_type = type;
+    na->nla_len = NLA_HDRLEN + len;
+    if (len) {
+        memcpy((char *) na + NLA_HDRLEN, data, len);
+    }
+    nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NLA_ALIGN(na->nla_len);
+    return na;
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_ECHO_MSG` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_echo_msg_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_ECHO_MSG);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_reply_with_nlmsg_err_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_PING` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_ping_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_PING);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_XFER_BEGIN` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_xfer_begin_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_XFER_BEGIN);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_XFER_CHUNK` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_xfer_chunk_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_XFER_CHUNK);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_XFER_COMMIT` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_xfer_commit_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_XFER_COMMIT);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_XFER_GET` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_xfer_get_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_XFER_GET);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_XFER_ABORT` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_xfer_abort_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_XFER_ABORT);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_RING_CREATE` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_ring_create_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_RING_CREATE);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_RING_DOORBELL` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_ring_doorbell_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_RING_DOORBELL);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_RING_STATS` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_ring_stats_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_RING_STATS);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_RING_DESTROY` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_ring_destroy_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_RING_DESTROY);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_event_subscribe_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_event_unsubscribe_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_EVENT_EMIT` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_event_emit_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_EVENT_EMIT);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_CHECKSUM` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_checksum_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_CHECKSUM);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_GET_CONFIG` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_get_config_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_GET_CONFIG);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_SET_CONFIG` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_set_config_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_SET_CONFIG);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_GET_GENERATION` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_get_generation_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_GET_GENERATION);
+}
+
+/** Initializes a `GNL_FOOBAR_XMPL_C_PORT_STATS` request in `buf`. `NLM_F_REQUEST` is always set. */
+static inline struct nlmsghdr *gnl_foobar_xmpl_port_stats_init(void *buf, __u16 family_id, __u16 flags, __u32 seq) {
+    return __gnl_foobar_xmpl_init(buf, family_id, flags, seq, GNL_FOOBAR_XMPL_C_PORT_STATS);
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_MSG` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_msg(struct nlmsghdr *nlh, const char *value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_MSG, value, strlen(value) + 1);
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_DATA` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_data(struct nlmsghdr *nlh, const void *value, __u32 len) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_DATA, value, len);
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CLIENT_TS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_client_ts(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CLIENT_TS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_KERNEL_RX_TS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_kernel_rx_ts(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_KERNEL_RX_TS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_KERNEL_TX_TS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_kernel_tx_ts(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_KERNEL_TX_TS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_XFER_ID` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_xfer_id(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_XFER_ID, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_XFER_SIZE` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_xfer_size(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_XFER_SIZE, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_XFER_OFFSET` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_xfer_offset(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_XFER_OFFSET, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_XFER_WINDOW` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_xfer_window(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_XFER_WINDOW, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_ID` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_id(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_ID, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_ENTRIES` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_entries(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_ENTRIES, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_slot_size(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_MMAP_LEN` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_mmap_len(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_MMAP_LEN, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_COMPLETED` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_completed(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_COMPLETED, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_RECORDS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_records(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_RECORDS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_BYTES` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_bytes(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_BYTES, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_RING_DOORBELLS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_ring_doorbells(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_RING_DOORBELLS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_EVENT_TYPE` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_event_type(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_EVENT_TYPE, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_EVENT_KEY` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_event_key(struct nlmsghdr *nlh, const char *value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_EVENT_KEY, value, strlen(value) + 1);
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_event_type_mask(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_event_key_prefix(struct nlmsghdr *nlh, const char *value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX, value, strlen(value) + 1);
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_EVENT_DELIVERED` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_event_delivered(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_EVENT_DELIVERED, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_EVENT_FILTERED` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_event_filtered(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_EVENT_FILTERED, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CHECKSUMS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_checksums(struct nlmsghdr *nlh, const void *value, __u32 len) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CHECKSUMS, value, len);
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_dump_runs(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_verbose(struct nlmsghdr *nlh, __u8 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_zerocopy_echo(struct nlmsghdr *nlh, __u8 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_zerocopy_min_len(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_xfer_window(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_checksum_max_batch(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_GENERATION` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_generation(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_GENERATION, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_dump_max_in_flight(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_config_dump_max_records(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_PORT_ID` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_port_id(struct nlmsghdr *nlh, __u32 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_PORT_ID, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_PORT_DUMPS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_port_dumps(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_PORT_DUMPS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_port_dumps_rejected(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_port_dump_runs(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_port_dump_runs_deferred(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED, &value, sizeof(value));
+}
+
+/** Appends `GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS` to the message. */
+static inline struct nlattr *gnl_foobar_xmpl_put_port_dump_records(struct nlmsghdr *nlh, __u64 value) {
+    return __gnl_foobar_xmpl_put(nlh, GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS, &value, sizeof(value));
+}
+
+/** Decoded attributes of `enum GNL_FOOBAR_XMPL_ATTRIBUTE`. Pointers point into the received message. */
+struct gnl_foobar_xmpl_attrs {
+    /** Bit `1 << <attribute>` is set for each present attribute; see `GNL_FOOBAR_XMPL_ATTR_PRESENT`. */
+    __u64 present;
+    /** `GNL_FOOBAR_XMPL_A_MSG`; null-terminated */
+    const char *msg;
+    /** `GNL_FOOBAR_XMPL_A_DATA` */
+    const void *data;
+    /** Length of `data` in bytes. */
+    __u32 data_len;
+    /** `GNL_FOOBAR_XMPL_A_CLIENT_TS` */
+    __u64 client_ts;
+    /** `GNL_FOOBAR_XMPL_A_KERNEL_RX_TS` */
+    __u64 kernel_rx_ts;
+    /** `GNL_FOOBAR_XMPL_A_KERNEL_TX_TS` */
+    __u64 kernel_tx_ts;
+    /** `GNL_FOOBAR_XMPL_A_XFER_ID` */
+    __u32 xfer_id;
+    /** `GNL_FOOBAR_XMPL_A_XFER_SIZE` */
+    __u64 xfer_size;
+    /** `GNL_FOOBAR_XMPL_A_XFER_OFFSET` */
+    __u64 xfer_offset;
+    /** `GNL_FOOBAR_XMPL_A_XFER_WINDOW` */
+    __u32 xfer_window;
+    /** `GNL_FOOBAR_XMPL_A_RING_ID` */
+    __u32 ring_id;
+    /** `GNL_FOOBAR_XMPL_A_RING_ENTRIES` */
+    __u32 ring_entries;
+    /** `GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE` */
+    __u32 ring_slot_size;
+    /** `GNL_FOOBAR_XMPL_A_RING_MMAP_LEN` */
+    __u64 ring_mmap_len;
+    /** `GNL_FOOBAR_XMPL_A_RING_COMPLETED` */
+    __u32 ring_completed;
+    /** `GNL_FOOBAR_XMPL_A_RING_RECORDS` */
+    __u64 ring_records;
+    /** `GNL_FOOBAR_XMPL_A_RING_BYTES` */
+    __u64 ring_bytes;
+    /** `GNL_FOOBAR_XMPL_A_RING_DOORBELLS` */
+    __u64 ring_doorbells;
+    /** `GNL_FOOBAR_XMPL_A_EVENT_TYPE` */
+    __u32 event_type;
+    /** `GNL_FOOBAR_XMPL_A_EVENT_KEY`; null-terminated */
+    const char *event_key;
+    /** `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK` */
+    __u64 event_type_mask;
+    /** `GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX`; null-terminated */
+    const char *event_key_prefix;
+    /** `GNL_FOOBAR_XMPL_A_EVENT_DELIVERED` */
+    __u32 event_delivered;
+    /** `GNL_FOOBAR_XMPL_A_EVENT_FILTERED` */
+    __u32 event_filtered;
+    /** `GNL_FOOBAR_XMPL_A_CHECKSUMS` */
+    const void *checksums;
+    /** Length of `checksums` in bytes. */
+    __u32 checksums_len;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS` */
+    __u32 config_dump_runs;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE` */
+    __u8 config_verbose;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO` */
+    __u8 config_zerocopy_echo;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN` */
+    __u32 config_zerocopy_min_len;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW` */
+    __u32 config_xfer_window;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH` */
+    __u32 config_checksum_max_batch;
+    /** `GNL_FOOBAR_XMPL_A_GENERATION` */
+    __u64 generation;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT` */
+    __u32 config_dump_max_in_flight;
+    /** `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS` */
+    __u32 config_dump_max_records;
+    /** `GNL_FOOBAR_XMPL_A_PORT_ID` */
+    __u32 port_id;
+    /** `GNL_FOOBAR_XMPL_A_PORT_DUMPS` */
+    __u64 port_dumps;
+    /** `GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED` */
+    __u64 port_dumps_rejected;
+    /** `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS` */
+    __u64 port_dump_runs;
+    /** `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED` */
+    __u64 port_dump_runs_deferred;
+    /** `GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS` */
+    __u64 port_dump_records;
+};
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_ECHO_MSG` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_echo_msg_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_MSG:
+            if (len == 0 || ((const char *) data)[len - 1] != '\0') {
+                return -1;
+            }
+            attrs->msg = data;
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_MSG;
+            break;
+        case GNL_FOOBAR_XMPL_A_DATA:
+            attrs->data = data;
+            attrs->data_len = len;
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_DATA;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_PING` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_ping_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_CLIENT_TS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->client_ts, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CLIENT_TS;
+            break;
+        case GNL_FOOBAR_XMPL_A_KERNEL_RX_TS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->kernel_rx_ts, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_KERNEL_RX_TS;
+            break;
+        case GNL_FOOBAR_XMPL_A_KERNEL_TX_TS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->kernel_tx_ts, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_KERNEL_TX_TS;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_XFER_BEGIN` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_xfer_begin_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_XFER_ID:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->xfer_id, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_XFER_ID;
+            break;
+        case GNL_FOOBAR_XMPL_A_XFER_WINDOW:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->xfer_window, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_XFER_WINDOW;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_XFER_GET` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_xfer_get_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_DATA:
+            attrs->data = data;
+            attrs->data_len = len;
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_DATA;
+            break;
+        case GNL_FOOBAR_XMPL_A_XFER_ID:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->xfer_id, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_XFER_ID;
+            break;
+        case GNL_FOOBAR_XMPL_A_XFER_OFFSET:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->xfer_offset, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_XFER_OFFSET;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_RING_CREATE` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_ring_create_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_RING_ID:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_id, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_ID;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_ENTRIES:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_entries, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_ENTRIES;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_slot_size, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_MMAP_LEN:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_mmap_len, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_MMAP_LEN;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_RING_DOORBELL` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_ring_doorbell_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_RING_ID:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_id, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_ID;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_COMPLETED:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_completed, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_COMPLETED;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_RING_STATS` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_ring_stats_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_RING_ID:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_id, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_ID;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_RECORDS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_records, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_RECORDS;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_BYTES:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_bytes, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_BYTES;
+            break;
+        case GNL_FOOBAR_XMPL_A_RING_DOORBELLS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->ring_doorbells, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_RING_DOORBELLS;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_EVENT_EMIT` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_event_emit_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_EVENT_DELIVERED:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->event_delivered, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_EVENT_DELIVERED;
+            break;
+        case GNL_FOOBAR_XMPL_A_EVENT_FILTERED:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->event_filtered, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_EVENT_FILTERED;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the notification of `GNL_FOOBAR_XMPL_C_EVENT` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the notification of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_event_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_DATA:
+            attrs->data = data;
+            attrs->data_len = len;
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_DATA;
+            break;
+        case GNL_FOOBAR_XMPL_A_EVENT_TYPE:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->event_type, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_EVENT_TYPE;
+            break;
+        case GNL_FOOBAR_XMPL_A_EVENT_KEY:
+            if (len == 0 || ((const char *) data)[len - 1] != '\0') {
+                return -1;
+            }
+            attrs->event_key = data;
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_EVENT_KEY;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_CHECKSUM` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_checksum_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_CHECKSUMS:
+            attrs->checksums = data;
+            attrs->checksums_len = len;
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CHECKSUMS;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_GET_CONFIG` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_get_config_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_dump_runs, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE:
+            if (len != sizeof(__u8)) {
+                return -1;
+            }
+            memcpy(&attrs->config_verbose, data, sizeof(__u8));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO:
+            if (len != sizeof(__u8)) {
+                return -1;
+            }
+            memcpy(&attrs->config_zerocopy_echo, data, sizeof(__u8));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_zerocopy_min_len, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_xfer_window, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_checksum_max_batch, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_dump_max_in_flight, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_dump_max_records, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_SET_CONFIG` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_set_config_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_dump_runs, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE:
+            if (len != sizeof(__u8)) {
+                return -1;
+            }
+            memcpy(&attrs->config_verbose, data, sizeof(__u8));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO:
+            if (len != sizeof(__u8)) {
+                return -1;
+            }
+            memcpy(&attrs->config_zerocopy_echo, data, sizeof(__u8));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_zerocopy_min_len, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_xfer_window, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_checksum_max_batch, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH;
+            break;
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_dump_max_in_flight, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT;
+            break;
+        case GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->config_dump_max_records, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_GET_GENERATION` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_get_generation_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the notification of `GNL_FOOBAR_XMPL_C_INVALIDATE` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the notification of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_invalidate_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
+
+/**
+ * Parses the reply of `GNL_FOOBAR_XMPL_C_PORT_STATS` (`nlh` must not be a NLMSG_ERROR message).
+ * Attributes that the reply of this command never carries are skipped.
+ *
+ * @return < 0 on malformed messages or 0 on success.
+ */
+static inline int gnl_foobar_xmpl_port_stats_reply_parse(const struct nlmsghdr *nlh, struct gnl_foobar_xmpl_attrs *attrs) {
+    const char *pos = (const char *) NLMSG_DATA(nlh) + GENL_HDRLEN;
+    const char *end = (const char *) nlh + nlh->nlmsg_len;
+
+    memset(attrs, 0, sizeof(*attrs));
+    if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+        return -1;
+    }
+    while (end - pos >= NLA_HDRLEN) {
+        const struct nlattr *na = (const struct nlattr *) pos;
+        const void *data = pos + NLA_HDRLEN;
+        __u32 len = na->nla_len - NLA_HDRLEN;
+
+        if (na->nla_len < NLA_HDRLEN || na->nla_len > end - pos) {
+            return -1;
+        }
+        switch (na->nla_type & NLA_TYPE_MASK) {
+        case GNL_FOOBAR_XMPL_A_GENERATION:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->generation, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_GENERATION;
+            break;
+        case GNL_FOOBAR_XMPL_A_PORT_ID:
+            if (len != sizeof(__u32)) {
+                return -1;
+            }
+            memcpy(&attrs->port_id, data, sizeof(__u32));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_PORT_ID;
+            break;
+        case GNL_FOOBAR_XMPL_A_PORT_DUMPS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->port_dumps, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_PORT_DUMPS;
+            break;
+        case GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->port_dumps_rejected, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED;
+            break;
+        case GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->port_dump_runs, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS;
+            break;
+        case GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->port_dump_runs_deferred, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED;
+            break;
+        case GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS:
+            if (len != sizeof(__u64)) {
+                return -1;
+            }
+            memcpy(&attrs->port_dump_records, data, sizeof(__u64));
+            attrs->present |= 1ULL << GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS;
+            break;
+        default:
+            break;
+        }
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return 0;
+}
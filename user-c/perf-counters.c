@@ -0,0 +1,153 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Implementation of "perf-counters.h". */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <linux/perf_event.h>
+
+#include "perf-counters.h"
+
+/** Static description of each counter. */
+static const struct {
+    const char *name;
+    __u32 type;
+    __u64 config;
+    /** Counts only in user mode (exclude_kernel) if 1, only in kernel mode (exclude_user) if 2, both if 0. */
+    int mode;
+} counter_desc[__PERF_CTR_MAX] = {
+        [PERF_CTR_CYCLES_USER] = {"cycles:u", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1},
+        [PERF_CTR_CYCLES_KERNEL] = {"cycles:k", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 2},
+        [PERF_CTR_INSTRUCTIONS_USER] = {"instructions:u", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1},
+        [PERF_CTR_INSTRUCTIONS_KERNEL] = {"instructions:k", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 2},
+        [PERF_CTR_CACHE_MISSES_USER] = {"cache-misses:u", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 1},
+        [PERF_CTR_CACHE_MISSES_KERNEL] = {"cache-misses:k", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 2},
+        [PERF_CTR_CONTEXT_SWITCHES] = {"context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, 0},
+};
+
+/** glibc has no wrapper for this syscall. */
+static int perf_event_open(struct perf_event_attr *attr, pid_t pid, int cpu, int group_fd, unsigned long flags) {
+    return syscall(SYS_perf_event_open, attr, pid, cpu, group_fd, flags);
+}
+
+int perf_counters_open(struct perf_counters *pc) {
+    struct perf_event_attr attr;
+    int available = 0;
+    int i;
+
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counter_desc[i].type;
+        attr.config = counter_desc[i].config;
+        attr.disabled = 1;
+        attr.exclude_hv = 1;
+        attr.exclude_kernel = counter_desc[i].mode == 1;
+        attr.exclude_user = counter_desc[i].mode == 2;
+        // more counters than hardware registers => the kernel multiplexes them; we scale the values
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // pid = 0, cpu = -1: the calling thread on any CPU
+        pc->fd[i] = perf_event_open(&attr, 0, -1, -1, 0);
+        pc->value[i] = 0;
+        if (pc->fd[i] >= 0) {
+            available++;
+        }
+    }
+    return available;
+}
+
+/**
+ * Reads value, time enabled and time running of a counter into `buf`.
+ *
+ * @return < 0 on failure or 0 on success.
+ */
+static int read_counter(int fd, __u64 buf[3]) {
+    return read(fd, buf, 3 * sizeof(__u64)) == 3 * sizeof(__u64) ? 0 : -1;
+}
+
+void perf_counters_start(struct perf_counters *pc) {
+    int i;
+
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        memset(pc->start[i], 0, sizeof(pc->start[i]));
+        if (pc->fd[i] >= 0) {
+            // PERF_EVENT_IOC_RESET would only reset the value, not the times
+            read_counter(pc->fd[i], pc->start[i]);
+        }
+    }
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        if (pc->fd[i] >= 0) {
+            ioctl(pc->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void perf_counters_stop(struct perf_counters *pc) {
+    // value, time_enabled, time_running
+    __u64 buf[3], value, enabled, running;
+    int i;
+
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        if (pc->fd[i] >= 0) {
+            ioctl(pc->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        pc->value[i] = 0;
+        if (pc->fd[i] < 0 || read_counter(pc->fd[i], buf) < 0) {
+            continue;
+        }
+        value = buf[0] - pc->start[i][0];
+        enabled = buf[1] - pc->start[i][1];
+        running = buf[2] - pc->start[i][2];
+        pc->value[i] = running == 0 ? 0 : (__u64) ((double) value * enabled / running);
+    }
+}
+
+void perf_counters_print(const struct perf_counters *pc, const char *prefix, double requests) {
+    int i;
+
+    printf("%s", prefix);
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        if (pc->fd[i] < 0) {
+            printf(" %s=n/a", counter_desc[i].name);
+        } else {
+            printf(" %s=%.1f", counter_desc[i].name, pc->value[i] / requests);
+        }
+    }
+    printf("\n");
+}
+
+void perf_counters_close(struct perf_counters *pc) {
+    int i;
+
+    for (i = 0; i < __PERF_CTR_MAX; i++) {
+        if (pc->fd[i] >= 0) {
+            close(pc->fd[i]);
+            pc->fd[i] = -1;
+        }
+    }
+}
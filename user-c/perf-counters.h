@@ -0,0 +1,86 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Hardware and software performance counters of the calling thread via `perf_event_open(2)`
+ * for the benchmarks. Cycles, instructions and cache misses are counted separately for user
+ * and kernel mode, so that one can see whether a change saves kernel cycles or only moves
+ * them to the userland (or vice versa). The .doit/.dumpit handlers of the kernel module run
+ * in the context of our syscalls, hence they are included in the kernel counts.
+ *
+ * Counters that can't be opened (e.g. due to `/proc/sys/kernel/perf_event_paranoid` or in
+ * VMs without PMU) are reported as "n/a"; the benchmarks still work.
+ */
+
+#include <linux/types.h>
+
+/** All counters that are measured. */
+enum perf_counter_id {
+    PERF_CTR_CYCLES_USER,
+    PERF_CTR_CYCLES_KERNEL,
+    PERF_CTR_INSTRUCTIONS_USER,
+    PERF_CTR_INSTRUCTIONS_KERNEL,
+    PERF_CTR_CACHE_MISSES_USER,
+    PERF_CTR_CACHE_MISSES_KERNEL,
+    /** Software event; there is no user/kernel split for context switches. */
+    PERF_CTR_CONTEXT_SWITCHES,
+    /** Unused marker field to get the number of counters. */
+    __PERF_CTR_MAX,
+};
+
+struct perf_counters {
+    /** File descriptor per counter or -1 if the counter is not available. */
+    int fd[__PERF_CTR_MAX];
+    /** Counter values of the last measurement (scaled if the kernel multiplexed the counter). */
+    __u64 value[__PERF_CTR_MAX];
+    /** Raw readings (value, time enabled, time running) at `perf_counters_start()`. */
+    __u64 start[__PERF_CTR_MAX][3];
+};
+
+/**
+ * Opens all counters for the calling thread (disabled).
+ *
+ * @return the number of available counters.
+ */
+int perf_counters_open(struct perf_counters *pc);
+
+/**
+ * Reads the start values of all available counters and enables them.
+ */
+void perf_counters_start(struct perf_counters *pc);
+
+/**
+ * Disables all available counters and stores the counts since `perf_counters_start()` in `pc->value`.
+ * The kernel doesn't reset the enabled and running times of a counter, hence both the count and the
+ * times are taken as deltas before the count is scaled.
+ */
+void perf_counters_stop(struct perf_counters *pc);
+
+/**
+ * Prints the counter values of the last measurement divided by `requests`, prefixed with `prefix`.
+ */
+void perf_counters_print(const struct perf_counters *pc, const char *prefix, double requests);
+
+/**
+ * Closes all counters.
+ */
+void perf_counters_close(struct perf_counters *pc);
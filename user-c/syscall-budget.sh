@@ -0,0 +1,80 @@
+#!/bin/sh
+
+# System call budget check: runs every client under "gnl-syscount" and fails if one of them needs
+# more system calls for an operation (cold start, a warm echo, a dump of N records) than recorded
+# in "../measurements/syscall-budget.txt". Run it after each change to a client so that syscall
+# bloat is caught the moment it lands. Clients that are not built are skipped; built clients
+# without a budget fail.
+#
+# "record" prints the counts of all clients as a new budget file instead; dumps get a budget per
+# record in addition. It fails if a client is missing or fails, so that no budget is left out:
+#   $ sh syscall-budget.sh record > ../measurements/syscall-budget.txt
+#
+# Usage: sh syscall-budget.sh [record]
+# Requires a loaded kernel module, "make" and "cargo build --release" in "../user-rust".
+
+BUDGET=../measurements/syscall-budget.txt
+RUST=../user-rust/target/release
+MODE=${1:-check}
+FAILED=0
+
+if [ ! -x ./gnl-syscount ]; then
+    echo "./gnl-syscount not found; run 'make gnl-syscount' first"
+    exit 1
+fi
+
+# Usage: client <name> <program> [args ...]
+client() {
+    NAME=$1
+    shift
+    if [ ! -x "$1" ]; then
+        if [ "$MODE" = "record" ]; then
+            echo "$1 not found; can't record $NAME" >&2
+            FAILED=1
+        else
+            echo "$1 not found; skipping $NAME" >&2
+        fi
+        return
+    fi
+    if [ "$MODE" = "record" ]; then
+        # the counts go to stderr; drop the output of the client
+        if ! COUNTS=$(./gnl-syscount -r -n "$NAME" -- "$@" 2>&1 >/dev/null); then
+            echo "$COUNTS" >&2
+            echo "$NAME failed; is the kernel module loaded?" >&2
+            FAILED=1
+            return
+        fi
+        echo "$COUNTS" | grep "^$NAME "
+        echo
+    elif ! grep -q "^$NAME[[:space:]]" "$BUDGET"; then
+        # a client without budget would pass unnoticed otherwise
+        echo "$NAME: no budget in $BUDGET; record it with 'sh syscall-budget.sh record'" >&2
+        FAILED=1
+    elif ! ./gnl-syscount -b "$BUDGET" -n "$NAME" -- "$@" >/dev/null; then
+        FAILED=1
+    fi
+}
+
+if [ "$MODE" = "record" ]; then
+    echo "# System call budgets, recorded with \"sh syscall-budget.sh record\" on $(uname -r)."
+    echo "# <client>        <entry>                <max system calls> [per record of a dump]"
+    echo
+elif ! grep -q '^[^#[:space:]]' "$BUDGET"; then
+    echo "no budgets recorded in $BUDGET; record them on a machine with the kernel module loaded:" >&2
+    echo "  sh syscall-budget.sh record > $BUDGET" >&2
+    exit 1
+fi
+
+client user-pure ./user-pure
+client user-libnl ./user-libnl
+client user-rust-echo "$RUST/echo"
+client user-rust-dump "$RUST/echo_with_dump_flag"
+client gnl-client-echo ./bench-echo 10
+client gnl-client-dump ./bench-dump 10
+
+if [ "$FAILED" -ne 0 ] && [ "$MODE" = "record" ]; then
+    echo "recording failed; see above" >&2
+elif [ "$FAILED" -ne 0 ]; then
+    echo "system call budget exceeded or missing; see above"
+fi
+exit $FAILED
@@ -24,6 +24,9 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+// setsockopt(), SOL_NETLINK
+#include <sys/socket.h>
 
 #include <netlink/attr.h>
 // "libnl" (core)
@@ -45,6 +48,40 @@
 // netlink family id of the netlink family we want to use
 int family_id = -1;
 
+/**
+ * Error callback (see `nl_cb_err()`): prints the error code and the extended ACK attributes of a
+ * NLMSG_ERROR message. libnl doesn't parse them for us (at least not in all versions), but the
+ * layout is simple: The attributes follow `struct nlmsgerr` and, unless the kernel capped the
+ * message (NLM_F_CAPPED), the rest of our original request.
+ */
+static int print_nlmsg_err(struct sockaddr_nl *nla, struct nlmsgerr *err, void *arg) {
+    // libnl passes the payload of the NLMSG_ERROR message; its header directly precedes it
+    struct nlmsghdr *hdr = (struct nlmsghdr *) ((char *) err - NLMSG_HDRLEN);
+    struct nlattr *tb_err[NLMSGERR_ATTR_MAX + 1];
+    int offset = sizeof(*err);
+
+    fprintf(stderr, LOG_PREFIX "Received NLMSG_ERROR message: %d (%s)\n", err->error, strerror(-err->error));
+    if (!(hdr->nlmsg_flags & NLM_F_ACK_TLVS)) {
+        return NL_STOP;
+    }
+    if (!(hdr->nlmsg_flags & NLM_F_CAPPED)) {
+        offset += NLMSG_ALIGN(err->msg.nlmsg_len) - NLMSG_HDRLEN;
+    }
+    if (nla_parse(tb_err, NLMSGERR_ATTR_MAX, (struct nlattr *) ((char *) err + offset),
+                  nlmsg_datalen(hdr) - offset, NULL) < 0) {
+        return NL_STOP;
+    }
+    if (tb_err[NLMSGERR_ATTR_MSG]) {
+        fprintf(stderr, LOG_PREFIX "  message: %s\n", nla_get_string(tb_err[NLMSGERR_ATTR_MSG]));
+    }
+    if (tb_err[NLMSGERR_ATTR_OFFS]) {
+        fprintf(stderr, LOG_PREFIX "  offending attribute at offset %u of the request\n",
+                nla_get_u32(tb_err[NLMSGERR_ATTR_OFFS]));
+    }
+    // the receive ends; nl_recvmsgs_default() returns the error
+    return NL_STOP;
+}
+
 // Callback function for all received netlink messages
 int nl_callback(struct nl_msg* recv_msg, void* arg)
 {
@@ -55,11 +92,10 @@ int nl_callback(struct nl_msg* recv_msg, void* arg)
     // (we can only send an specific attribute once per msg)
     struct nlattr * tb_msg[GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN];
 
-    // nlmsg_type is either family id number for "good" messages
-    // or NLMSG_ERROR for error messages.
-    if (ret_hdr->nlmsg_type == NLMSG_ERROR) {
-        fprintf(stderr, LOG_PREFIX "Received NLMSG_ERROR message!\n");
-        return NL_STOP;
+    // nlmsg_type is either family id number for "good" messages or a control message like
+    // NLMSG_ERROR; libnl handles the latter after this callback (errors via `print_nlmsg_err()`).
+    if (ret_hdr->nlmsg_type != family_id) {
+        return NL_OK;
     }
 
     // Pointer to message payload
@@ -67,7 +103,7 @@ int nl_callback(struct nl_msg* recv_msg, void* arg)
 
     // Create attribute index based on a stream of attributes.
     nla_parse(tb_msg, // Index array to be filled
-              GNL_FOOBAR_XMPL_ATTRIBUTE_ENUM_LEN, // length of array tb_msg
+              GNL_FOOBAR_XMPL_A_MAX, // highest attribute number; tb_msg must have space for maxtype + 1 entries
               genlmsg_attrdata(gnlh, 0), // Head of attribute stream
               genlmsg_attrlen(gnlh, 0), // 	Length of attribute stream
               NULL // GNlFoobarXmplAttribute validation policy
@@ -96,6 +132,15 @@ int main(void) {
     // equivalent to nl_connect(socket, NETLINK_GENERIC);
     genl_connect(socket);
 
+    // Cheaper and more helpful errors: NLMSG_ERROR only carries the header of our request instead of a
+    // full copy (NETLINK_CAP_ACK), but a message and the offending attribute (NETLINK_EXT_ACK).
+    // Not all libnl versions have a setter for these options, hence we use the fd directly.
+    int one = 1;
+    if (setsockopt(nl_socket_get_fd(socket), SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one)) < 0 ||
+        setsockopt(nl_socket_get_fd(socket), SOL_NETLINK, NETLINK_EXT_ACK, &one, sizeof(one)) < 0) {
+        perror(LOG_PREFIX "setsockopt()");
+    }
+
     // retrieve family id (kernel module registered a netlink family via generic netlink)
     family_id = genl_ctrl_resolve(socket, FAMILY_NAME);
 
@@ -123,6 +168,10 @@ int main(void) {
                         nl_callback, // function
                         NULL // no argument to be passed to callback function
     );
+    // NLMSG_ERROR messages go to the error callback, which gets the `struct nlmsgerr` directly
+    struct nl_cb * cb = nl_socket_get_cb(socket);
+    nl_cb_err(cb, NL_CB_CUSTOM, print_nlmsg_err, NULL);
+    nl_cb_put(cb);
 
     // we build a netlink package
     // it's payload is the generic netlink header with its data
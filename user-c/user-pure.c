@@ -83,6 +83,8 @@ int open_and_bind_socket();
 int resolve_family_id_by_name();
 // Comments on function body below.
 int send_echo_msg_and_get_reply();
+// Comments on function body below.
+void print_nlmsg_err(struct nlmsghdr *nlh);
 
 int main(void)
 {
@@ -128,9 +130,56 @@ int open_and_bind_socket() {
         fprintf(stderr, LOG_PREFIX "error binding socket\n");
         return -1;
     }
+
+    // Optional: Cheaper and more helpful error messages (NLMSG_ERROR).
+    // By default the kernel copies the whole request into the NLMSG_ERROR reply. With NETLINK_CAP_ACK
+    // only the Netlink header of the request is copied back. With NETLINK_EXT_ACK the kernel appends
+    // attributes (NLMSGERR_ATTR_*) to the error, e.g. a human readable message and the offset of the
+    // offending attribute in our request. Old kernels don't know these options; we can live without.
+    int one = 1;
+    if (setsockopt(nl_fd, SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one)) < 0) {
+        perror(LOG_PREFIX "setsockopt(NETLINK_CAP_ACK)");
+    }
+    if (setsockopt(nl_fd, SOL_NETLINK, NETLINK_EXT_ACK, &one, sizeof(one)) < 0) {
+        perror(LOG_PREFIX "setsockopt(NETLINK_EXT_ACK)");
+    }
     return 0;
 }
 
+/**
+ * Prints the error code and the extended ACK attributes (see `open_and_bind_socket()`)
+ * of the NLMSG_ERROR message `nlh`. Memory layout of the message:
+ * -----------------------------------------------------------------------
+ * | netlink header (nlmsg_type = NLMSG_ERROR)                           |
+ * | struct nlmsgerr: error code + netlink header of our request         |
+ * | <rest of our request> (only if the kernel didn't set NLM_F_CAPPED)  |
+ * | NLMSGERR_ATTR_* attributes (only if the kernel set NLM_F_ACK_TLVS)  |
+ * -----------------------------------------------------------------------
+ */
+void print_nlmsg_err(struct nlmsghdr *nlh) {
+    struct nlmsgerr *err = NLMSG_DATA(nlh);
+    int offset = NLMSG_LENGTH(sizeof(*err));
+
+    printf(LOG_PREFIX "Kernel replied with error code %d (%s)\n", err->error, strerror(-err->error));
+    if (!(nlh->nlmsg_flags & NLM_F_ACK_TLVS)) {
+        return;
+    }
+    if (!(nlh->nlmsg_flags & NLM_F_CAPPED)) {
+        offset += NLMSG_ALIGN(err->msg.nlmsg_len) - NLMSG_HDRLEN;
+    }
+    int remaining = (int) nlh->nlmsg_len - offset;
+    struct nlattr *na = (struct nlattr *) ((char *) nlh + offset);
+    while (remaining >= (int) sizeof(*na) && na->nla_len >= sizeof(*na) && na->nla_len <= remaining) {
+        if (na->nla_type == NLMSGERR_ATTR_MSG) {
+            printf(LOG_PREFIX "  message: %s\n", (char *) NLA_DATA(na));
+        } else if (na->nla_type == NLMSGERR_ATTR_OFFS) {
+            printf(LOG_PREFIX "  offending attribute at offset %u of the request\n", *(__u32 *) NLA_DATA(na));
+        }
+        remaining -= NLA_ALIGN(na->nla_len);
+        na = (struct nlattr *) ((char *) na + NLA_ALIGN(na->nla_len));
+    }
+}
+
 /**
  * Resolves the id of the Netlink family `FAMILY_NAME` from `gnl_foobar_xmpl.prop.h`
  * using Generic Netlink control interface,
@@ -288,6 +337,7 @@ int send_echo_msg_and_get_reply() {
     // Validate response message
     if (nl_response_msg.n.nlmsg_type == NLMSG_ERROR) { //E rror
         printf(LOG_PREFIX "Error while receiving reply from kernel: NACK Received\n");
+        print_nlmsg_err(&nl_response_msg.n);
         close(nl_fd);
         fprintf(stderr, LOG_PREFIX "error receiving custom message result\n");
         return -1;
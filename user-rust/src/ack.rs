@@ -0,0 +1,170 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+//! Capped and extended ACKs (`NETLINK_CAP_ACK`, `NETLINK_EXT_ACK`). With both enabled, a
+//! NLMSG_ERROR reply only carries the Netlink header of the request instead of a full copy, plus
+//! an error message and the offset of the offending attribute.
+//!
+//! `neli` 0.6 expects the full request inside of NLMSG_ERROR replies, hence a socket with capped
+//! ACKs must receive everything that can be an error as raw bytes (see `recv_raw()`): split the
+//! datagram with `messages()` and decode errors with `parse_nlmsgerr()`, the end of a dump with
+//! `parse_done()` and replies of the family with `crate::codec`.
+
+use std::convert::TryInto;
+use std::io;
+use std::os::unix::io::RawFd;
+use std::str;
+
+use crate::codec::{NLA_HDRLEN, NLMSG_HDRLEN};
+
+/// Type of NLMSG_ERROR messages.
+pub const NLMSG_ERROR: u16 = 0x2;
+/// Type of the message that ends a dump.
+pub const NLMSG_DONE: u16 = 0x3;
+/// `nlmsg_flags` of NLMSG_ERROR: the copy of the request was capped to its header.
+pub const NLM_F_CAPPED: u16 = 0x100;
+/// `nlmsg_flags` of NLMSG_ERROR: extended ACK attributes follow the (capped) request.
+pub const NLM_F_ACK_TLVS: u16 = 0x200;
+/// Error message string.
+pub const NLMSGERR_ATTR_MSG: u16 = 1;
+/// Offset of the offending attribute in the request (u32).
+pub const NLMSGERR_ATTR_OFFS: u16 = 2;
+
+const SOL_NETLINK: libc::c_int = 270;
+const NETLINK_CAP_ACK: libc::c_int = 10;
+const NETLINK_EXT_ACK: libc::c_int = 11;
+
+/// Decoded NLMSG_ERROR message.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ExtAck {
+    /// 0 for an ACK or a negative errno.
+    pub error: i32,
+    /// Error message from the kernel (`NLMSGERR_ATTR_MSG`).
+    pub msg: Option<String>,
+    /// Offset of the offending attribute in the request (`NLMSGERR_ATTR_OFFS`).
+    pub offset: Option<u32>,
+}
+
+/// Enables `NETLINK_CAP_ACK` and `NETLINK_EXT_ACK` on the Netlink socket `fd`.
+/// Fails on kernels without support for them; callers may ignore this.
+pub fn enable(fd: RawFd) -> io::Result<()> {
+    for opt in &[NETLINK_CAP_ACK, NETLINK_EXT_ACK] {
+        let one: libc::c_int = 1;
+        let rc = unsafe {
+            libc::setsockopt(
+                fd,
+                SOL_NETLINK,
+                *opt,
+                &one as *const libc::c_int as *const libc::c_void,
+                std::mem::size_of::<libc::c_int>() as libc::socklen_t,
+            )
+        };
+        if rc < 0 {
+            return Err(io::Error::last_os_error());
+        }
+    }
+    Ok(())
+}
+
+/// Receives one datagram from the Netlink socket `fd` into `buf`.
+pub fn recv_raw(fd: RawFd, buf: &mut [u8]) -> io::Result<usize> {
+    let rc = unsafe { libc::recv(fd, buf.as_mut_ptr() as *mut libc::c_void, buf.len(), 0) };
+    if rc < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(rc as usize)
+}
+
+/// Splits a received datagram into its Netlink messages. Stops at the first truncated message.
+pub fn messages(buf: &[u8]) -> Vec<&[u8]> {
+    let mut msgs = Vec::new();
+    let mut rest = buf;
+    while rest.len() >= NLMSG_HDRLEN {
+        let nlmsg_len = u32::from_ne_bytes(rest[0..4].try_into().unwrap()) as usize;
+        if nlmsg_len < NLMSG_HDRLEN || nlmsg_len > rest.len() {
+            break;
+        }
+        msgs.push(&rest[..nlmsg_len]);
+        rest = rest.get((nlmsg_len + 3) & !3..).unwrap_or(&[]);
+    }
+    msgs
+}
+
+/// Decodes the NLMSG_DONE message at the beginning of `msg`: the result of the dump, i.e. 0 or a
+/// negative errno. Returns `None` if it isn't a NLMSG_DONE message.
+pub fn parse_done(msg: &[u8]) -> Option<i32> {
+    if msg.len() < NLMSG_HDRLEN || u16::from_ne_bytes(msg[4..6].try_into().unwrap()) != NLMSG_DONE {
+        return None;
+    }
+    // older kernels may end a dump without the error code
+    Some(msg.get(NLMSG_HDRLEN..NLMSG_HDRLEN + 4).map_or(0, |e| i32::from_ne_bytes(e.try_into().unwrap())))
+}
+
+/// Decodes the NLMSG_ERROR message at the beginning of `msg`.
+/// Returns `None` if it isn't a (valid) NLMSG_ERROR message.
+pub fn parse_nlmsgerr(msg: &[u8]) -> Option<ExtAck> {
+    // struct nlmsgerr: error code followed by the header of the request
+    const NLMSGERR_LEN: usize = 4 + NLMSG_HDRLEN;
+
+    if msg.len() < NLMSG_HDRLEN + NLMSGERR_LEN {
+        return None;
+    }
+    let nlmsg_len = u32::from_ne_bytes(msg[0..4].try_into().unwrap()) as usize;
+    let nlmsg_type = u16::from_ne_bytes(msg[4..6].try_into().unwrap());
+    let nlmsg_flags = u16::from_ne_bytes(msg[6..8].try_into().unwrap());
+    if nlmsg_type != NLMSG_ERROR || nlmsg_len < NLMSG_HDRLEN + NLMSGERR_LEN || nlmsg_len > msg.len() {
+        return None;
+    }
+    let mut ack = ExtAck {
+        error: i32::from_ne_bytes(msg[NLMSG_HDRLEN..NLMSG_HDRLEN + 4].try_into().unwrap()),
+        msg: None,
+        offset: None,
+    };
+    if nlmsg_flags & NLM_F_ACK_TLVS == 0 {
+        return Some(ack);
+    }
+
+    let mut offset = NLMSG_HDRLEN + NLMSGERR_LEN;
+    if nlmsg_flags & NLM_F_CAPPED == 0 {
+        let req_len = u32::from_ne_bytes(msg[NLMSG_HDRLEN + 4..NLMSG_HDRLEN + 8].try_into().unwrap()) as usize;
+        offset += ((req_len + 3) & !3).saturating_sub(NLMSG_HDRLEN);
+    }
+    let mut stream = msg.get(offset..nlmsg_len).unwrap_or(&[]);
+    while stream.len() >= NLA_HDRLEN {
+        let len = u16::from_ne_bytes(stream[0..2].try_into().unwrap()) as usize;
+        let nla_type = u16::from_ne_bytes(stream[2..4].try_into().unwrap()) & 0x3fff;
+        if len < NLA_HDRLEN || len > stream.len() {
+            break;
+        }
+        let payload = &stream[NLA_HDRLEN..len];
+        match nla_type {
+            NLMSGERR_ATTR_MSG => {
+                let payload = payload.split(|b| *b == 0).next().unwrap_or(&[]);
+                ack.msg = str::from_utf8(payload).ok().map(String::from);
+            }
+            NLMSGERR_ATTR_OFFS if payload.len() >= 4 => {
+                ack.offset = Some(u32::from_ne_bytes(payload[0..4].try_into().unwrap()));
+            }
+            _ => {}
+        }
+        stream = stream.get((len + 3) & !3..).unwrap_or(&[]);
+    }
+    Some(ack)
+}
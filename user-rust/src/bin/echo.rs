@@ -32,7 +32,9 @@ use neli::{
     socket::NlSocketHandle,
     types::{Buffer, GenlBuffer},
 };
+use std::os::unix::io::AsRawFd;
 use std::process;
+use user_rust::{ack, codec};
 use user_rust::{FAMILY_NAME, NlFoobarXmplAttribute, NlFoobarXmplCommand};
 
 /// Data we want to send to kernel.
@@ -49,6 +51,11 @@ fn main() {
     )
     .unwrap();
 
+    // errors only carry the header of our request plus a message and the offending attribute
+    if let Err(e) = ack::enable(sock.as_raw_fd()) {
+        eprintln!("[User-Rust]: extended ACKs not supported: {}", e);
+    }
+
     let family_id;
     let res = sock.resolve_genl_family(FAMILY_NAME);
     match res {
@@ -119,18 +126,20 @@ fn main() {
     // Send data
     sock.send(nlmsghdr).expect("Send must work");
 
-    // receive echo'ed message
-    let res: Nlmsghdr<u16, Genlmsghdr<NlFoobarXmplCommand, NlFoobarXmplAttribute>> =
-        sock.recv().expect("Should receive a message").unwrap();
-
-    /* USELESS, just note: this is always the case. Otherwise neli would have returned Error
-    if res.nl_type == family_id {
-        println!("Received successful reply!");
-    }*/
+    // receive echo'ed message. With capped ACKs, `neli` 0.6 can't decode the error that the kernel
+    // sends instead if the request fails, hence we receive raw bytes and decode them ourselves.
+    let mut buf = vec![0_u8; 64 * 1024];
+    let len = ack::recv_raw(sock.as_raw_fd(), &mut buf).expect("Should receive a message");
+    if let Some(err) = ack::parse_nlmsgerr(&buf[..len]) {
+        eprintln!(
+            "[User-Rust]: Kernel replied with error {}: {}",
+            err.error,
+            err.msg.as_deref().unwrap_or("no message")
+        );
+        process::exit(1);
+    }
 
-    let attr_handle = res.get_payload().unwrap().get_attr_handle();
-    let received = attr_handle
-        .get_attr_payload_as_with_len::<String>(NlFoobarXmplAttribute::Msg)
-        .unwrap();
+    let res = codec::echo_msg_reply_parse(&buf[..len]).expect("Should receive a valid reply");
+    let received = res.msg.expect("Reply must carry a message");
     println!("[User-Rust]: Received from kernel: '{}'", received);
 }
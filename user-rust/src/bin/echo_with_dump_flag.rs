@@ -24,7 +24,8 @@
 //! The dump example uses the NLM_F_DUMP flag. A dump can be understand as a
 //! "GET ALL DATA OF THE GIVEN ENTITY", i.e. the userland can receive as long as the
 //! .dumpit callback returns data. For the sake of simplicity the kernel returns
-//! exactly 3 messages (hard coded) during a dump, before the next .dumpit can start.
+//! a fixed number of records (the tunable "dump-runs", 3 by default), possibly several
+//! of them in one datagram, followed by NLMSG_DONE.
 //! In this example we don't need to send a message that gets echoed back. We get some
 //! dummy data that simulates a real world application dump (= give me all your data).
 //!
@@ -42,9 +43,10 @@ use neli::{
     socket::NlSocketHandle,
     types::{Buffer, GenlBuffer},
 };
+use std::os::unix::io::AsRawFd;
 use std::process;
+use user_rust::{ack, codec};
 use user_rust::{FAMILY_NAME, NlFoobarXmplAttribute, NlFoobarXmplCommand};
-use neli::consts::nl::Nlmsg;
 
 /// Data we want to send to kernel.
 const ECHO_MSG: &str = "Some data that has `Nl` trait implemented, like &str";
@@ -59,6 +61,10 @@ fn main() {
         &[],
     ).unwrap();
 
+    if let Err(e) = ack::enable(sock.as_raw_fd()) {
+        eprintln!("[User-Rust]: extended ACKs not supported: {}", e);
+    }
+
     let family_id;
     let res = sock.resolve_genl_family(FAMILY_NAME);
     match res {
@@ -81,22 +87,31 @@ fn main() {
 
         sock.send(nlmsghdr).expect("Send must work");
 
-        // Because we hard coded into the kernel that we want to receive 3 entities during a dump call
-        // we do this 3 times. Why 3? For the sake of simplicity and to show you the basic principle
-        // behind it.
-        for _ in 0..3 {
-            let res: Nlmsghdr<u16, Genlmsghdr<NlFoobarXmplCommand, NlFoobarXmplAttribute>> =
-                sock.recv().expect("Should receive a message").unwrap();
-
-            let attr_handle = res.get_payload().unwrap().get_attr_handle();
-            let received = attr_handle
-                .get_attr_payload_as_with_len::<String>(NlFoobarXmplAttribute::Msg)
-                .unwrap();
-            println!("[User-Rust]: Received from kernel from .dumpit callback: [seq={}] '{}'", res.nl_seq, received);
+        // We receive until NLMSG_DONE. A rejected dump (e.g. EBUSY by "dump-max-in-flight") ends with a
+        // capped error instead, which `neli` 0.6 can't decode, hence we receive raw bytes and decode
+        // the records ourselves.
+        let mut buf = vec![0_u8; 64 * 1024];
+        'dump: loop {
+            let len = ack::recv_raw(sock.as_raw_fd(), &mut buf).expect("Should receive a message");
+            for msg in ack::messages(&buf[..len]) {
+                if let Some(err) = ack::parse_nlmsgerr(msg) {
+                    eprintln!(
+                        "[User-Rust]: Kernel rejected the dump with error {}: {}",
+                        err.error,
+                        err.msg.as_deref().unwrap_or("no message")
+                    );
+                    process::exit(1);
+                }
+                if let Some(error) = ack::parse_done(msg) {
+                    assert_eq!(error, 0, "Dump must not fail");
+                    break 'dump;
+                }
+                let res = codec::echo_msg_reply_parse(msg).expect("Should receive a valid record");
+                let received = res.msg.expect("Record must carry a message");
+                let seq = u32::from_ne_bytes([msg[8], msg[9], msg[10], msg[11]]);
+                println!("[User-Rust]: Received from kernel from .dumpit callback: [seq={}] '{}'", seq, received);
+            }
         }
-
-        let done_msg: Nlmsghdr<u16, Genlmsghdr<NlFoobarXmplCommand, NlFoobarXmplAttribute>> = sock.recv().expect("Should receive message").unwrap();
-        assert_eq!(u16::from(Nlmsg::Done), done_msg.nl_type, "Must receive NLMSG_DONE response" /* 3 is NLMSG_DONE */);
         println!("Received NLMSG_DONE");
     }
 
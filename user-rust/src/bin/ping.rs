@@ -0,0 +1,123 @@
+/* Copyright 2021 Philipp Schuster
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in the
+ * Software without restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+//! The fully documented binary is `src/bin/echo.rs`. In this file only changes, according
+//! to the description of the filename, are documented.
+//!
+//! Sends a few `Ping` requests with the CLOCK_MONOTONIC send timestamp. The kernel replies with
+//! the timestamps of the entry of its handler and of the moment right before it sends the reply,
+//! hence we can split the round trip into request leg, service time and reply leg. The C
+//! program `user-c/bench-ping` does the same for many pings and prints percentiles.
+
+use neli::{
+    consts::{
+        nl::{NlmF, NlmFFlags},
+        socket::NlFamily,
+    },
+    genl::{Genlmsghdr, Nlattr},
+    nl::{NlPayload, Nlmsghdr},
+    socket::NlSocketHandle,
+    types::{Buffer, GenlBuffer},
+};
+use std::os::unix::io::AsRawFd;
+use std::process;
+use user_rust::{ack, codec};
+use user_rust::{FAMILY_NAME, NlFoobarXmplAttribute, NlFoobarXmplCommand};
+
+/// Number of pings.
+const PINGS: usize = 5;
+
+/// CLOCK_MONOTONIC in nanoseconds; the same clock as `ktime_get_ns()` in the kernel.
+fn monotonic_ns() -> u64 {
+    let mut ts = libc::timespec { tv_sec: 0, tv_nsec: 0 };
+    unsafe { libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts) };
+    ts.tv_sec as u64 * 1_000_000_000 + ts.tv_nsec as u64
+}
+
+fn main() {
+    println!("Rust-Binary: ping");
+
+    let mut sock = NlSocketHandle::connect(
+        NlFamily::Generic,
+        // 0 is pid of kernel -> socket is connected to kernel
+        Some(0),
+        &[],
+    )
+    .unwrap();
+
+    if let Err(e) = ack::enable(sock.as_raw_fd()) {
+        eprintln!("[User-Rust]: extended ACKs not supported: {}", e);
+    }
+
+    let family_id;
+    let res = sock.resolve_genl_family(FAMILY_NAME);
+    match res {
+        Ok(id) => family_id = id,
+        Err(e) => {
+            eprintln!(
+                "The Netlink family '{}' can't be found. Is the kernel module loaded yet? neli-error='{}'",
+                FAMILY_NAME, e
+            );
+            // exit without error in order for Continuous Integration and automatic testing not to fail
+            // when the kernel module is not loaded
+            return;
+        }
+    }
+
+    let mut buf = vec![0_u8; 4096];
+    for _ in 0..PINGS {
+        let send_ts = monotonic_ns();
+        let mut attrs: GenlBuffer<NlFoobarXmplAttribute, Buffer> = GenlBuffer::new();
+        attrs.push(Nlattr::new(false, false, NlFoobarXmplAttribute::ClientTs, send_ts).unwrap());
+        let gnmsghdr = Genlmsghdr::new(NlFoobarXmplCommand::Ping, 1, attrs);
+        let nlmsghdr = Nlmsghdr::new(
+            None,
+            family_id,
+            NlmFFlags::new(&[NlmF::Request]),
+            None,
+            Some(process::id()),
+            NlPayload::Payload(gnmsghdr),
+        );
+        sock.send(nlmsghdr).expect("Send must work");
+
+        // raw bytes: `neli` 0.6 can't decode the capped error that replaces the reply on failure
+        let len = ack::recv_raw(sock.as_raw_fd(), &mut buf).expect("Should receive a message");
+        let recv_ts = monotonic_ns();
+        if let Some(err) = ack::parse_nlmsgerr(&buf[..len]) {
+            eprintln!(
+                "[User-Rust]: Kernel replied with error {}: {}",
+                err.error,
+                err.msg.as_deref().unwrap_or("no message")
+            );
+            process::exit(1);
+        }
+
+        let res = codec::ping_reply_parse(&buf[..len]).expect("Should receive a valid reply");
+        let rx_ts = res.kernel_rx_ts.expect("Reply must carry the receive timestamp");
+        let tx_ts = res.kernel_tx_ts.expect("Reply must carry the send timestamp");
+        println!(
+            "[User-Rust]: request leg {} ns, service {} ns, reply leg {} ns, round trip {} ns",
+            rx_ts.wrapping_sub(send_ts),
+            tx_ts.wrapping_sub(rx_ts),
+            recv_ts.wrapping_sub(tx_ts),
+            recv_ts - send_ts
+        );
+    }
+}
@@ -22,10 +22,12 @@
 //! family via Generic Netlink. The family is called "gnl_foobar_xmpl" and the
 //! kernel module must be loaded first. Otherwise the family doesn't exist.
 //!
-//! This examples provokes an error response from the kernel.
-//! TODO this fails until https://github.com/jbaublitz/neli/issues/116 gets resolved!
+//! This examples provokes an error response from the kernel. The socket uses capped and
+//! extended ACKs, hence the error carries a message and the offset of the offending attribute
+//! instead of a full copy of the request. `neli` 0.6 can't decode such errors
+//! (https://github.com/jbaublitz/neli/issues/116), hence we receive and decode the error as raw
+//! bytes with `user_rust::ack`.
 
-use neli::err::NlError;
 use neli::{
     consts::{
         nl::{NlmF, NlmFFlags},
@@ -36,7 +38,9 @@ use neli::{
     socket::NlSocketHandle,
     types::{Buffer, GenlBuffer},
 };
+use std::os::unix::io::AsRawFd;
 use std::process;
+use user_rust::ack;
 use user_rust::{NlFoobarXmplAttribute, NlFoobarXmplCommand, FAMILY_NAME};
 
 fn main() {
@@ -50,6 +54,10 @@ fn main() {
     )
     .unwrap();
 
+    if let Err(e) = ack::enable(sock.as_raw_fd()) {
+        eprintln!("extended ACKs not supported: {}", e);
+    }
+
     let family_id;
     let res = sock.resolve_genl_family(FAMILY_NAME);
     match res {
@@ -88,27 +96,20 @@ fn main() {
 
     sock.send(nlmsghdr).expect("Send must work");
 
-    let res: Result<
-        Option<Nlmsghdr<u16, Genlmsghdr<NlFoobarXmplCommand, NlFoobarXmplAttribute>>>,
-        NlError<u16, Genlmsghdr<NlFoobarXmplCommand, NlFoobarXmplAttribute>>,
-    > = sock.recv();
-    let received_err = res.unwrap_err();
-    let received_err = match received_err {
-        NlError::Nlmsgerr(err) => err,
-        _ => panic!("We expected an error here!"),
-    };
+    let mut buf = vec![0_u8; 4096];
+    let len = ack::recv_raw(sock.as_raw_fd(), &mut buf).expect("Receive must work");
+    let received_err = ack::parse_nlmsgerr(&buf[..len]).expect("We expected an error here!");
+    assert_ne!(received_err.error, 0, "We expected an error, not an ACK");
     println!(
         "Inside the kernel this error code occurred: {}",
         received_err.error
     );
-    let attr_handle = received_err.nlmsg.nl_payload.get_attr_handle();
-    println!(
-        "ECHO-attribute was: {}",
-        attr_handle
-            .get_attr_payload_as_with_len::<String>(NlFoobarXmplAttribute::Msg)
-            .expect("This attribute was sent and must be in the response")
-    );
-    println!("NlMsg that caused the error: {:#?}", received_err.nlmsg);
+    if let Some(msg) = &received_err.msg {
+        println!("Error message from the kernel: {}", msg);
+    }
+    if let Some(offset) = received_err.offset {
+        println!("Offending attribute is at offset {} of the request", offset);
+    }
 
     println!("Everything okay; successfully received error")
 }
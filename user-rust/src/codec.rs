@@ -0,0 +1,966 @@
+// This file is generated from "spec/gnl_foobar_xmpl.yaml" by "tools/gnl-gen.py". Do not edit it.
+
+//! Specialized encoders and decoders for the messages of the "gnl_foobar_xmpl" family that work
+//! on plain byte buffers (e.g. for raw sockets). Independent of `neli`.
+//!
+//! Encoding: `<command>_init()` writes the Netlink and Generic Netlink header into a buffer,
+//! afterwards `put_<attribute>()` appends typed attributes. Strings and binary payloads longer
+//! than `MAX_ATTR_LEN` are rejected with `CodecError::TooLong` and leave the buffer unchanged.
+//! Decoding: `<command>_reply_parse()` decodes all attributes that the reply of the command can
+//! carry in one pass over the message; `<notification>_parse()` the same for notifications of
+//! the kernel.
+
+use std::convert::TryInto;
+use std::str;
+
+/// Length of `struct nlmsghdr`.
+pub const NLMSG_HDRLEN: usize = 16;
+/// Length of `struct genlmsghdr`.
+pub const GENL_HDRLEN: usize = 4;
+/// Length of `struct nlattr`.
+pub const NLA_HDRLEN: usize = 4;
+/// Netlink flag that marks requests; always set by the encoders.
+pub const NLM_F_REQUEST: u16 = 0x1;
+/// Max. payload of an attribute: the length including the header must fit into the u16 `nla_len`.
+pub const MAX_ATTR_LEN: usize = 0xffff - NLA_HDRLEN;
+/// Version that is put into the Generic Netlink header of requests.
+pub const VERSION: u8 = 1;
+
+/// Errors of the encoders and decoders.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CodecError {
+    /// The message is shorter than its headers claim.
+    Truncated,
+    /// The attribute with the given type has an invalid length or content.
+    InvalidAttribute(u16),
+    /// The payload of the attribute with the given type is longer than `MAX_ATTR_LEN`.
+    TooLong(u16),
+}
+
+/// Netlink alignment (4 bytes).
+#[inline]
+fn align(len: usize) -> usize {
+    (len + 3) & !3
+}
+
+fn init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32, cmd: u8) {
+    buf.clear();
+    buf.extend_from_slice(&((NLMSG_HDRLEN + GENL_HDRLEN) as u32).to_ne_bytes());
+    buf.extend_from_slice(&family_id.to_ne_bytes());
+    buf.extend_from_slice(&(NLM_F_REQUEST | flags).to_ne_bytes());
+    buf.extend_from_slice(&seq.to_ne_bytes());
+    // port id; assigned by the kernel
+    buf.extend_from_slice(&0_u32.to_ne_bytes());
+    buf.extend_from_slice(&[cmd, VERSION, 0, 0]);
+}
+
+fn put_attr(buf: &mut Vec<u8>, nla_type: u16, parts: &[&[u8]]) {
+    let len: usize = NLA_HDRLEN + parts.iter().map(|p| p.len()).sum::<usize>();
+    // checked by the callers
+    debug_assert!(len <= 0xffff);
+    buf.resize(align(buf.len()), 0);
+    buf.extend_from_slice(&(len as u16).to_ne_bytes());
+    buf.extend_from_slice(&nla_type.to_ne_bytes());
+    for p in parts {
+        buf.extend_from_slice(p);
+    }
+    buf.resize(align(buf.len()), 0);
+    let nlmsg_len = buf.len() as u32;
+    buf[0..4].copy_from_slice(&nlmsg_len.to_ne_bytes());
+}
+
+/// Returns the attribute stream of the Generic Netlink message `msg`.
+fn attr_stream(msg: &[u8]) -> Result<&[u8], CodecError> {
+    if msg.len() < NLMSG_HDRLEN + GENL_HDRLEN {
+        return Err(CodecError::Truncated);
+    }
+    let nlmsg_len = u32::from_ne_bytes(msg[0..4].try_into().unwrap()) as usize;
+    if nlmsg_len < NLMSG_HDRLEN + GENL_HDRLEN || nlmsg_len > msg.len() {
+        return Err(CodecError::Truncated);
+    }
+    Ok(&msg[NLMSG_HDRLEN + GENL_HDRLEN..nlmsg_len])
+}
+
+/// Returns the next attribute `(type, payload, rest)` of an attribute stream.
+fn next_attr(stream: &[u8]) -> Result<(u16, &[u8], &[u8]), CodecError> {
+    let len = u16::from_ne_bytes(stream[0..2].try_into().unwrap()) as usize;
+    let nla_type = u16::from_ne_bytes(stream[2..4].try_into().unwrap()) & 0x3fff;
+    if len < NLA_HDRLEN || len > stream.len() {
+        return Err(CodecError::Truncated);
+    }
+    let rest = &stream[align(len).min(stream.len())..];
+    Ok((nla_type, &stream[NLA_HDRLEN..len], rest))
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_ECHO_MSG` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn echo_msg_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 1);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_REPLY_WITH_NLMSG_ERR` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn reply_with_nlmsg_err_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 2);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_PING` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn ping_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 3);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_XFER_BEGIN` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn xfer_begin_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 4);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_XFER_CHUNK` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn xfer_chunk_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 5);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_XFER_COMMIT` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn xfer_commit_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 6);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_XFER_GET` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn xfer_get_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 7);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_XFER_ABORT` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn xfer_abort_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 8);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_RING_CREATE` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn ring_create_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 9);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_RING_DOORBELL` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn ring_doorbell_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 10);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_RING_STATS` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn ring_stats_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 11);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_RING_DESTROY` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn ring_destroy_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 12);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn event_subscribe_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 13);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn event_unsubscribe_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 14);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_EVENT_EMIT` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn event_emit_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 15);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_CHECKSUM` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn checksum_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 17);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_GET_CONFIG` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn get_config_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 18);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_SET_CONFIG` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn set_config_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 19);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_GET_GENERATION` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn get_generation_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 20);
+}
+
+/// Initializes a `GNL_FOOBAR_XMPL_C_PORT_STATS` request in `buf`. `NLM_F_REQUEST` is always set.
+pub fn port_stats_init(buf: &mut Vec<u8>, family_id: u16, flags: u16, seq: u32) {
+    init(buf, family_id, flags, seq, 22);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_MSG` to the message.
+pub fn put_msg(buf: &mut Vec<u8>, value: &str) -> Result<(), CodecError> {
+    if value.len() + 1 > MAX_ATTR_LEN {
+        return Err(CodecError::TooLong(1));
+    }
+    put_attr(buf, 1, &[value.as_bytes(), &[0]]);
+    Ok(())
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_DATA` to the message.
+pub fn put_data(buf: &mut Vec<u8>, value: &[u8]) -> Result<(), CodecError> {
+    if value.len() > MAX_ATTR_LEN {
+        return Err(CodecError::TooLong(2));
+    }
+    put_attr(buf, 2, &[value]);
+    Ok(())
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CLIENT_TS` to the message.
+pub fn put_client_ts(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 4, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_KERNEL_RX_TS` to the message.
+pub fn put_kernel_rx_ts(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 5, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_KERNEL_TX_TS` to the message.
+pub fn put_kernel_tx_ts(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 6, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_XFER_ID` to the message.
+pub fn put_xfer_id(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 7, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_XFER_SIZE` to the message.
+pub fn put_xfer_size(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 8, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_XFER_OFFSET` to the message.
+pub fn put_xfer_offset(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 9, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_XFER_WINDOW` to the message.
+pub fn put_xfer_window(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 10, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_ID` to the message.
+pub fn put_ring_id(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 11, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_ENTRIES` to the message.
+pub fn put_ring_entries(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 12, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE` to the message.
+pub fn put_ring_slot_size(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 13, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_MMAP_LEN` to the message.
+pub fn put_ring_mmap_len(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 14, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_COMPLETED` to the message.
+pub fn put_ring_completed(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 15, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_RECORDS` to the message.
+pub fn put_ring_records(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 16, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_BYTES` to the message.
+pub fn put_ring_bytes(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 17, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_RING_DOORBELLS` to the message.
+pub fn put_ring_doorbells(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 18, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_EVENT_TYPE` to the message.
+pub fn put_event_type(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 19, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_EVENT_KEY` to the message.
+pub fn put_event_key(buf: &mut Vec<u8>, value: &str) -> Result<(), CodecError> {
+    if value.len() + 1 > MAX_ATTR_LEN {
+        return Err(CodecError::TooLong(20));
+    }
+    put_attr(buf, 20, &[value.as_bytes(), &[0]]);
+    Ok(())
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK` to the message.
+pub fn put_event_type_mask(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 21, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX` to the message.
+pub fn put_event_key_prefix(buf: &mut Vec<u8>, value: &str) -> Result<(), CodecError> {
+    if value.len() + 1 > MAX_ATTR_LEN {
+        return Err(CodecError::TooLong(22));
+    }
+    put_attr(buf, 22, &[value.as_bytes(), &[0]]);
+    Ok(())
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_EVENT_DELIVERED` to the message.
+pub fn put_event_delivered(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 23, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_EVENT_FILTERED` to the message.
+pub fn put_event_filtered(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 24, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CHECKSUMS` to the message.
+pub fn put_checksums(buf: &mut Vec<u8>, value: &[u8]) -> Result<(), CodecError> {
+    if value.len() > MAX_ATTR_LEN {
+        return Err(CodecError::TooLong(25));
+    }
+    put_attr(buf, 25, &[value]);
+    Ok(())
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS` to the message.
+pub fn put_config_dump_runs(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 26, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE` to the message.
+pub fn put_config_verbose(buf: &mut Vec<u8>, value: u8) {
+    put_attr(buf, 27, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO` to the message.
+pub fn put_config_zerocopy_echo(buf: &mut Vec<u8>, value: u8) {
+    put_attr(buf, 28, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN` to the message.
+pub fn put_config_zerocopy_min_len(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 29, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW` to the message.
+pub fn put_config_xfer_window(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 30, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH` to the message.
+pub fn put_config_checksum_max_batch(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 31, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_GENERATION` to the message.
+pub fn put_generation(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 32, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT` to the message.
+pub fn put_config_dump_max_in_flight(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 33, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS` to the message.
+pub fn put_config_dump_max_records(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 34, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_PORT_ID` to the message.
+pub fn put_port_id(buf: &mut Vec<u8>, value: u32) {
+    put_attr(buf, 35, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_PORT_DUMPS` to the message.
+pub fn put_port_dumps(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 36, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED` to the message.
+pub fn put_port_dumps_rejected(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 37, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS` to the message.
+pub fn put_port_dump_runs(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 38, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED` to the message.
+pub fn put_port_dump_runs_deferred(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 39, &[&value.to_ne_bytes()]);
+}
+
+/// Appends `GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS` to the message.
+pub fn put_port_dump_records(buf: &mut Vec<u8>, value: u64) {
+    put_attr(buf, 40, &[&value.to_ne_bytes()]);
+}
+
+/// Decoded attributes of `enum GNL_FOOBAR_XMPL_ATTRIBUTE`. Slices point into the received message.
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct Attrs<'a> {
+    /// `GNL_FOOBAR_XMPL_A_MSG`
+    pub msg: Option<&'a str>,
+    /// `GNL_FOOBAR_XMPL_A_DATA`
+    pub data: Option<&'a [u8]>,
+    /// `GNL_FOOBAR_XMPL_A_CLIENT_TS`
+    pub client_ts: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_KERNEL_RX_TS`
+    pub kernel_rx_ts: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_KERNEL_TX_TS`
+    pub kernel_tx_ts: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_XFER_ID`
+    pub xfer_id: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_XFER_SIZE`
+    pub xfer_size: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_XFER_OFFSET`
+    pub xfer_offset: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_XFER_WINDOW`
+    pub xfer_window: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_RING_ID`
+    pub ring_id: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_RING_ENTRIES`
+    pub ring_entries: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE`
+    pub ring_slot_size: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_RING_MMAP_LEN`
+    pub ring_mmap_len: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_RING_COMPLETED`
+    pub ring_completed: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_RING_RECORDS`
+    pub ring_records: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_RING_BYTES`
+    pub ring_bytes: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_RING_DOORBELLS`
+    pub ring_doorbells: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_EVENT_TYPE`
+    pub event_type: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_EVENT_KEY`
+    pub event_key: Option<&'a str>,
+    /// `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK`
+    pub event_type_mask: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX`
+    pub event_key_prefix: Option<&'a str>,
+    /// `GNL_FOOBAR_XMPL_A_EVENT_DELIVERED`
+    pub event_delivered: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_EVENT_FILTERED`
+    pub event_filtered: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_CHECKSUMS`
+    pub checksums: Option<&'a [u8]>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_RUNS`
+    pub config_dump_runs: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_VERBOSE`
+    pub config_verbose: Option<u8>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_ECHO`
+    pub config_zerocopy_echo: Option<u8>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_ZEROCOPY_MIN_LEN`
+    pub config_zerocopy_min_len: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_XFER_WINDOW`
+    pub config_xfer_window: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_CHECKSUM_MAX_BATCH`
+    pub config_checksum_max_batch: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_GENERATION`
+    pub generation: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT`
+    pub config_dump_max_in_flight: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS`
+    pub config_dump_max_records: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_PORT_ID`
+    pub port_id: Option<u32>,
+    /// `GNL_FOOBAR_XMPL_A_PORT_DUMPS`
+    pub port_dumps: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_PORT_DUMPS_REJECTED`
+    pub port_dumps_rejected: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS`
+    pub port_dump_runs: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_PORT_DUMP_RUNS_DEFERRED`
+    pub port_dump_runs_deferred: Option<u64>,
+    /// `GNL_FOOBAR_XMPL_A_PORT_DUMP_RECORDS`
+    pub port_dump_records: Option<u64>,
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_ECHO_MSG` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn echo_msg_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            1 => {
+                let s = match data.split_last() {
+                    Some((0, s)) => s,
+                    _ => return Err(CodecError::InvalidAttribute(1)),
+                };
+                attrs.msg = Some(str::from_utf8(s).map_err(|_| CodecError::InvalidAttribute(1))?);
+            }
+            2 => {
+                attrs.data = Some(data);
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_PING` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn ping_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            4 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(4))?;
+                attrs.client_ts = Some(u64::from_ne_bytes(bytes));
+            }
+            5 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(5))?;
+                attrs.kernel_rx_ts = Some(u64::from_ne_bytes(bytes));
+            }
+            6 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(6))?;
+                attrs.kernel_tx_ts = Some(u64::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_XFER_BEGIN` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn xfer_begin_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            7 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(7))?;
+                attrs.xfer_id = Some(u32::from_ne_bytes(bytes));
+            }
+            10 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(10))?;
+                attrs.xfer_window = Some(u32::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_XFER_GET` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn xfer_get_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            2 => {
+                attrs.data = Some(data);
+            }
+            7 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(7))?;
+                attrs.xfer_id = Some(u32::from_ne_bytes(bytes));
+            }
+            9 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(9))?;
+                attrs.xfer_offset = Some(u64::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_RING_CREATE` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn ring_create_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            11 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(11))?;
+                attrs.ring_id = Some(u32::from_ne_bytes(bytes));
+            }
+            12 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(12))?;
+                attrs.ring_entries = Some(u32::from_ne_bytes(bytes));
+            }
+            13 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(13))?;
+                attrs.ring_slot_size = Some(u32::from_ne_bytes(bytes));
+            }
+            14 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(14))?;
+                attrs.ring_mmap_len = Some(u64::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_RING_DOORBELL` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn ring_doorbell_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            11 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(11))?;
+                attrs.ring_id = Some(u32::from_ne_bytes(bytes));
+            }
+            15 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(15))?;
+                attrs.ring_completed = Some(u32::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_RING_STATS` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn ring_stats_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            11 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(11))?;
+                attrs.ring_id = Some(u32::from_ne_bytes(bytes));
+            }
+            16 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(16))?;
+                attrs.ring_records = Some(u64::from_ne_bytes(bytes));
+            }
+            17 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(17))?;
+                attrs.ring_bytes = Some(u64::from_ne_bytes(bytes));
+            }
+            18 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(18))?;
+                attrs.ring_doorbells = Some(u64::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_EVENT_EMIT` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn event_emit_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            23 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(23))?;
+                attrs.event_delivered = Some(u32::from_ne_bytes(bytes));
+            }
+            24 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(24))?;
+                attrs.event_filtered = Some(u32::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the notification of `GNL_FOOBAR_XMPL_C_EVENT` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the notification of this command never carries are skipped.
+pub fn event_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            2 => {
+                attrs.data = Some(data);
+            }
+            19 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(19))?;
+                attrs.event_type = Some(u32::from_ne_bytes(bytes));
+            }
+            20 => {
+                let s = match data.split_last() {
+                    Some((0, s)) => s,
+                    _ => return Err(CodecError::InvalidAttribute(20)),
+                };
+                attrs.event_key = Some(str::from_utf8(s).map_err(|_| CodecError::InvalidAttribute(20))?);
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_CHECKSUM` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn checksum_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            25 => {
+                attrs.checksums = Some(data);
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_GET_CONFIG` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn get_config_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            26 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(26))?;
+                attrs.config_dump_runs = Some(u32::from_ne_bytes(bytes));
+            }
+            27 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(27))?;
+                attrs.config_verbose = Some(u8::from_ne_bytes(bytes));
+            }
+            28 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(28))?;
+                attrs.config_zerocopy_echo = Some(u8::from_ne_bytes(bytes));
+            }
+            29 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(29))?;
+                attrs.config_zerocopy_min_len = Some(u32::from_ne_bytes(bytes));
+            }
+            30 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(30))?;
+                attrs.config_xfer_window = Some(u32::from_ne_bytes(bytes));
+            }
+            31 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(31))?;
+                attrs.config_checksum_max_batch = Some(u32::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            33 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(33))?;
+                attrs.config_dump_max_in_flight = Some(u32::from_ne_bytes(bytes));
+            }
+            34 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(34))?;
+                attrs.config_dump_max_records = Some(u32::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_SET_CONFIG` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn set_config_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            26 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(26))?;
+                attrs.config_dump_runs = Some(u32::from_ne_bytes(bytes));
+            }
+            27 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(27))?;
+                attrs.config_verbose = Some(u8::from_ne_bytes(bytes));
+            }
+            28 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(28))?;
+                attrs.config_zerocopy_echo = Some(u8::from_ne_bytes(bytes));
+            }
+            29 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(29))?;
+                attrs.config_zerocopy_min_len = Some(u32::from_ne_bytes(bytes));
+            }
+            30 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(30))?;
+                attrs.config_xfer_window = Some(u32::from_ne_bytes(bytes));
+            }
+            31 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(31))?;
+                attrs.config_checksum_max_batch = Some(u32::from_ne_bytes(bytes));
+            }
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            33 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(33))?;
+                attrs.config_dump_max_in_flight = Some(u32::from_ne_bytes(bytes));
+            }
+            34 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(34))?;
+                attrs.config_dump_max_records = Some(u32::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_GET_GENERATION` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn get_generation_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the notification of `GNL_FOOBAR_XMPL_C_INVALIDATE` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the notification of this command never carries are skipped.
+pub fn invalidate_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
+
+/// Parses the reply of `GNL_FOOBAR_XMPL_C_PORT_STATS` (`msg` must not be a NLMSG_ERROR message).
+/// Attributes that the reply of this command never carries are skipped.
+pub fn port_stats_reply_parse(msg: &[u8]) -> Result<Attrs<'_>, CodecError> {
+    let mut attrs = Attrs::default();
+    let mut stream = attr_stream(msg)?;
+    while stream.len() >= NLA_HDRLEN {
+        let (nla_type, data, rest) = next_attr(stream)?;
+        match nla_type {
+            32 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(32))?;
+                attrs.generation = Some(u64::from_ne_bytes(bytes));
+            }
+            35 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(35))?;
+                attrs.port_id = Some(u32::from_ne_bytes(bytes));
+            }
+            36 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(36))?;
+                attrs.port_dumps = Some(u64::from_ne_bytes(bytes));
+            }
+            37 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(37))?;
+                attrs.port_dumps_rejected = Some(u64::from_ne_bytes(bytes));
+            }
+            38 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(38))?;
+                attrs.port_dump_runs = Some(u64::from_ne_bytes(bytes));
+            }
+            39 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(39))?;
+                attrs.port_dump_runs_deferred = Some(u64::from_ne_bytes(bytes));
+            }
+            40 => {
+                let bytes = data.try_into().map_err(|_| CodecError::InvalidAttribute(40))?;
+                attrs.port_dump_records = Some(u64::from_ne_bytes(bytes));
+            }
+            _ => {}
+        }
+        stream = rest;
+    }
+    Ok(attrs)
+}
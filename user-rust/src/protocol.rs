@@ -0,0 +1,224 @@
+// This file is generated from "spec/gnl_foobar_xmpl.yaml" by "tools/gnl-gen.py". Do not edit it.
+
+use neli::neli_enum;
+
+// Variants are documented with regular comments because `neli_enum` generates the enum itself.
+
+/// Name of the Netlink family registered via Generic Netlink
+pub const FAMILY_NAME: &str = "gnl_foobar_xmpl";
+
+/// This is for the "cmd" field in Generic Netlink header.
+/// NlFoobarXmplCommand corresponds to "enum GNL_FOOBAR_XMPL_COMMAND" in "gnl_foobar_xmpl_prop.h".
+/// Describes what callback function shall be invoked in the linux kernel module.
+#[neli_enum(serialized_type = "u8")]
+pub enum NlFoobarXmplCommand {
+    Unspec = 0,
+    // When this command is received, we expect the attribute `GNL_FOOBAR_XMPL_ATTRIBUTE::GNL_FOOBAR_XMPL_A_MSG` to
+    // be present in the Generic Netlink request message. The kernel reads the message from the packet and
+    // creates a new Generic Netlink response message with an corresponding attribute/payload.
+    //
+    // This command/signaling mechanism is independent of the Netlink flag `NLM_F_ECHO (0x08)`. We use it as
+    // "echo specific data" instead of return a 1:1 copy of the package, which you could do with
+    // `NLM_F_ECHO (0x08)` for example.
+    //
+    // Instead of `GNL_FOOBAR_XMPL_A_MSG` the request may carry `GNL_FOOBAR_XMPL_A_DATA`. In this case
+    // the reply contains the same binary payload as `GNL_FOOBAR_XMPL_A_DATA` attribute.
+    EchoMsg = 1,
+    // Provokes a NLMSG_ERR answer to this request as described in netlink manpage
+    // (https://man7.org/linux/man-pages/man7/netlink.7.html).
+    ReplyWithNlmsgErr = 2,
+    // Latency probe. The request carries `GNL_FOOBAR_XMPL_A_CLIENT_TS`. The reply carries it unchanged plus the
+    // kernel timestamps `GNL_FOOBAR_XMPL_A_KERNEL_RX_TS` and `GNL_FOOBAR_XMPL_A_KERNEL_TX_TS`. Together with the
+    // receive timestamp of the client this splits the round trip into request leg (client -> handler), service
+    // time (inside the handler) and reply leg (handler -> client).
+    Ping = 3,
+    // Starts the upload of an object of `GNL_FOOBAR_XMPL_A_XFER_SIZE` bytes, which can be much larger than a
+    // Netlink message. The kernel reserves a buffer for the whole object (bounded by the module parameter
+    // `xfer_max_bytes` for all network namespaces together) and replies with the id of the transfer and the
+    // window for the chunks. Afterwards the client sends the object with `GNL_FOOBAR_XMPL_C_XFER_CHUNK` and
+    // finishes it with `GNL_FOOBAR_XMPL_C_XFER_COMMIT`. Requires CAP_NET_ADMIN in the user namespace of the
+    // network namespace. The object belongs to the sending socket: only it can send chunks, commit or abort
+    // the object, and the object is deleted when the socket is closed.
+    XferBegin = 4,
+    // One chunk (`GNL_FOOBAR_XMPL_A_DATA`) of an upload at `GNL_FOOBAR_XMPL_A_XFER_OFFSET`. Chunks must be sent
+    // in order, i.e. the offset must be the number of bytes received so far; after an error the client can
+    // resume from there. No reply; send it with `NLM_F_ACK` to get an ACK per chunk.
+    XferChunk = 5,
+    // Finishes the upload `GNL_FOOBAR_XMPL_A_XFER_ID`. Fails if not all bytes were received. Afterwards the object
+    // is read-only and can be downloaded with `GNL_FOOBAR_XMPL_C_XFER_GET`.
+    XferCommit = 6,
+    // Downloads the committed object `GNL_FOOBAR_XMPL_A_XFER_ID` as a dump (`NLM_F_DUMP`), starting at the optional
+    // `GNL_FOOBAR_XMPL_A_XFER_OFFSET`. Each record carries a chunk as `GNL_FOOBAR_XMPL_A_DATA` with its offset;
+    // the kernel makes the chunks as large as the dump buffers allow.
+    XferGet = 7,
+    // Deletes the object `GNL_FOOBAR_XMPL_A_XFER_ID`, committed or not, and releases its buffer. Running downloads
+    // of it complete. Only the socket that started the upload can delete the object.
+    XferAbort = 8,
+    // Creates a shared memory ring with a submission and a completion queue of `GNL_FOOBAR_XMPL_A_RING_ENTRIES`
+    // slots of `GNL_FOOBAR_XMPL_A_RING_SLOT_SIZE` bytes each (see "gnl_foobar_xmpl_ring.h" for the layout). The
+    // reply carries the id and the length of the mapping. Each submitted record is echoed into the completion
+    // queue, i.e. the ring is a data plane for `GNL_FOOBAR_XMPL_C_ECHO_MSG` without a copy into and out of skbs.
+    // The ring belongs to the sending socket: only it may use the other ring commands on it, only its user may map
+    // it, and it is destroyed when the socket is closed.
+    RingCreate = 9,
+    // Tells the kernel that new records are in the submission queue of ring `GNL_FOOBAR_XMPL_A_RING_ID`. The kernel
+    // processes all of them (as long as the completion queue has room) before it replies with the number of
+    // posted completions.
+    RingDoorbell = 10,
+    // Statistics of ring `GNL_FOOBAR_XMPL_A_RING_ID`.
+    RingStats = 11,
+    // Deletes ring `GNL_FOOBAR_XMPL_A_RING_ID`. Its memory is released when the last mapping of it is gone.
+    RingDestroy = 12,
+    // Subscribes the sending socket to events that match the filter `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK` and
+    // `GNL_FOOBAR_XMPL_A_EVENT_KEY_PREFIX` (both must match). The kernel sends matching events as unicast
+    // `GNL_FOOBAR_XMPL_C_EVENT` notifications to the socket; all others never reach it. Subscribing again
+    // replaces the filter. The subscription ends with `GNL_FOOBAR_XMPL_C_EVENT_UNSUBSCRIBE` or when the socket
+    // is closed.
+    EventSubscribe = 13,
+    // Ends the subscription of the sending socket.
+    EventUnsubscribe = 14,
+    // Publishes an event of `GNL_FOOBAR_XMPL_A_EVENT_TYPE` with `GNL_FOOBAR_XMPL_A_EVENT_KEY` and an optional payload
+    // `GNL_FOOBAR_XMPL_A_DATA`: to all members of the multicast group "events" and to all subscribers whose
+    // filter matches. The reply tells how many received it and how many were filtered out.
+    EventEmit = 15,
+    // Notification of an event published with `GNL_FOOBAR_XMPL_C_EVENT_EMIT`. Sent by the kernel only: to the
+    // multicast group "events" and to matching subscribers (see `GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE`).
+    Event = 16,
+    // Computes the CRC32C of each `GNL_FOOBAR_XMPL_A_DATA` attribute of the request (one or many, i.e. a batch)
+    // with the fastest implementation of the kernel (e.g. the CRC32 instruction of SSE 4.2) and replies with
+    // all of them in `GNL_FOOBAR_XMPL_A_CHECKSUMS`. Transfer and verification of data in one round trip. At most
+    // 16382 payloads per request, i.e. as many checksums as one attribute can hold.
+    Checksum = 17,
+    // Replies with the current values of all runtime tunables (`GNL_FOOBAR_XMPL_A_CONFIG_*`).
+    GetConfig = 18,
+    // Changes the runtime tunables that are present in the request; the others keep their values. All changes
+    // take effect at once for the next request of every client (already running dumps and transfers keep
+    // the values they started with). Replies with the new values of all tunables. Requires CAP_NET_ADMIN.
+    SetConfig = 19,
+    // Replies with nothing but `GNL_FOOBAR_XMPL_A_GENERATION`. The cheapest round trip to validate cached
+    // replies of read-only commands.
+    GetGeneration = 20,
+    // Notification to the group "invalidate" whenever `GNL_FOOBAR_XMPL_A_GENERATION` changes; carries the new
+    // generation. Clients that listen don't need to query the generation before they use a cached reply.
+    Invalidate = 21,
+    // Dumps the accounting of every socket (port id) of the network namespace that started a dump: started and
+    // rejected dumps, their runs and records and how many runs were cut short by the records quota. The numbers
+    // show which client takes how much kernel time and whether the quotas (`GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_*`)
+    // throttle it. The accounting of a socket ends when it is closed. This dump itself is not accounted and
+    // never rejected. Counters aren't state, hence `GNL_FOOBAR_XMPL_A_GENERATION` doesn't change with them.
+    PortStats = 22,
+}
+impl neli::consts::genl::Cmd for NlFoobarXmplCommand {}
+
+/// Describes the value type to data mappings inside the generic netlink packet payload.
+/// NlFoobarXmplAttribute corresponds to "enum GNL_FOOBAR_XMPL_ATTRIBUTE" in "gnl_foobar_xmpl_prop.h".
+#[neli_enum(serialized_type = "u16")]
+pub enum NlFoobarXmplAttribute {
+    Unspec = 0,
+    // We expect a MSG to be a null-terminated C-string.
+    Msg = 1,
+    // Arbitrary binary payload (no null-termination required) that is echoed back by
+    // `GNL_FOOBAR_XMPL_C_ECHO_MSG`. Unlike `GNL_FOOBAR_XMPL_A_MSG` this is meant for large payloads:
+    // the kernel avoids copying it a second time into the reply if possible.
+    Data = 2,
+    // Padding for 64 bit attributes (`nla_put_u64_64bit()`). Ignore it.
+    Pad = 3,
+    // Send timestamp of a `GNL_FOOBAR_XMPL_C_PING` request in nanoseconds, taken by the client right
+    // before sending from `CLOCK_MONOTONIC`. Echoed back unchanged.
+    ClientTs = 4,
+    // `ktime_get_ns()` at the entry of the `GNL_FOOBAR_XMPL_C_PING` handler. Same clock as
+    // `CLOCK_MONOTONIC` in the userland, hence it can be compared with `GNL_FOOBAR_XMPL_A_CLIENT_TS`.
+    KernelRxTs = 5,
+    // `ktime_get_ns()` in the `GNL_FOOBAR_XMPL_C_PING` handler right before the reply is sent.
+    KernelTxTs = 6,
+    // Id of a chunked transfer (object), assigned by `GNL_FOOBAR_XMPL_C_XFER_BEGIN`.
+    XferId = 7,
+    // Total size of the object of a chunked transfer in bytes.
+    XferSize = 8,
+    // Offset of the chunk (`GNL_FOOBAR_XMPL_A_DATA`) within the object of a chunked transfer. In a
+    // `GNL_FOOBAR_XMPL_C_XFER_GET` request: where the download starts.
+    XferOffset = 9,
+    // Number of unacknowledged chunks that a client should have in flight at most during an upload,
+    // i.e. chunks sent with `NLM_F_ACK` whose ACK hasn't been received yet.
+    XferWindow = 10,
+    // Id of a shared memory ring, assigned by `GNL_FOOBAR_XMPL_C_RING_CREATE`. The ring is mapped with mmap()
+    // on the misc device "/dev/gnl_foobar_xmpl_ring" at the offset `ring-id * page size`.
+    RingId = 11,
+    // Number of slots of the submission and of the completion queue of a ring (power of two).
+    RingEntries = 12,
+    // Size of each slot of a ring in bytes, incl. `struct gnl_foobar_xmpl_ring_rec` (multiple of 64).
+    RingSlotSize = 13,
+    // Length of the mapping of a ring in bytes.
+    RingMmapLen = 14,
+    // Number of completions that the kernel posted while it handled a doorbell.
+    RingCompleted = 15,
+    // Number of records that the kernel processed on a ring since it was created.
+    RingRecords = 16,
+    // Number of payload bytes that the kernel processed on a ring since it was created.
+    RingBytes = 17,
+    // Number of doorbells of a ring since it was created.
+    RingDoorbells = 18,
+    // Type of an event (0..63); subscribers select types with `GNL_FOOBAR_XMPL_A_EVENT_TYPE_MASK`.
+    EventType = 19,
+    // Key of an event, e.g. the name of the object it is about.
+    EventKey = 20,
+    // Filter of a subscriber: bit `1 << type` selects events of that type. Missing or 0 selects all types.
+    EventTypeMask = 21,
+    // Filter of a subscriber; selects events whose key starts with this prefix. Missing or empty selects all keys.
+    EventKeyPrefix = 22,
+    // Number of subscribers (plus 1 for the multicast group if it has members) an event was sent to.
+    EventDelivered = 23,
+    // Number of subscribers whose filter didn't select an event, i.e. that were spared a copy and a wakeup.
+    EventFiltered = 24,
+    // CRC32C (Castagnoli; as in iSCSI, ext4 and SCTP) of each `GNL_FOOBAR_XMPL_A_DATA` of a
+    // `GNL_FOOBAR_XMPL_C_CHECKSUM` request, in request order, as array of native endian `__u32`.
+    Checksums = 25,
+    // Tunable; number of records of an echo dump (`GNL_FOOBAR_XMPL_C_ECHO_MSG` with `NLM_F_DUMP`). Millions of
+    // records make dumps long enough for throughput measurements; "dump-max-records" keeps them from starving
+    // other clients.
+    ConfigDumpRuns = 26,
+    // Tunable; if 1, the echo and dump handlers log every request to the kernel log.
+    ConfigVerbose = 27,
+    // Tunable; if 1, large `GNL_FOOBAR_XMPL_A_DATA` payloads are echoed without copying them into the reply.
+    ConfigZerocopyEcho = 28,
+    // Tunable; echo payloads smaller than this are always copied into the reply.
+    ConfigZerocopyMinLen = 29,
+    // Tunable; the window that `GNL_FOOBAR_XMPL_C_XFER_BEGIN` advertises, see `GNL_FOOBAR_XMPL_A_XFER_WINDOW`.
+    ConfigXferWindow = 30,
+    // Tunable; max. number of payloads of one `GNL_FOOBAR_XMPL_C_CHECKSUM` request (0: unlimited).
+    // Bounds the time a single request spends in the kernel.
+    ConfigChecksumMaxBatch = 31,
+    // Generation of the state of the network namespace, part of every reply. It changes whenever the result
+    // of a read-only command (e.g. `GNL_FOOBAR_XMPL_C_GET_CONFIG`, `GNL_FOOBAR_XMPL_C_RING_STATS`,
+    // `GNL_FOOBAR_XMPL_C_XFER_GET` or the echo dump) may change, hence a client can reuse a reply for as
+    // long as the generation stays the same. Only equality is meaningful; it starts at a random value.
+    Generation = 32,
+    // Tunable; max. number of dumps of one user (the sender of the requests) that run at the same time in all
+    // network namespaces together (0: unlimited). Further dumps of the user fail with EBUSY right away, before they
+    // do any work; other users aren't affected.
+    ConfigDumpMaxInFlight = 33,
+    // Tunable; max. number of records per run of a dump, i.e. per receive of the client (0: as many as fit
+    // into the dump buffer). The rest of the dump is deferred to the next run; in between the kernel serves
+    // the requests of other clients.
+    ConfigDumpMaxRecords = 34,
+    // Port id of a socket, see `GNL_FOOBAR_XMPL_C_PORT_STATS`.
+    PortId = 35,
+    // Number of dumps a socket started.
+    PortDumps = 36,
+    // Number of dumps of a socket that were rejected because of `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_IN_FLIGHT`.
+    PortDumpsRejected = 37,
+    // Number of runs of the dumps of a socket, i.e. of dump buffers that the kernel filled for it.
+    PortDumpRuns = 38,
+    // Number of runs of the dumps of a socket that ended early because of `GNL_FOOBAR_XMPL_A_CONFIG_DUMP_MAX_RECORDS`.
+    PortDumpRunsDeferred = 39,
+    // Number of records of the dumps of a socket.
+    PortDumpRecords = 40,
+}
+impl neli::consts::genl::NlAttrType for NlFoobarXmplAttribute {}
+
+/// Every `GNL_FOOBAR_XMPL_C_EVENT` notification, unfiltered. Listeners that only want some events should
+/// subscribe with a filter instead (`GNL_FOOBAR_XMPL_C_EVENT_SUBSCRIBE`).
+pub const MCGRP_EVENTS: &str = "events";
+
+/// `GNL_FOOBAR_XMPL_C_INVALIDATE` notifications, i.e. every change of the generation of the network namespace.
+pub const MCGRP_INVALIDATE: &str = "invalidate";